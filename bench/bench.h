@@ -0,0 +1,21 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BENCH_H__
+#define BENCH_H__
+
+#include <time.h>
+
+/** Returns a monotonic timestamp in seconds
+ */
+static inline double bench_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#endif // BENCH_H__
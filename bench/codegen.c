@@ -0,0 +1,139 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <paraconf.h>
+
+#include "bench.h"
+#include "bench_config.h"
+
+/* Compares the reader generated from codegen_schema.yml with the equivalent
+ * hand-written PC_get chains and with PC_extract.
+ *
+ * usage: bench_codegen [nb_reads]
+ */
+
+#define NB_RUNS 5
+
+static const char* CONFIG = "mesh: {nx: 128, ny: 128, nz: 64, lx: 1.0, ly: 1.0, lz: 0.5}\n"
+                            "solver: {name: bicgstab, dt: 1.0e-3, tolerance: 1.0e-8, max_iter: 500, preconditioned: yes}\n"
+                            "physics: {gravity: 9.81, viscosity: 1.0e-6, density: 1000.0, temperature: 293.15}\n"
+                            "output: {file: result.h5, period: 10, compress: true, level: 6}\n";
+
+static void read_get(PC_tree_t conf, bench_config_t* config)
+{
+	PC_int(PC_get(conf, ".mesh.nx"), &config->mesh.nx);
+	PC_int(PC_get(conf, ".mesh.ny"), &config->mesh.ny);
+	PC_int(PC_get(conf, ".mesh.nz"), &config->mesh.nz);
+	PC_double(PC_get(conf, ".mesh.lx"), &config->mesh.lx);
+	PC_double(PC_get(conf, ".mesh.ly"), &config->mesh.ly);
+	PC_double(PC_get(conf, ".mesh.lz"), &config->mesh.lz);
+	PC_string(PC_get(conf, ".solver.name"), &config->solver.name);
+	PC_double(PC_get(conf, ".solver.dt"), &config->solver.dt);
+	PC_double(PC_get(conf, ".solver.tolerance"), &config->solver.tolerance);
+	PC_int(PC_get(conf, ".solver.max_iter"), &config->solver.max_iter);
+	PC_bool(PC_get(conf, ".solver.preconditioned"), &config->solver.preconditioned);
+	PC_double(PC_get(conf, ".physics.gravity"), &config->physics.gravity);
+	PC_double(PC_get(conf, ".physics.viscosity"), &config->physics.viscosity);
+	PC_double(PC_get(conf, ".physics.density"), &config->physics.density);
+	PC_double(PC_get(conf, ".physics.temperature"), &config->physics.temperature);
+	PC_string(PC_get(conf, ".output.file"), &config->output.file);
+	PC_int(PC_get(conf, ".output.period"), &config->output.period);
+	PC_bool(PC_get(conf, ".output.compress"), &config->output.compress);
+	PC_int(PC_get(conf, ".output.level"), &config->output.level);
+}
+
+#define FIELD(PATH, TYPE, MEMBER) {PATH, TYPE, offsetof(bench_config_t, MEMBER), 0, NULL}
+
+static const PC_field_t FIELDS[] = {
+	FIELD(".mesh.nx", PC_FIELD_LONG, mesh.nx),
+	FIELD(".mesh.ny", PC_FIELD_LONG, mesh.ny),
+	FIELD(".mesh.nz", PC_FIELD_LONG, mesh.nz),
+	FIELD(".mesh.lx", PC_FIELD_DOUBLE, mesh.lx),
+	FIELD(".mesh.ly", PC_FIELD_DOUBLE, mesh.ly),
+	FIELD(".mesh.lz", PC_FIELD_DOUBLE, mesh.lz),
+	FIELD(".solver.name", PC_FIELD_STRING, solver.name),
+	FIELD(".solver.dt", PC_FIELD_DOUBLE, solver.dt),
+	FIELD(".solver.tolerance", PC_FIELD_DOUBLE, solver.tolerance),
+	FIELD(".solver.max_iter", PC_FIELD_LONG, solver.max_iter),
+	FIELD(".solver.preconditioned", PC_FIELD_BOOL, solver.preconditioned),
+	FIELD(".physics.gravity", PC_FIELD_DOUBLE, physics.gravity),
+	FIELD(".physics.viscosity", PC_FIELD_DOUBLE, physics.viscosity),
+	FIELD(".physics.density", PC_FIELD_DOUBLE, physics.density),
+	FIELD(".physics.temperature", PC_FIELD_DOUBLE, physics.temperature),
+	FIELD(".output.file", PC_FIELD_STRING, output.file),
+	FIELD(".output.period", PC_FIELD_LONG, output.period),
+	FIELD(".output.compress", PC_FIELD_BOOL, output.compress),
+	FIELD(".output.level", PC_FIELD_LONG, output.level),
+};
+
+static void read_extract(PC_tree_t conf, bench_config_t* config)
+{
+	PC_extract(conf, FIELDS, sizeof(FIELDS) / sizeof(FIELDS[0]), config);
+}
+
+static void read_generated(PC_tree_t conf, bench_config_t* config)
+{
+	bench_config_read(conf, config);
+}
+
+/** Returns the best time of NB_RUNS runs of nb_reads reads of the whole configuration
+ */
+static double best_of(void (*read)(PC_tree_t, bench_config_t*), PC_tree_t conf, int nb_reads)
+{
+	double best = 1e30;
+	long sum = 0;
+	for (int run = 0; run < NB_RUNS; ++run) {
+		double start = bench_now();
+		for (int ii = 0; ii < nb_reads; ++ii) {
+			bench_config_t config = {0};
+			read(conf, &config);
+			sum += config.mesh.nx + config.output.level;
+			bench_config_free(&config);
+		}
+		double elapsed = bench_now() - start;
+		if (elapsed < best) best = elapsed;
+	}
+	if (sum == 42) printf(" ");
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	int nb_reads = argc > 1 ? atoi(argv[1]) : 100000;
+	PC_tree_t conf = PC_parse_string(CONFIG);
+
+	struct {
+		const char* name;
+		void (*read)(PC_tree_t, bench_config_t*);
+	} readers[] = {
+		{"PC_get", read_get},
+		{"PC_extract", read_extract},
+		{"generated", read_generated},
+	};
+	int nb_fields = sizeof(FIELDS) / sizeof(FIELDS[0]);
+	double reference = 0;
+	printf("%12s %12s %12s %8s\n", "reader", "us/read", "ns/field", "speedup");
+	for (size_t reader = 0; reader < sizeof(readers) / sizeof(readers[0]); ++reader) {
+		double elapsed = best_of(readers[reader].read, conf, nb_reads);
+		if (!reader) reference = elapsed;
+		printf(
+			"%12s %12.2f %12.1f %8.2f\n",
+			readers[reader].name,
+			elapsed * 1e6 / nb_reads,
+			elapsed * 1e9 / nb_reads / nb_fields,
+			reference / elapsed
+		);
+	}
+
+	PC_tree_destroy(&conf);
+	return 0;
+}
@@ -0,0 +1,118 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "corpus.h"
+
+static const char* SHAPE_NAMES[CORPUS_NB_SHAPES] = {"deep", "wide", "long_sequence", "large_scalar"};
+
+/** A growable output buffer
+ */
+typedef struct buffer_s {
+	char* data;
+	size_t len;
+	size_t size;
+} buffer_t;
+
+/** Appends formatted content to a buffer, the buffer data is set to NULL on allocation error
+ */
+static void buffer_printf(buffer_t* buffer, const char* format, ...)
+{
+	if (!buffer->data) return;
+	for (;;) {
+		va_list ap;
+		va_start(ap, format);
+		int written = vsnprintf(buffer->data + buffer->len, buffer->size - buffer->len, format, ap);
+		va_end(ap);
+		if (written < 0) {
+			free(buffer->data);
+			buffer->data = NULL;
+			return;
+		}
+		if (buffer->len + written < buffer->size) {
+			buffer->len += written;
+			return;
+		}
+		size_t size = 2 * buffer->size > buffer->len + written + 1 ? 2 * buffer->size : buffer->len + written + 1;
+		char* data = realloc(buffer->data, size);
+		if (!data) {
+			free(buffer->data);
+			buffer->data = NULL;
+			return;
+		}
+		buffer->data = data;
+		buffer->size = size;
+	}
+}
+
+const char* corpus_shape_name(corpus_shape_t shape)
+{
+	return shape < CORPUS_NB_SHAPES ? SHAPE_NAMES[shape] : "unknown";
+}
+
+corpus_shape_t corpus_shape_find(const char* name)
+{
+	for (int shape = 0; shape < CORPUS_NB_SHAPES; ++shape) {
+		if (!strcmp(name, SHAPE_NAMES[shape])) return shape;
+	}
+	return CORPUS_NB_SHAPES;
+}
+
+char* corpus_generate(corpus_shape_t shape, long size, size_t* len)
+{
+	buffer_t buffer = {malloc(4096), 0, 4096};
+	if (!buffer.data) return NULL;
+	buffer.data[0] = '\0';
+
+	switch (shape) {
+	case CORPUS_DEEP:
+		for (long level = 0; level < size; ++level) {
+			for (int sibling = 0; sibling < 4; ++sibling) {
+				buffer_printf(&buffer, "%*ss%d: %ld\n", (int)(2 * level), "", sibling, level);
+			}
+			buffer_printf(&buffer, "%*sl%ld:%s", (int)(2 * level), "", level, level == size - 1 ? " 42\n" : "\n");
+		}
+		break;
+	case CORPUS_WIDE:
+		for (long key = 0; key < size; ++key) {
+			buffer_printf(&buffer, "k%ld: %ld\n", key, key);
+		}
+		break;
+	case CORPUS_LONG_SEQUENCE:
+		for (long item = 0; item < size; ++item) {
+			buffer_printf(&buffer, "- [%ld, %.1f, true, \"name_%ld\"]\n", item, item * 0.5, item);
+		}
+		break;
+	case CORPUS_LARGE_SCALAR: {
+		buffer_printf(&buffer, "text: |\n");
+		// lines of 64 characters including the indentation and the line feed
+		for (long written = 0; written < size; written += 64) {
+			buffer_printf(&buffer, "  %060ld\n", written);
+		}
+	} break;
+	default:
+		free(buffer.data);
+		return NULL;
+	}
+
+	if (buffer.data && len) *len = buffer.len;
+	return buffer.data;
+}
+
+char* corpus_deep_path(long depth)
+{
+	buffer_t buffer = {malloc(256), 0, 256};
+	if (!buffer.data) return NULL;
+	buffer.data[0] = '\0';
+	for (long level = 0; level < depth; ++level) {
+		buffer_printf(&buffer, ".l%ld", level);
+	}
+	return buffer.data;
+}
@@ -0,0 +1,59 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef CORPUS_H__
+#define CORPUS_H__
+
+#include <stddef.h>
+
+/** The shapes of the synthetic YAML documents
+ */
+typedef enum corpus_shape_e {
+	/// nested mappings, `size' levels deep, each level with a few siblings
+	CORPUS_DEEP,
+	/// a single mapping with `size' keys
+	CORPUS_WIDE,
+	/// a single sequence with `size' records
+	CORPUS_LONG_SEQUENCE,
+	/// a mapping holding a literal block scalar of `size' bytes
+	CORPUS_LARGE_SCALAR,
+	CORPUS_NB_SHAPES
+} corpus_shape_t;
+
+/** Returns the name of a shape
+ */
+const char* corpus_shape_name(corpus_shape_t shape);
+
+/** Looks for a shape by name
+ *
+ * \param name the name of the shape
+ * \return the shape, CORPUS_NB_SHAPES if there is none with this name
+ */
+corpus_shape_t corpus_shape_find(const char* name);
+
+/** Generates a synthetic YAML document
+ *
+ * The documents are deterministic for a given shape and size:
+ * * deep: the leaf is at `.l0.l1 ... .l<size-1>', each level also has keys `s0' to `s3',
+ * * wide: the keys are `k0' to `k<size-1>' with values 0 to size-1,
+ * * long_sequence: item `[i]' is the sequence `[i, i/2, true, "name_i"]',
+ * * large_scalar: the scalar is at `.text'.
+ *
+ * \param shape the shape of the document
+ * \param size the depth, width, length or byte size of the document depending on its shape
+ * \param[out] len the length of the document, can be NULL
+ * \return the null-terminated document, must be deallocated using free, NULL on allocation error
+ */
+char* corpus_generate(corpus_shape_t shape, long size, size_t* len);
+
+/** Returns the path of the leaf of a deep document
+ *
+ * \param depth the depth of the document
+ * \return the null-terminated path, must be deallocated using free
+ */
+char* corpus_deep_path(long depth);
+
+#endif // CORPUS_H__
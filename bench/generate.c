@@ -0,0 +1,44 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "corpus.h"
+
+/* Writes a synthetic YAML document, as used by bench_suite, to a file.
+ *
+ * usage: bench_generate shape size [file]
+ * shape is one of deep, wide, long_sequence or large_scalar, the document is
+ * written to the standard output if no file is given.
+ */
+
+int main(int argc, char* argv[])
+{
+	corpus_shape_t shape = argc > 2 ? corpus_shape_find(argv[1]) : CORPUS_NB_SHAPES;
+	if (shape == CORPUS_NB_SHAPES) {
+		fprintf(stderr, "usage: %s deep|wide|long_sequence|large_scalar size [file]\n", argv[0]);
+		return 1;
+	}
+
+	size_t len;
+	char* document = corpus_generate(shape, atol(argv[2]), &len);
+	if (!document) {
+		fprintf(stderr, "unable to generate the document\n");
+		return 1;
+	}
+
+	FILE* file = argc > 3 ? fopen(argv[3], "w") : stdout;
+	if (!file) {
+		perror(argv[3]);
+		free(document);
+		return 1;
+	}
+	int ok = fwrite(document, 1, len, file) == len;
+	if (file != stdout) ok = !fclose(file) && ok;
+	free(document);
+	return !ok;
+}
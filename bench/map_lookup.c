@@ -0,0 +1,81 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#include "bench.h"
+
+/* Measures the cost of a `.key' lookup in mappings of increasing width, the
+ * time per lookup should stay flat as the mapping grows. The lookup of a
+ * missing optional key should cost the same as that of an existing key.
+ */
+
+#define NB_LOOKUPS 1000000
+
+static char* wide_mapping(int width)
+{
+	size_t size = 32 * (size_t)width + 1;
+	char* yaml = malloc(size);
+	size_t pos = 0;
+	for (int ii = 0; ii < width; ++ii) {
+		pos += snprintf(yaml + pos, size - pos, "species_%d: %d\n", ii, ii);
+	}
+	return yaml;
+}
+
+int main()
+{
+	printf("%10s %14s %14s %14s\n", "width", "first (us)", "lookup (ns)", "missing (ns)");
+	for (int width = 4; width <= 16384; width *= 4) {
+		char* yaml = wide_mapping(width);
+		PC_tree_t conf = PC_parse_string(yaml);
+
+		char key[32];
+		double start = bench_now();
+		snprintf(key, sizeof(key), ".species_%d", width - 1);
+		PC_get(conf, key);
+		double first = bench_now() - start;
+
+		// a fixed pseudo-random sequence of keys spread over the whole mapping
+		enum { NB_KEYS = 64 };
+		char keys[NB_KEYS][32];
+		unsigned seed = 12345;
+		for (int ii = 0; ii < NB_KEYS; ++ii) {
+			seed = seed * 1103515245u + 12345u;
+			snprintf(keys[ii], sizeof(keys[ii]), ".species_%u", (seed >> 8) % width);
+		}
+
+		long sum = 0;
+		start = bench_now();
+		for (int ii = 0; ii < NB_LOOKUPS; ++ii) {
+			long value;
+			PC_int(PC_get(conf, keys[ii % NB_KEYS]), &value);
+			sum += value;
+		}
+		double elapsed = bench_now() - start;
+
+		start = bench_now();
+		for (int ii = 0; ii < NB_LOOKUPS; ++ii) {
+			long value;
+			PC_int_or(conf, ".missing_species", ii, &value);
+			sum += value;
+		}
+		double missing = bench_now() - start;
+
+		printf("%10d %14.2f %14.1f %14.1f\n", width, first * 1e6, elapsed * 1e9 / NB_LOOKUPS, missing * 1e9 / NB_LOOKUPS);
+		if (sum < 0) printf("unexpected sum %ld\n", sum);
+
+		PC_tree_destroy(&conf);
+		free(yaml);
+	}
+	return 0;
+}
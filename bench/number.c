@@ -0,0 +1,168 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "number.h"
+
+/* Compares the internal numeric parsers with strtod & strtol on a few
+ * realistic value distributions.
+ *
+ * usage: bench_number [nb_values]
+ */
+
+#define NB_RUNS 5
+
+typedef struct values_s {
+	char* buffer;
+	const char** strings;
+	size_t* lengths;
+	int nb_values;
+	size_t size;
+} values_t;
+
+static double random_double()
+{
+	return rand() / (RAND_MAX + 1.);
+}
+
+static void generate(values_t* values, int nb_values, const char* format, int integer)
+{
+	values->buffer = malloc(nb_values * 32);
+	values->strings = malloc(nb_values * sizeof(char*));
+	values->lengths = malloc(nb_values * sizeof(size_t));
+	values->nb_values = nb_values;
+	size_t pos = 0;
+	for (int ii = 0; ii < nb_values; ++ii) {
+		values->strings[ii] = values->buffer + pos;
+		int len;
+		if (integer) {
+			len = sprintf(values->buffer + pos, format, (long)(random_double() * integer));
+		} else {
+			// log-uniform magnitudes from 1e-5 to 1e5
+			double value = random_double() * 2 - 1;
+			for (int exponent = rand() % 11 - 5; exponent > 0; --exponent)
+				value *= 10;
+			for (int exponent = rand() % 11 - 5; exponent < 0; ++exponent)
+				value /= 10;
+			len = sprintf(values->buffer + pos, format, value);
+		}
+		values->lengths[ii] = len;
+		pos += len + 1;
+	}
+	values->size = pos;
+}
+
+static double bench_strtod(const values_t* values)
+{
+	double sum = 0;
+	double start = bench_now();
+	for (int ii = 0; ii < values->nb_values; ++ii) {
+		sum += strtod(values->strings[ii], NULL);
+	}
+	double elapsed = bench_now() - start;
+	if (sum == 42) printf(" ");
+	return elapsed;
+}
+
+static double bench_parse_double(const values_t* values)
+{
+	double sum = 0;
+	double start = bench_now();
+	for (int ii = 0; ii < values->nb_values; ++ii) {
+		double value;
+		pc_parse_double(values->strings[ii], values->lengths[ii], &value);
+		sum += value;
+	}
+	double elapsed = bench_now() - start;
+	if (sum == 42) printf(" ");
+	return elapsed;
+}
+
+static double bench_strtol(const values_t* values)
+{
+	long sum = 0;
+	double start = bench_now();
+	for (int ii = 0; ii < values->nb_values; ++ii) {
+		sum += strtol(values->strings[ii], NULL, 0);
+	}
+	double elapsed = bench_now() - start;
+	if (sum == 42) printf(" ");
+	return elapsed;
+}
+
+static double bench_parse_long(const values_t* values)
+{
+	long sum = 0;
+	double start = bench_now();
+	for (int ii = 0; ii < values->nb_values; ++ii) {
+		long value;
+		pc_parse_long(values->strings[ii], values->lengths[ii], &value);
+		sum += value;
+	}
+	double elapsed = bench_now() - start;
+	if (sum == 42) printf(" ");
+	return elapsed;
+}
+
+static double best_of(double (*parse)(const values_t*), const values_t* values)
+{
+	double best = 1e30;
+	for (int run = 0; run < NB_RUNS; ++run) {
+		double elapsed = parse(values);
+		if (elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	int nb_values = argc > 1 ? atoi(argv[1]) : 1000000;
+	srand(1);
+
+	struct {
+		const char* name;
+		const char* format;
+		int integer;
+	} distributions[] = {
+		{"%.17g", "%.17g", 0},
+		{"%.6e", "%.6e", 0},
+		{"%.3f", "%.3f", 0},
+		{"small int", "%ld", 1000},
+		{"large int", "%ld", 2000000000},
+	};
+	printf("%12s %10s %10s %10s %10s %8s\n", "values", "libc ns/v", "pc ns/v", "libc MB/s", "pc MB/s", "speedup");
+	for (size_t dist = 0; dist < sizeof(distributions) / sizeof(distributions[0]); ++dist) {
+		values_t values;
+		generate(&values, nb_values, distributions[dist].format, distributions[dist].integer);
+		double libc, pc;
+		if (distributions[dist].integer) {
+			libc = best_of(bench_strtol, &values);
+			pc = best_of(bench_parse_long, &values);
+		} else {
+			libc = best_of(bench_strtod, &values);
+			pc = best_of(bench_parse_double, &values);
+		}
+		printf(
+			"%12s %10.1f %10.1f %10.1f %10.1f %8.2f\n",
+			distributions[dist].name,
+			libc * 1e9 / nb_values,
+			pc * 1e9 / nb_values,
+			values.size / libc / (1024 * 1024),
+			values.size / pc / (1024 * 1024),
+			libc / pc
+		);
+		free(values.lengths);
+		free(values.strings);
+		free(values.buffer);
+	}
+	return 0;
+}
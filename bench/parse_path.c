@@ -0,0 +1,117 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#include "bench.h"
+
+/* Compares PC_parse_path (memory-mapped input) with PC_parse_file on a stdio
+ * stream (the former PC_parse_path implementation) and with
+ * PC_parse_path_cached once its cache is built, with a cold and a warm page
+ * cache.
+ *
+ * usage: bench_parse_path [size_in_MB [file]]
+ * The file is generated if it does not exist. The cold-cache measure relies on
+ * posix_fadvise(POSIX_FADV_DONTNEED) which has no effect on tmpfs.
+ */
+
+#define NB_RUNS 5
+
+static void generate(const char* path, long size)
+{
+	FILE* file = fopen(path, "w");
+	long written = 0;
+	for (int table = 0; written < size; ++table) {
+		written += fprintf(file, "table_%d:\n", table);
+		for (int row = 0; row < 1000 && written < size; ++row) {
+			written += fprintf(file, "  - [%d, %.6e, %.6e, \"cell_%d_%d\"]\n", row, row * 0.5, 1.0 / (row + 1), table, row);
+		}
+	}
+	fclose(file);
+}
+
+static void drop_cache(const char* path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return;
+	fdatasync(fd);
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+}
+
+static double parse_stdio(const char* path)
+{
+	double start = bench_now();
+	FILE* file = fopen(path, "rb");
+	PC_tree_t tree = PC_parse_file(file);
+	fclose(file);
+	double elapsed = bench_now() - start;
+	PC_tree_destroy(&tree);
+	return elapsed;
+}
+
+static double parse_mmap(const char* path)
+{
+	double start = bench_now();
+	PC_tree_t tree = PC_parse_path(path);
+	double elapsed = bench_now() - start;
+	PC_tree_destroy(&tree);
+	return elapsed;
+}
+
+static double parse_cached(const char* path)
+{
+	double start = bench_now();
+	PC_tree_t tree = PC_parse_path_cached(path, NULL);
+	double elapsed = bench_now() - start;
+	PC_tree_destroy(&tree);
+	return elapsed;
+}
+
+static double best_of(double (*parse)(const char*), const char* path, int cold)
+{
+	double best = 1e30;
+	if (!cold) parse(path); // warm-up
+	for (int run = 0; run < NB_RUNS; ++run) {
+		if (cold) drop_cache(path);
+		double elapsed = parse(path);
+		if (elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	long size = (argc > 1 ? atol(argv[1]) : 32) * 1024 * 1024;
+	const char* path = argc > 2 ? argv[2] : "bench_parse_path.yml";
+	if (access(path, R_OK)) generate(path, size);
+	struct stat path_stat;
+	if (stat(path, &path_stat)) {
+		perror(path);
+		return 1;
+	}
+	size = path_stat.st_size;
+
+	printf("%8s %8s %12s %12s\n", "input", "cache", "time (ms)", "MB/s");
+	parse_cached(path); // builds the cache
+	const char* inputs[] = {"stdio", "mmap", "cached"};
+	double (*parsers[])(const char*) = {parse_stdio, parse_mmap, parse_cached};
+	for (int cold = 1; cold >= 0; --cold) {
+		for (int input = 0; input < 3; ++input) {
+			double elapsed = best_of(parsers[input], path, cold);
+			printf("%8s %8s %12.1f %12.1f\n", inputs[input], cold ? "cold" : "warm", elapsed * 1e3, size / elapsed / (1024 * 1024));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,720 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#include "bench.h"
+#include "corpus.h"
+
+/* Measures the main costs of paraconf on synthetic documents and reports them
+ * in a machine-readable format to track their evolution:
+ * * parse_string & parse_path: parsing throughput by document shape and size,
+ * * parse_string_libyaml: parse_string with the native scanner disabled,
+ * * parse_path_lazy: throughput of a lazy parse followed by a single access to
+ *   the first top-level value, i.e. of a sparse access to a file,
+ * * emit_string: throughput of PC_emit_string in block style, by document shape
+ *   and size, measured on the size of its output,
+ * * parse_paths: throughput of PC_parse_paths on many small files, with a
+ *   single worker and with one worker per core,
+ * * parse_path_parallel: throughput of PC_parse_path_parallel on a single large
+ *   document, by number of threads up to one per core,
+ * * get_depth & get_width: PC_get latency by depth of nesting and mapping width,
+ * * get_overlay: PC_get latency through a 4 layers overlay, by mapping width,
+ * * get_threads: aggregated PC_get throughput of threads sharing a document, by
+ *   number of threads up to one per core,
+ * * getter: typed getters cost on an already found node,
+ * * error: cost of the paths that report a missing or invalid node,
+ * * peak_rss & rss_per_byte: memory used to parse each document shape.
+ *
+ * usage: bench_suite [-f csv|json] [-o file] [-s scale]
+ * The sizes of the documents are multiplied by scale (1 by default), the
+ * results are written as CSV to the standard output by default.
+ */
+
+#define NB_RUNS 5
+
+/// the minimum duration of a measured run, in seconds
+#define MIN_RUN_TIME 0.01
+
+#define MAX_RESULTS 256
+
+/** A single measure
+ */
+typedef struct result_s {
+	/// what was measured
+	const char* benchmark;
+
+	/// the variant, e.g. document shape or getter
+	const char* variant;
+
+	/// the size of the document, meaning depends on the shape
+	long size;
+
+	/// the measured value
+	double value;
+
+	/// the unit of value
+	const char* unit;
+
+} result_t;
+
+static result_t results[MAX_RESULTS];
+
+static int nb_results = 0;
+
+/// prevents the compiler from optimizing the measured calls away
+static volatile uintptr_t sink;
+
+static void record(const char* benchmark, const char* variant, long size, double value, const char* unit)
+{
+	if (nb_results >= MAX_RESULTS) return;
+	results[nb_results++] = (result_t){benchmark, variant, size, value, unit};
+	fprintf(stderr, "%-14s %-14s %10ld %14.2f %s\n", benchmark, variant, size, value, unit);
+}
+
+/** A measured loop
+ *
+ * \param context the data of the loop
+ * \param nb_iters the number of iterations to run
+ */
+typedef void (*loop_f)(void* context, long nb_iters);
+
+/** Returns the best time per iteration of a loop, in seconds
+ *
+ * The number of iterations is first doubled until a run lasts MIN_RUN_TIME.
+ */
+static double best_time(loop_f loop, void* context)
+{
+	long nb_iters = 1;
+	for (;;) {
+		double start = bench_now();
+		loop(context, nb_iters);
+		if (bench_now() - start >= MIN_RUN_TIME) break;
+		nb_iters *= 2;
+	}
+	double best = 1e30;
+	for (int run = 0; run < NB_RUNS; ++run) {
+		double start = bench_now();
+		loop(context, nb_iters);
+		double elapsed = (bench_now() - start) / nb_iters;
+		if (elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+// Parsing
+
+static void loop_parse_string(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_tree_t tree = PC_parse_string(context);
+		sink = (uintptr_t)tree.node;
+		PC_tree_destroy(&tree);
+	}
+}
+
+static void loop_parse_path(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_tree_t tree = PC_parse_path(context);
+		sink = (uintptr_t)tree.node;
+		PC_tree_destroy(&tree);
+	}
+}
+
+static void loop_parse_path_lazy(void* context, long nb_iters)
+{
+	// documents whose root is not a mapping have no first value
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_tree_t tree = PC_parse_path_lazy(context);
+		sink = (uintptr_t)PC_get(tree, "<0>").node;
+		PC_tree_destroy(&tree);
+	}
+	PC_errhandler(handler);
+}
+
+static void loop_emit_string(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		char* output = NULL;
+		PC_emit_string(*(PC_tree_t*)context, PC_EMIT_BLOCK, &output);
+		sink = (uintptr_t)output;
+		free(output);
+	}
+}
+
+static void bench_parse(corpus_shape_t shape, long size)
+{
+	size_t len;
+	char* document = corpus_generate(shape, size, &len);
+	if (!document) return;
+	double mbytes = len / (1024. * 1024.);
+	record("parse_string", corpus_shape_name(shape), size, mbytes / best_time(loop_parse_string, document), "MB/s");
+	// the same parse with libyaml only, for the documents the native scanner supports
+	setenv("PARACONF_PARSER", "libyaml", 1);
+	record("parse_string_libyaml", corpus_shape_name(shape), size, mbytes / best_time(loop_parse_string, document), "MB/s");
+	unsetenv("PARACONF_PARSER");
+
+	// emission throughput is measured on the size of the output
+	PC_tree_t tree = PC_parse_string(document);
+	char* output = NULL;
+	if (!PC_emit_string(tree, PC_EMIT_BLOCK, &output)) {
+		double output_mbytes = strlen(output) / (1024. * 1024.);
+		record("emit_string", corpus_shape_name(shape), size, output_mbytes / best_time(loop_emit_string, &tree), "MB/s");
+	}
+	free(output);
+	PC_tree_destroy(&tree);
+
+	const char* tmpdir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+	char path[1024];
+	snprintf(path, sizeof(path), "%s/paraconf_bench_XXXXXX", tmpdir);
+	int fd = mkstemp(path);
+	if (fd >= 0) {
+		int written = write(fd, document, len) == (ssize_t)len;
+		close(fd);
+		if (written) {
+			record("parse_path", corpus_shape_name(shape), size, mbytes / best_time(loop_parse_path, path), "MB/s");
+			record("parse_path_lazy", corpus_shape_name(shape), size, mbytes / best_time(loop_parse_path_lazy, path), "MB/s");
+		}
+		unlink(path);
+	}
+	free(document);
+}
+
+/// number of files parsed by each call to PC_parse_paths
+#define BATCH_NB_FILES 256
+
+typedef struct batch_context_s {
+	const char* paths[BATCH_NB_FILES];
+	int nb_workers;
+} batch_context_t;
+
+static void loop_parse_paths(void* context, long nb_iters)
+{
+	batch_context_t* batch = context;
+	PC_tree_t trees[BATCH_NB_FILES];
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_parse_paths(batch->paths, BATCH_NB_FILES, batch->nb_workers, trees);
+		for (int file = 0; file < BATCH_NB_FILES; ++file) {
+			if (!PC_status(trees[file])) PC_tree_destroy(&trees[file]);
+		}
+	}
+}
+
+static void bench_parse_paths(long size)
+{
+	size_t len;
+	char* document = corpus_generate(CORPUS_WIDE, size, &len);
+	if (!document) return;
+
+	const char* tmpdir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+	char dir[1024];
+	snprintf(dir, sizeof(dir), "%s/paraconf_bench_XXXXXX", tmpdir);
+	if (!mkdtemp(dir)) {
+		free(document);
+		return;
+	}
+	static char paths[BATCH_NB_FILES][1100];
+	batch_context_t batch;
+	int written = 1;
+	for (int file = 0; file < BATCH_NB_FILES; ++file) {
+		snprintf(paths[file], sizeof(paths[file]), "%s/%d.yml", dir, file);
+		batch.paths[file] = paths[file];
+		FILE* output = fopen(paths[file], "w");
+		if (!output) {
+			written = 0;
+			continue;
+		}
+		written &= fwrite(document, 1, len, output) == len;
+		fclose(output);
+	}
+
+	if (written) {
+		batch.nb_workers = 1;
+		record("parse_paths", "1_worker", size, BATCH_NB_FILES / best_time(loop_parse_paths, &batch), "files/s");
+		batch.nb_workers = 0;
+		record("parse_paths", "all_workers", size, BATCH_NB_FILES / best_time(loop_parse_paths, &batch), "files/s");
+	}
+
+	for (int file = 0; file < BATCH_NB_FILES; ++file) {
+		unlink(paths[file]);
+	}
+	rmdir(dir);
+	free(document);
+}
+
+typedef struct parallel_context_s {
+	const char* path;
+	int nb_workers;
+} parallel_context_t;
+
+static void loop_parse_path_parallel(void* context, long nb_iters)
+{
+	parallel_context_t* parallel = context;
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_tree_t tree = PC_parse_path_parallel(parallel->path, parallel->nb_workers);
+		sink = (uintptr_t)tree.node;
+		PC_tree_destroy(&tree);
+	}
+}
+
+static void bench_parse_parallel(long size)
+{
+	size_t len;
+	char* document = corpus_generate(CORPUS_WIDE, size, &len);
+	if (!document) return;
+	double mbytes = len / (1024. * 1024.);
+
+	const char* tmpdir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+	char path[1024];
+	snprintf(path, sizeof(path), "%s/paraconf_bench_XXXXXX", tmpdir);
+	int fd = mkstemp(path);
+	if (fd >= 0) {
+		int written = write(fd, document, len) == (ssize_t)len;
+		close(fd);
+		if (written) {
+			parallel_context_t parallel = {path, 1};
+			long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+			if (nb_cores < 1) nb_cores = 1;
+			for (long nb_threads = 1;; nb_threads *= 2) {
+				if (nb_threads > nb_cores) nb_threads = nb_cores;
+				parallel.nb_workers = nb_threads;
+				record("parse_path_parallel", "wide", nb_threads, mbytes / best_time(loop_parse_path_parallel, &parallel), "MB/s");
+				if (nb_threads == nb_cores) break;
+			}
+		}
+		unlink(path);
+	}
+	free(document);
+}
+
+// Lookups
+
+typedef struct get_context_s {
+	PC_tree_t tree;
+	char** paths;
+	int nb_paths;
+} get_context_t;
+
+static void loop_get(void* context, long nb_iters)
+{
+	get_context_t* get = context;
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		sink = (uintptr_t)PC_get(get->tree, get->paths[ii % get->nb_paths]).node;
+	}
+}
+
+static void bench_get_depth(long depth)
+{
+	char* document = corpus_generate(CORPUS_DEEP, depth, NULL);
+	char* path = corpus_deep_path(depth);
+	get_context_t get = {PC_parse_string(document), &path, 1};
+	record("get_depth", "deep", depth, best_time(loop_get, &get) * 1e9, "ns");
+	PC_tree_destroy(&get.tree);
+	free(path);
+	free(document);
+}
+
+static void bench_get_width(long width)
+{
+	enum { NB_KEYS = 64 };
+	char* document = corpus_generate(CORPUS_WIDE, width, NULL);
+	char* paths[NB_KEYS];
+	// a fixed pseudo-random sequence of keys spread over the whole mapping
+	unsigned seed = 12345;
+	for (int ii = 0; ii < NB_KEYS; ++ii) {
+		seed = seed * 1103515245u + 12345u;
+		paths[ii] = malloc(32);
+		snprintf(paths[ii], 32, ".k%lu", (unsigned long)((seed >> 8) % width));
+	}
+	get_context_t get = {PC_parse_string(document), paths, NB_KEYS};
+	record("get_width", "wide", width, best_time(loop_get, &get) * 1e9, "ns");
+
+	// the same lookups through an overlay of the document and 3 small layers
+	PC_tree_t layers[4] = {get.tree, PC_parse_string("{k0: 1}"), PC_parse_string("{k1: 2}"), PC_parse_string("{k2: 3}")};
+	get.tree = PC_overlay(layers, 4);
+	record("get_overlay", "wide", width, best_time(loop_get, &get) * 1e9, "ns");
+	PC_tree_destroy(&get.tree);
+	for (int layer = 0; layer < 4; ++layer) {
+		PC_tree_destroy(&layers[layer]);
+	}
+	for (int ii = 0; ii < NB_KEYS; ++ii) {
+		free(paths[ii]);
+	}
+	free(document);
+}
+
+typedef struct threads_context_s {
+	get_context_t get;
+	/// set to start all threads at once
+	int start;
+	/// the number of lookups each thread does
+	long nb_iters;
+} threads_context_t;
+
+static void* thread_get(void* context)
+{
+	threads_context_t* threads = context;
+	// each thread holds its own reference, as an independent task would
+	PC_tree_t tree = threads->get.tree;
+	PC_tree_retain(tree);
+	while (!__atomic_load_n(&threads->start, __ATOMIC_ACQUIRE))
+		sched_yield();
+	uintptr_t local_sink = 0;
+	for (long ii = 0; ii < threads->nb_iters; ++ii) {
+		local_sink += (uintptr_t)PC_get(tree, threads->get.paths[ii % threads->get.nb_paths]).node;
+	}
+	sink = local_sink;
+	PC_tree_release(&tree);
+	return NULL;
+}
+
+/** Returns the aggregated lookups per second of a number of threads
+ */
+static double threads_throughput(threads_context_t* threads, int nb_threads)
+{
+	pthread_t* ids = malloc(nb_threads * sizeof(pthread_t));
+	double best = 0;
+	for (int run = 0; run < NB_RUNS; ++run) {
+		__atomic_store_n(&threads->start, 0, __ATOMIC_RELEASE);
+		int nb_started = 0;
+		while (nb_started < nb_threads && !pthread_create(&ids[nb_started], NULL, thread_get, threads))
+			++nb_started;
+		double start = bench_now();
+		__atomic_store_n(&threads->start, 1, __ATOMIC_RELEASE);
+		for (int thread = 0; thread < nb_started; ++thread) {
+			pthread_join(ids[thread], NULL);
+		}
+		double throughput = nb_started * threads->nb_iters / (bench_now() - start);
+		if (throughput > best) best = throughput;
+	}
+	free(ids);
+	return best;
+}
+
+static void bench_get_threads(long width)
+{
+	enum { NB_KEYS = 64 };
+	char* document = corpus_generate(CORPUS_WIDE, width, NULL);
+	char* paths[NB_KEYS];
+	unsigned seed = 12345;
+	for (int ii = 0; ii < NB_KEYS; ++ii) {
+		seed = seed * 1103515245u + 12345u;
+		paths[ii] = malloc(32);
+		snprintf(paths[ii], 32, ".k%lu", (unsigned long)((seed >> 8) % width));
+	}
+	threads_context_t threads = {{PC_parse_string(document), paths, NB_KEYS}, 0, 0};
+	PC_tree_freeze(&threads.get.tree);
+
+	// each thread runs long enough to amortize its creation
+	threads.nb_iters = 1;
+	double single_time = best_time(loop_get, &threads.get);
+	threads.nb_iters = 0.05 / single_time + 1;
+
+	long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_cores < 1) nb_cores = 1;
+	for (long nb_threads = 1;; nb_threads *= 2) {
+		if (nb_threads > nb_cores) nb_threads = nb_cores;
+		record("get_threads", "wide", nb_threads, threads_throughput(&threads, nb_threads), "lookups/s");
+		if (nb_threads == nb_cores) break;
+	}
+
+	PC_tree_destroy(&threads.get.tree);
+	for (int ii = 0; ii < NB_KEYS; ++ii) {
+		free(paths[ii]);
+	}
+	free(document);
+}
+
+// Typed getters
+
+static void loop_int(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		long value;
+		PC_int(*(PC_tree_t*)context, &value);
+		sink = value;
+	}
+}
+
+static void loop_double(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		double value;
+		PC_double(*(PC_tree_t*)context, &value);
+		sink = (uintptr_t)value;
+	}
+}
+
+static void loop_bool(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		int value;
+		PC_bool(*(PC_tree_t*)context, &value);
+		sink = value;
+	}
+}
+
+static void loop_string(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		char* value;
+		PC_string(*(PC_tree_t*)context, &value);
+		sink = (uintptr_t)value;
+		free(value);
+	}
+}
+
+static void loop_string_view(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		const char* value;
+		PC_string_view(*(PC_tree_t*)context, &value, NULL);
+		sink = (uintptr_t)value;
+	}
+}
+
+static void bench_getters(int resolved)
+{
+	PC_tree_t conf = PC_parse_string("{int: 1234567, double: 1.25e-3, bool: true, string: some text value}");
+	if (resolved) PC_tree_resolve(conf);
+	const char* variants[][2] = {{"int", "int_resolved"}, {"double", "double_resolved"}, {"bool", "bool_resolved"}};
+	loop_f loops[] = {loop_int, loop_double, loop_bool};
+	for (int getter = 0; getter < 3; ++getter) {
+		PC_tree_t node = PC_get(conf, ".%s", variants[getter][0]);
+		record("getter", variants[getter][resolved], 1, best_time(loops[getter], &node) * 1e9, "ns");
+	}
+	if (!resolved) {
+		PC_tree_t node = PC_get(conf, ".string");
+		record("getter", "string", 1, best_time(loop_string, &node) * 1e9, "ns");
+		record("getter", "string_view", 1, best_time(loop_string_view, &node) * 1e9, "ns");
+	}
+	PC_tree_destroy(&conf);
+}
+
+// Error paths
+
+static void loop_get_missing(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		sink = PC_status(PC_get(*(PC_tree_t*)context, ".missing"));
+	}
+}
+
+static void loop_get_missing_errmsg(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		PC_get(*(PC_tree_t*)context, ".missing");
+		sink = (uintptr_t)PC_errmsg();
+	}
+}
+
+static void loop_has_missing(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		sink = PC_has(*(PC_tree_t*)context, ".missing");
+	}
+}
+
+static void loop_int_or_missing(void* context, long nb_iters)
+{
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		long value;
+		PC_int_or(*(PC_tree_t*)context, ".missing", 0, &value);
+		sink = value;
+	}
+}
+
+static void loop_int_invalid(void* context, long nb_iters)
+{
+	PC_tree_t node = PC_get(*(PC_tree_t*)context, ".k0_text");
+	for (long ii = 0; ii < nb_iters; ++ii) {
+		long value;
+		sink = PC_int(node, &value);
+	}
+}
+
+static void bench_errors()
+{
+	PC_tree_t conf = PC_parse_string("{k0: 0, k1: 1, k2: 2, k3: 3, k0_text: zero}");
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	record("error", "get_missing", 1, best_time(loop_get_missing, &conf) * 1e9, "ns");
+	record("error", "get_errmsg", 1, best_time(loop_get_missing_errmsg, &conf) * 1e9, "ns");
+	record("error", "has_missing", 1, best_time(loop_has_missing, &conf) * 1e9, "ns");
+	record("error", "int_or_missing", 1, best_time(loop_int_or_missing, &conf) * 1e9, "ns");
+	record("error", "int_invalid", 1, best_time(loop_int_invalid, &conf) * 1e9, "ns");
+	PC_errhandler(handler);
+	PC_tree_destroy(&conf);
+}
+
+// Memory
+
+/** Returns the peak resident set size of the process in KiB
+ */
+static long peak_rss()
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/** Measures the memory used to parse a document in a child process so that measures are independent
+ */
+static void bench_rss(corpus_shape_t shape, long size)
+{
+	size_t len;
+	char* document = corpus_generate(shape, size, &len);
+	if (!document) return;
+	int pipe_fds[2];
+	if (pipe(pipe_fds)) {
+		free(document);
+		return;
+	}
+	pid_t child = fork();
+	if (child == 0) {
+		close(pipe_fds[0]);
+		long rss[2];
+		rss[0] = peak_rss();
+		PC_tree_t tree = PC_parse_string(document);
+		rss[1] = peak_rss();
+		PC_tree_destroy(&tree);
+		_exit(write(pipe_fds[1], rss, sizeof(rss)) != sizeof(rss));
+	}
+	close(pipe_fds[1]);
+	long rss[2];
+	int valid = child > 0 && read(pipe_fds[0], rss, sizeof(rss)) == sizeof(rss);
+	close(pipe_fds[0]);
+	if (child > 0) waitpid(child, NULL, 0);
+	if (valid) {
+		record("peak_rss", corpus_shape_name(shape), size, rss[1], "KiB");
+		record("rss_per_byte", corpus_shape_name(shape), size, (rss[1] - rss[0]) * 1024. / len, "B/B");
+	}
+	free(document);
+}
+
+// Output
+
+static void write_csv(FILE* output)
+{
+	fprintf(output, "benchmark,variant,size,value,unit\n");
+	for (int ii = 0; ii < nb_results; ++ii) {
+		const result_t* result = &results[ii];
+		fprintf(output, "%s,%s,%ld,%.6g,%s\n", result->benchmark, result->variant, result->size, result->value, result->unit);
+	}
+}
+
+static void write_json(FILE* output)
+{
+	uint64_t version = PC_version();
+	fprintf(output, "{\n");
+	fprintf(output,
+	        "  \"version\": \"%u.%u.%u\",\n",
+	        (unsigned)(version >> 48),
+	        (unsigned)(version >> 32 & 0xFFFF),
+	        (unsigned)(version >> 16 & 0xFFFF));
+	fprintf(output, "  \"results\": [\n");
+	for (int ii = 0; ii < nb_results; ++ii) {
+		const result_t* result = &results[ii];
+		fprintf(output,
+		        "    {\"benchmark\": \"%s\", \"variant\": \"%s\", \"size\": %ld, \"value\": %.6g, \"unit\": \"%s\"}%s\n",
+		        result->benchmark,
+		        result->variant,
+		        result->size,
+		        result->value,
+		        result->unit,
+		        ii + 1 < nb_results ? "," : "");
+	}
+	fprintf(output, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+	const char* format = "csv";
+	const char* output_path = NULL;
+	double scale = 1;
+	int opt;
+	while ((opt = getopt(argc, argv, "f:o:s:")) != -1) {
+		switch (opt) {
+		case 'f':
+			format = optarg;
+			break;
+		case 'o':
+			output_path = optarg;
+			break;
+		case 's':
+			scale = atof(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-f csv|json] [-o file] [-s scale]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (strcmp(format, "csv") && strcmp(format, "json")) {
+		fprintf(stderr, "unknown format `%s', expected csv or json\n", format);
+		return 1;
+	}
+	if (scale <= 0) scale = 1;
+
+	// the depth is not scaled, libyaml limits nesting
+	long sizes[CORPUS_NB_SHAPES][3] = {
+		{16, 64, 256},
+		{1000 * scale, 10000 * scale, 100000 * scale},
+		{1000 * scale, 10000 * scale, 100000 * scale},
+		{65536 * scale, 1048576 * scale, 16777216 * scale},
+	};
+
+	// memory is measured first, while the process is small
+	for (int shape = 0; shape < CORPUS_NB_SHAPES; ++shape) {
+		bench_rss(shape, sizes[shape][2]);
+	}
+	for (int shape = 0; shape < CORPUS_NB_SHAPES; ++shape) {
+		for (int size = 0; size < 3; ++size) {
+			bench_parse(shape, sizes[shape][size]);
+		}
+	}
+	bench_parse_paths(100);
+	bench_parse_parallel(1000000 * scale);
+	for (long depth = 1; depth <= 256; depth *= 4) {
+		bench_get_depth(depth);
+	}
+	for (long width = 16; width <= 65536 * scale; width *= 16) {
+		bench_get_width(width);
+	}
+	bench_get_threads(10000 * scale);
+	bench_getters(0);
+	bench_getters(1);
+	bench_errors();
+
+	FILE* output = output_path ? fopen(output_path, "w") : stdout;
+	if (!output) {
+		perror(output_path);
+		return 1;
+	}
+	if (!strcmp(format, "json")) {
+		write_json(output);
+	} else {
+		write_csv(output);
+	}
+	if (output != stdout) fclose(output);
+	return 0;
+}
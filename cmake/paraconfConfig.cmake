@@ -58,6 +58,13 @@ foreach(_paraconf_ONE_COMPONENT ${paraconf_FIND_COMPONENTS})
 endforeach()
 
 
+# Functions
+
+if(TARGET paraconf::paraconf_codegen)
+	include("${CMAKE_CURRENT_LIST_DIR}/paraconfGenerateReader.cmake")
+endif()
+
+
 # Cleanup
 
 unset(_paraconf_FIND_QUIETLY_OPTIONAL)
@@ -0,0 +1,69 @@
+# Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+#               root of the project or at https://github.com/pdidev/paraconf
+#
+# SPDX-License-Identifier: MIT
+
+#[=======================================================================[.rst:
+paraconf_generate_reader
+------------------------
+
+Generates a typed reader from a kwalify schema::
+
+  paraconf_generate_reader(<schema>
+      TARGET <target>
+      [PREFIX <prefix>]
+      [FORTRAN])
+
+Creates the static library ``<target>`` from the C header and source generated
+by ``paraconf_codegen`` for ``<schema>``. They define the ``<prefix>_t``
+struct matching the schema and the ``<prefix>_read`` & ``<prefix>_free``
+functions, ``<prefix>`` defaults to ``<target>``. Linking ``<target>`` gives
+access to the ``<prefix>.h`` header.
+
+With ``FORTRAN``, the library also contains the ``<prefix>`` Fortran module
+wrapping the C reader. The Fortran language must be enabled.
+#]=======================================================================]
+
+function(paraconf_generate_reader SCHEMA)
+	cmake_parse_arguments(PARSE_ARGV 1 _PC_GEN "FORTRAN" "TARGET;PREFIX" "")
+	if(NOT DEFINED _PC_GEN_TARGET)
+		message(FATAL_ERROR "paraconf_generate_reader: TARGET is required")
+	endif()
+	if(NOT DEFINED _PC_GEN_PREFIX)
+		set(_PC_GEN_PREFIX "${_PC_GEN_TARGET}")
+	endif()
+
+	get_filename_component(_PC_GEN_SCHEMA "${SCHEMA}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+	set(_PC_GEN_DIR "${CMAKE_CURRENT_BINARY_DIR}/${_PC_GEN_TARGET}_reader")
+	set(_PC_GEN_OUTPUTS "${_PC_GEN_DIR}/${_PC_GEN_PREFIX}.h" "${_PC_GEN_DIR}/${_PC_GEN_PREFIX}.c")
+	set(_PC_GEN_FLAGS)
+	if("${_PC_GEN_FORTRAN}")
+		get_property(_PC_GEN_LANGUAGES GLOBAL PROPERTY ENABLED_LANGUAGES)
+		if(NOT "Fortran" IN_LIST _PC_GEN_LANGUAGES)
+			message(FATAL_ERROR "paraconf_generate_reader: the Fortran language must be enabled to use FORTRAN")
+		endif()
+		list(APPEND _PC_GEN_OUTPUTS "${_PC_GEN_DIR}/${_PC_GEN_PREFIX}.f90")
+		list(APPEND _PC_GEN_FLAGS "-f")
+	endif()
+
+	file(MAKE_DIRECTORY "${_PC_GEN_DIR}")
+	add_custom_command(OUTPUT ${_PC_GEN_OUTPUTS}
+		COMMAND "$<TARGET_FILE:paraconf::paraconf_codegen>" ${_PC_GEN_FLAGS} -p "${_PC_GEN_PREFIX}" -o "${_PC_GEN_DIR}" "${_PC_GEN_SCHEMA}"
+		DEPENDS "${_PC_GEN_SCHEMA}" "$<TARGET_FILE:paraconf::paraconf_codegen>"
+		COMMENT "Generating the ${_PC_GEN_PREFIX} reader from ${SCHEMA}"
+		VERBATIM
+	)
+
+	add_library("${_PC_GEN_TARGET}" STATIC ${_PC_GEN_OUTPUTS})
+	target_link_libraries("${_PC_GEN_TARGET}" PUBLIC paraconf::paraconf)
+	target_include_directories("${_PC_GEN_TARGET}" PUBLIC "$<BUILD_INTERFACE:${_PC_GEN_DIR}>")
+	set_target_properties("${_PC_GEN_TARGET}" PROPERTIES
+		C_STANDARD 99
+		C_STANDARD_REQUIRED TRUE
+		POSITION_INDEPENDENT_CODE TRUE
+	)
+	if("${_PC_GEN_FORTRAN}")
+		target_link_libraries("${_PC_GEN_TARGET}" PUBLIC paraconf::paraconf_f90)
+		set_target_properties("${_PC_GEN_TARGET}" PROPERTIES Fortran_MODULE_DIRECTORY "${_PC_GEN_DIR}")
+	endif()
+endfunction()
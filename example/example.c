@@ -57,26 +57,34 @@ int main(int argc, char* argv[])
 		printf("%ld ", a_list_ii);
 	}
 	printf("]\n");
+	// A whole list of numbers can also be read at once, which is much faster for long lists
+	long a_list[a_list_len];
+	PC_int_array(PC_get(conf, ".a_list"), a_list, a_list_len);
 
 	// Sub-tree/node of a tree are accessed using the '{number}' or '<number>' is the 1st element.
+	char* a_map_first;
+	PC_string(PC_get(conf, ".a_map{0}"), &a_map_first);
+	free(a_map_first);
+	// Walking a whole list or map is better done with an iterator, which does not re-resolve the path at each step
 	printf("a_map={   ");
-	int a_map_len;
-	PC_len(PC_get(conf, ".a_map"), &a_map_len);
-	for (int ii = 0; ii < a_list_len; ++ii) {
+	PC_map_iter_t a_map_iter;
+	PC_map_begin(PC_get(conf, ".a_map"), &a_map_iter);
+	while (PC_map_next(&a_map_iter)) {
 		char* a_map_ii_k;
-		PC_string(PC_get(conf, ".a_map{%d}", ii), &a_map_ii_k);
+		PC_string(PC_map_key(&a_map_iter), &a_map_ii_k);
 		long a_map_ii_v;
-		PC_int(PC_get(conf, ".a_map<%d>", ii), &a_map_ii_v);
+		PC_int(PC_map_value(&a_map_iter), &a_map_ii_v);
 		printf("%s => %ld   ", a_map_ii_k, a_map_ii_v);
 		free(a_map_ii_k);
 	}
 	printf("}\n");
 
-	PC_errhandler_t errh = PC_errhandler(PC_NULL_HANDLER);
-	PC_tree_t some_key = PC_get(conf, ".some_key");
-	PC_errhandler(errh);
+	// Optional nodes are probed without going through the error handler
+	printf("config %s `some_key'\n", PC_has(conf, ".some_key") ? "contains" : "does not contain");
 
-	printf("config %s `some_key'\n", PC_status(some_key) ? "does not contain" : "contains");
+	long a_timeout;
+	PC_int_or(conf, ".a_timeout", 60, &a_timeout);
+	printf("a_timeout=%ld\n", a_timeout);
 
 	PC_tree_destroy(&conf);
 
@@ -12,7 +12,9 @@ PROGRAM example
 !   INCLUDE 'paraconf_f90.h'
   
   TYPE(PC_tree_t) :: conf, some_key
-  INTEGER :: a_int, a_list_len, a_map_len, ii
+  TYPE(PC_seq_iter_t) :: a_list_iter
+  TYPE(PC_map_iter_t) :: a_map_iter
+  INTEGER :: a_int
   REAL(8) :: a_float
   CHARACTER(30) :: a_string
   LOGICAL :: a_log
@@ -37,18 +39,18 @@ PROGRAM example
       a_int, a_float, a_string, a_log
 
   print '("a_list=[")'
-  call PC_len(PC_get(conf,".a_list"), a_list_len)
-  do ii = 0, a_list_len-1
-!     call PC_int(PC_get(PC_get(conf,".a_int"), ii), a_int)
+  call PC_seq_begin(PC_get(conf,".a_list"), a_list_iter)
+  do while (PC_seq_next(a_list_iter))
+    call PC_int(PC_seq_value(a_list_iter), a_int)
     print '("  ", I5)', a_int
   enddo
   print '("]")'
 
   print '("a_map={")'
-  call PC_len(PC_get(conf,".a_map"), a_map_len)
-  do ii = 0, a_map_len-1
-!     call PC_int(PC_key(PC_get(conf,".a_int"), ii), a_string)
-!     call PC_int(PC_get(PC_get(conf,".a_int"), ii), a_int)
+  call PC_map_begin(PC_get(conf,".a_map"), a_map_iter)
+  do while (PC_map_next(a_map_iter))
+    call PC_string(PC_map_key(a_map_iter), a_string)
+    call PC_int(PC_map_value(a_map_iter), a_int)
     print '("  ", A30,"=> ", I5)', a_string, a_int
   enddo
   print '("}")'
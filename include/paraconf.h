@@ -38,6 +38,19 @@ typedef enum PC_status_e {
 	PC_SYSTEM_ERROR
 } PC_status_t;
 
+/** Types of nodes
+ */
+typedef enum PC_node_type_e {
+	/// an empty tree or a tree in error
+	PC_NODE_NONE = 0,
+	/// a scalar node
+	PC_NODE_SCALAR,
+	/// a sequence node
+	PC_NODE_SEQUENCE,
+	/// a mapping node
+	PC_NODE_MAPPING
+} PC_node_type_t;
+
 /** Type of a callback function used when an error occurs
  * \param status the error code
  * \param message the human-readable error message
@@ -74,6 +87,160 @@ typedef struct PC_tree_s {
 
 } PC_tree_t;
 
+/** An iterator over the items of a sequence node
+ *
+ * The iterator is initialized by PC_seq_begin, before the first item, and
+ * moved to the next item by PC_seq_next. It refers to the document but does
+ * not own any memory.
+ */
+typedef struct PC_seq_iter_s {
+	/// the sequence
+	PC_tree_t tree;
+
+	/// the index of the current item, -1 before the first one
+	int index;
+
+	/// the number of items in the sequence
+	int len;
+
+} PC_seq_iter_t;
+
+/** An iterator over the key/value pairs of a mapping node
+ *
+ * The iterator is initialized by PC_map_begin, before the first pair, and
+ * moved to the next pair by PC_map_next. It refers to the document but does
+ * not own any memory.
+ */
+typedef struct PC_map_iter_s {
+	/// the mapping
+	PC_tree_t tree;
+
+	/// the index of the current pair, -1 before the first one
+	int index;
+
+	/// the number of pairs in the mapping
+	int len;
+
+} PC_map_iter_t;
+
+/** An opaque type describing a compiled ypath expression
+ */
+typedef struct PC_path_s PC_path_t;
+
+/** The C type of a field filled by PC_extract
+ */
+typedef enum PC_field_type_e {
+	/// an int, filled as with PC_int and checked to fit
+	PC_FIELD_INT,
+	/// a long, filled as with PC_int
+	PC_FIELD_LONG,
+	/// a double, filled as with PC_double
+	PC_FIELD_DOUBLE,
+	/// an int holding a logical value (false=0, true=1), filled as with PC_bool
+	PC_FIELD_BOOL,
+	/// a char* allocated with malloc, filled as with PC_string
+	PC_FIELD_STRING
+} PC_field_type_t;
+
+/// the field may be missing from the tree, its default value is then used
+#define PC_FIELD_OPTIONAL 0x1
+
+/** The description of a field of a C struct filled by PC_extract
+ */
+typedef struct PC_field_s {
+	/// the ypath expression of the value relative to the extracted tree (without argument slots)
+	const char* path;
+
+	/// the C type of the field
+	PC_field_type_t type;
+
+	/// the offset of the field in the struct, as given by offsetof
+	size_t offset;
+
+	/// a combination of PC_FIELD_* flags
+	int flags;
+
+	/// for optional fields, the yaml scalar used when the value is missing,
+	/// NULL to leave the field untouched
+	const char* default_value;
+
+} PC_field_t;
+
+/** The instrumentation counters of a document, as returned by PC_stats
+ *
+ * The event counters are only maintained if paraconf was built with
+ * PARACONF_ENABLE_STATS, they are 0 otherwise. The node counts and memory
+ * figure are always available.
+ */
+typedef struct PC_stats_s {
+	/// whether the event counters are maintained
+	int enabled;
+
+	/// wall time spent parsing the document, in seconds
+	double parse_time;
+
+	/// number of bytes of input parsed
+	size_t bytes_read;
+
+	/// number of nodes in the document
+	size_t nb_nodes;
+
+	/// number of scalar nodes in the document
+	size_t nb_scalars;
+
+	/// number of steps resolved by lookups (PC_get, PC_key, PC_at, ...)
+	unsigned long nb_lookups;
+
+	/// number of keys compared during lookups in mappings
+	unsigned long nb_key_compares;
+
+	/// number of allocations made by paraconf for the document, not counting those of libyaml
+	unsigned long nb_allocs;
+
+	/// number of bytes allocated by paraconf for the document, not counting those of libyaml
+	size_t alloc_bytes;
+
+	/// number of errors raised by functions called on the document
+	unsigned long nb_errors;
+
+	/// approximate memory used by the document (including libyaml structures and cached indices), in bytes
+	size_t memory;
+
+} PC_stats_t;
+
+/** Type of a callback function used to broadcast a buffer from one process to
+ * the others (e.g. a wrapper of MPI_Bcast on MPI_BYTE)
+ * \param buffer the data to send on the root process, to receive elsewhere
+ * \param size the size of the buffer in bytes
+ * \param context a user-provided context
+ * \return the status of the execution
+ */
+typedef PC_status_t (*PC_bcast_f)(void* buffer, size_t size, void* context);
+
+/** The layout of the collections written by PC_emit
+ */
+typedef enum PC_emit_style_e {
+	/// one entry per line, nested collections indented
+	PC_EMIT_BLOCK,
+	/// bracketed, the whole tree on a single line
+	PC_EMIT_FLOW
+} PC_emit_style_t;
+
+/** A file reloaded each time it changes, see PC_watch_open
+ */
+typedef struct PC_watch_s PC_watch_t;
+
+/** Type of a callback function called each time a watched file is reloaded
+ * \param tree the new tree, or a tree in error if the file could not be
+ *             parsed (PC_errmsg then describes the error and the previous
+ *             tree remains in place)
+ * \param keys the top-level keys added, removed or whose value changed,
+ *             valid until the function returns
+ * \param nb_keys the number of keys
+ * \param context a user-provided context
+ */
+typedef void (*PC_watch_f)(PC_tree_t tree, const char* const* keys, int nb_keys, void* context);
+
 /** Prints the error message and aborts
  */
 extern const PARACONF_EXPORT PC_errhandler_t PC_ASSERT_HANDLER;
@@ -92,6 +259,9 @@ static inline PC_status_t PC_status(PC_tree_t tree)
 }
 
 /** Return a human-readabe message describing the last error that occured in paraconf
+ *
+ * When no error handler is installed, the message is only built by this call.
+ * It remains valid until the next error in the same thread.
  *
  * \return a human-readabe message describing the last error that occured in paraconf
  */
@@ -135,6 +305,178 @@ PC_errhandler_t PARACONF_EXPORT PC_errhandler(PC_errhandler_t handler);
  */
 PC_tree_t PARACONF_EXPORT PC_parse_path(const char* path);
 
+/** Returns the tree as found in a file identified by its path, using a binary
+ * cache to skip parsing when the file has already been read
+ *
+ * The cache of the file is keyed by its size, modification time and content
+ * hash. It is loaded without any YAML parsing if it is up to date, otherwise
+ * the file is parsed with PC_parse_path and the cache (re)built. Stale,
+ * corrupted or unwritable caches are silently ignored.
+ *
+ * The tree created must be destroyed with PC_tree_destroy at the end. The
+ * document loaded from a cache is frozen (see PC_tree_freeze).
+ *
+ * \param[in] path the file path as a character string
+ * \param[in] cache_dir the directory where to store caches, if NULL, the
+ *                      PARACONF_CACHE_DIR environment variable is used and if
+ *                      unset, the cache is stored next to the file with a
+ *                      `.pcache` suffix
+ * \return the tree, valid as long as the containing document is
+ */
+PC_tree_t PARACONF_EXPORT PC_parse_path_cached(const char* path, const char* cache_dir);
+
+/** Returns the tree as found in a file identified by its path, parsing each
+ * top-level value only when it is first accessed
+ *
+ * A single fast pass over the file finds the keys of its root mapping, the
+ * value of each key is parsed the first time a lookup or an iteration enters
+ * it. The results are identical to those of PC_parse_path, but syntax errors
+ * in a value are only reported when it is accessed. This speeds up startup and
+ * saves memory when only a few parts of a large file are read.
+ *
+ * Only files whose root is a block mapping with plain keys and that contain no
+ * directive, anchor, alias, nor multi-line flow collection or quoted scalar are
+ * parsed lazily, all others are parsed with PC_parse_path.
+ *
+ * The content of the file is copied in memory when it is opened: values
+ * accessed later are parsed from this copy, so the file can be modified or
+ * removed meanwhile.
+ *
+ * Each value of a lazily parsed document lives in a document of its own:
+ * PC_tree_resolve and PC_tree_freeze only handle the part of the document
+ * their tree belongs to and the root of the document can not be serialized.
+ * Values can be accessed concurrently from multiple threads.
+ *
+ * The tree created must be destroyed with PC_tree_destroy at the end, this
+ * releases all the values parsed as well.
+ *
+ * \param[in] path the file path as a character string
+ * \return the tree, valid as long as the containing document is
+ */
+PC_tree_t PARACONF_EXPORT PC_parse_path_lazy(const char* path);
+
+/** Returns the trees as found in many files identified by their paths, parsed
+ * concurrently
+ *
+ * The files are parsed with PC_parse_path by a pool of threads, the calling
+ * thread included. Each tree carries the status of its own file, the trees in
+ * error have no document. Once all files are parsed, a single error detailing
+ * each file that could not be parsed is reported from the calling thread.
+ *
+ * The trees created must each be destroyed with PC_tree_destroy at the end.
+ *
+ * \param[in] paths the file paths as character strings
+ * \param[in] nb_paths the number of files
+ * \param[in] nb_workers the maximum number of threads to use, 0 or less for
+ *                       one per online core
+ * \param[out] trees the nb_paths trees, in the order of paths
+ * \return the status of the first file that could not be parsed, PC_OK if all could
+ */
+PC_status_t PARACONF_EXPORT PC_parse_paths(const char* const* paths, int nb_paths, int nb_workers, PC_tree_t* trees);
+
+/** Returns the tree as found in a file identified by its path, parsed by
+ * multiple threads
+ *
+ * The file is split before keys of its root mapping found at column 0, outside
+ * of block scalars, quoted scalars and flow collections. The parts are parsed
+ * concurrently by a pool of threads, the calling thread included, then their
+ * nodes are gathered in a single document, identical to the one PC_parse_path
+ * builds.
+ *
+ * Only files whose root is a block mapping starting at column 0 and that
+ * contain neither directives, anchors nor aliases are split. All others, as
+ * well as the files too small to be worth it and the files with errors, are
+ * parsed with PC_parse_path.
+ *
+ * The tree created must be destroyed with PC_tree_destroy at the end.
+ *
+ * \param[in] path the file path as a character string
+ * \param[in] nb_workers the maximum number of threads to use, 0 or less for
+ *                       one per online core
+ * \return the tree, valid as long as the containing document is
+ */
+PC_tree_t PARACONF_EXPORT PC_parse_path_parallel(const char* path, int nb_workers);
+
+/** Returns a tree that layers mappings on top of each other
+ *
+ * Lookups in the overlay see the keys of all layers. The value of a key is
+ * that of the last layer having it, except that mappings found for the same
+ * key in successive layers are merged the same way, recursively. Keys come in
+ * the order they first appear from the first layer on.
+ *
+ * The shadowing is computed once, the overlay only holds the merged mappings
+ * and their keys, nothing is copied from the layers. Lookups that leave the
+ * merged mappings return trees of the layers themselves, at the cost of a
+ * lookup in a single document.
+ *
+ * The layers must not be destroyed nor frozen as long as the overlay is used.
+ * The tree created must be destroyed with PC_tree_destroy at the end, which
+ * leaves the layers untouched.
+ *
+ * \param[in] trees the mappings to layer, lowest priority first (e.g. site
+ *                  defaults, then machine, case and command-line overrides)
+ * \param[in] nb_trees the number of layers
+ * \return the tree at the root of the overlay
+ */
+PC_tree_t PARACONF_EXPORT PC_overlay(const PC_tree_t* trees, int nb_trees);
+
+/** Parses a file and reparses it in the background each time it changes
+ *
+ * Each reload publishes a new tree atomically. Readers get the current one
+ * with PC_watch_acquire, without taking any lock, and release it with
+ * PC_watch_release once done. A tree replaced by a reload remains valid
+ * until released by all the readers that acquired it, after which it is
+ * freed. Trees that fail to parse are not published.
+ *
+ * Changes are noticed with inotify on Linux and by checking the file every
+ * second elsewhere. PC_watch_reload forces a reload.
+ *
+ * The watch must be closed with PC_watch_close at the end.
+ *
+ * \param[in] path the path to the file to watch
+ * \param[in] on_change a function called after each reload from the thread
+ *                      doing it, NULL if none
+ * \param[in] context the context provided to on_change
+ * \param[out] watch the watch of the file
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_watch_open(const char* path, PC_watch_f on_change, void* context, PC_watch_t** watch);
+
+/** Returns the tree currently published by a watch
+ *
+ * This takes no lock and is meant to be called from any thread. The tree is
+ * frozen (see PC_tree_freeze) and must be released with PC_watch_release.
+ *
+ * \param[in] watch the watch of the file
+ * \return the root of the current tree, valid until released
+ */
+PC_tree_t PARACONF_EXPORT PC_watch_acquire(PC_watch_t* watch);
+
+/** Releases a tree acquired with PC_watch_acquire, same as PC_tree_release
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in,out] tree any tree of the document acquired
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_watch_release(PC_tree_t* tree);
+
+/** Reparses a watched file now and publishes it if valid
+ *
+ * \param[in] watch the watch of the file
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_watch_reload(PC_watch_t* watch);
+
+/** Stops watching a file
+ *
+ * The trees still acquired remain valid until released.
+ *
+ * \param[in] watch the watch to close
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_watch_close(PC_watch_t* watch);
+
 /** Returns the tree as found in an already open file
  *
  * This only supports single document files. Use yaml and PC_root to handle
@@ -204,6 +546,232 @@ PC_tree_t PARACONF_EXPORT PC_get(PC_tree_t tree, const char* index_fmt, ...);
  */
 PC_tree_t PARACONF_EXPORT PC_vget(PC_tree_t tree, const char* index_fmt, va_list va);
 
+/** Checks whether a node exists in a yaml document given a ypath index
+ *
+ * Unlike PC_get, a missing node is not an error: nothing is reported to the
+ * error handler and no error message is built, only a syntax error in the
+ * index is reported. Returns 0 if the provided tree is in error.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] index the ypath index
+ * \return whether the node exists
+ */
+int PARACONF_EXPORT PC_has(PC_tree_t tree, const char* index);
+
+/** Compiles a ypath expression for repeated use with PC_cget
+ *
+ * The expression uses the same syntax as PC_get except that instead of
+ * printf-style formats, it can contain argument slots `$0' to `$15':
+ * * in place of an index: e.g. .species[$0].mass, .map{$1} or .map<$1>
+ *   the slot is then provided as an int,
+ * * in place of a whole key: e.g. .boundaries.$0.kind
+ *   the slot is then provided as a null-terminated string.
+ * Slots must be numbered contiguously from $0, a slot can be used multiple
+ * times but always with the same type.
+ *
+ * The compiled expression must be destroyed with PC_path_destroy at the end.
+ *
+ * \param[in] ypath the ypath expression
+ * \param[out] path the compiled expression
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_path_compile(const char* ypath, PC_path_t** path);
+
+/** Destroys a compiled ypath expression
+ *
+ * \param[in] path the compiled expression
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_path_destroy(PC_path_t* path);
+
+/** Looks for a node in a yaml document given a compiled ypath expression
+ *
+ * Does nothing if the provided tree is in error and returns the input tree.
+ *
+ * Contrary to PC_get, this does not format nor parse the expression and does
+ * not allocate memory.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] path the compiled ypath expression
+ * \param[in] ... the values of the argument slots in order: an int for an index
+ *                slot, a const char* for a key slot
+ * \return the subtree corresponding to the ypath expression
+ */
+PC_tree_t PARACONF_EXPORT PC_cget(PC_tree_t tree, const PC_path_t* path, ...);
+
+/** Looks for a node in a yaml document given a compiled ypath expression
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] path the compiled ypath expression
+ * \param[in] va the values of the argument slots
+ * \return the subtree corresponding to the ypath expression
+ */
+PC_tree_t PARACONF_EXPORT PC_cvget(PC_tree_t tree, const PC_path_t* path, va_list va);
+
+/** Looks for a node in a yaml document given a compiled ypath expression
+ * whose argument slots are all indices
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] path the compiled ypath expression
+ * \param[in] indices the values of the argument slots, one per slot
+ * \return the subtree corresponding to the ypath expression
+ */
+PC_tree_t PARACONF_EXPORT PC_cget_idx(PC_tree_t tree, const PC_path_t* path, const int* indices);
+
+/** Looks for a node in a yaml document given a compiled ypath expression
+ * and the values of its argument slots by type
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * The index slots take the values of indices in the order of the slots, the
+ * key slots those of keys. It is an error to provide more or less values than
+ * there are slots of each type.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] path the compiled ypath expression
+ * \param[in] nb_indices the number of indices
+ * \param[in] indices the values of the index slots
+ * \param[in] nb_keys the number of keys
+ * \param[in] keys the values of the key slots, null-terminated strings
+ * \return the subtree corresponding to the ypath expression
+ */
+PC_tree_t PARACONF_EXPORT PC_cget_args(
+	PC_tree_t tree,
+	const PC_path_t* path,
+	int nb_indices,
+	const int* indices,
+	int nb_keys,
+	const char* const* keys
+);
+
+/** Looks for the value associated to a key in a mapping node
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * This is a single step of a ypath expression that is neither formatted nor
+ * parsed, it is meant for generated code or code walking known structures.
+ *
+ * \param[in] tree a mapping node
+ * \param[in] key the key to look for (not necessarily null-terminated)
+ * \param[in] key_len the length of the key
+ * \return the value associated to the key
+ */
+PC_tree_t PARACONF_EXPORT PC_key(PC_tree_t tree, const char* key, size_t key_len);
+
+/** Looks for the value associated to a key that might be missing in a mapping node
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * Contrary to PC_key, a missing key is not an error: an empty tree (whose
+ * node is NULL) is returned instead.
+ *
+ * \param[in] tree a mapping node
+ * \param[in] key the key to look for (not necessarily null-terminated)
+ * \param[in] key_len the length of the key
+ * \return the value associated to the key, an empty tree if there is none
+ */
+PC_tree_t PARACONF_EXPORT PC_key_opt(PC_tree_t tree, const char* key, size_t key_len);
+
+/** Looks for an item of a sequence node
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * This is a single step of a ypath expression that is neither formatted nor
+ * parsed, it is meant for generated code or code walking known structures.
+ *
+ * \param[in] tree a sequence node
+ * \param[in] index the index of the item
+ * \return the item
+ */
+PC_tree_t PARACONF_EXPORT PC_at(PC_tree_t tree, int index);
+
+/** Starts an iteration over the items of a sequence node
+ *
+ * The iterator is positioned before the first item, a typical loop is:
+ * \code
+ * PC_seq_iter_t iter;
+ * PC_seq_begin(tree, &iter);
+ * while (PC_seq_next(&iter)) {
+ *     PC_tree_t item = PC_seq_value(&iter);
+ * }
+ * \endcode
+ *
+ * In case of error, the iteration is empty.
+ *
+ * \param[in] tree a sequence node
+ * \param[out] iter the iterator to initialize
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_seq_begin(PC_tree_t tree, PC_seq_iter_t* iter);
+
+/** Moves a sequence iterator to the next item
+ *
+ * \param[in,out] iter the iterator
+ * \return whether the iterator is on an item, 0 once all items have been visited
+ */
+int PARACONF_EXPORT PC_seq_next(PC_seq_iter_t* iter);
+
+/** Returns the current item of a sequence iterator
+ *
+ * \param[in] iter the iterator, on an item
+ * \return the item
+ */
+PC_tree_t PARACONF_EXPORT PC_seq_value(const PC_seq_iter_t* iter);
+
+/** Starts an iteration over the key/value pairs of a mapping node
+ *
+ * The iterator is positioned before the first pair, a typical loop is:
+ * \code
+ * PC_map_iter_t iter;
+ * PC_map_begin(tree, &iter);
+ * while (PC_map_next(&iter)) {
+ *     PC_tree_t key = PC_map_key(&iter);
+ *     PC_tree_t value = PC_map_value(&iter);
+ * }
+ * \endcode
+ *
+ * In case of error, the iteration is empty.
+ *
+ * \param[in] tree a mapping node
+ * \param[out] iter the iterator to initialize
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_map_begin(PC_tree_t tree, PC_map_iter_t* iter);
+
+/** Moves a mapping iterator to the next pair
+ *
+ * \param[in,out] iter the iterator
+ * \return whether the iterator is on a pair, 0 once all pairs have been visited
+ */
+int PARACONF_EXPORT PC_map_next(PC_map_iter_t* iter);
+
+/** Returns the key of the current pair of a mapping iterator
+ *
+ * \param[in] iter the iterator, on a pair
+ * \return the key
+ */
+PC_tree_t PARACONF_EXPORT PC_map_key(const PC_map_iter_t* iter);
+
+/** Returns the value of the current pair of a mapping iterator
+ *
+ * \param[in] iter the iterator, on a pair
+ * \return the value
+ */
+PC_tree_t PARACONF_EXPORT PC_map_value(const PC_map_iter_t* iter);
+
+/** Returns the type of a node
+ *
+ * Never reports an error.
+ *
+ * \param[in] tree the node
+ * \return the type of the node, PC_NODE_NONE if the tree is empty or in error
+ */
+PC_node_type_t PARACONF_EXPORT PC_type(PC_tree_t tree);
+
 /** Returns the length of a node, for a sequence, the number of nodes, for a mapping, the number of pairs, for a scalar, the string length
  *
  * Does nothing if the provided tree is in error
@@ -244,6 +812,33 @@ PC_status_t PARACONF_EXPORT PC_double(PC_tree_t tree, double* value);
  */
 PC_status_t PARACONF_EXPORT PC_string(PC_tree_t tree, char** value);
 
+/** Returns the string content of a scalar node without copying it
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the node
+ * \param[out] value the null-terminated content of the scalar node, valid as
+ *                   long as the containing document is, must not be modified
+ * \param[out] len the length of the content (excluding the terminating null
+ *                 byte), can be NULL
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_string_view(PC_tree_t tree, const char** value, int* len);
+
+/** Copies the string content of a scalar node in a user-provided buffer
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the node
+ * \param[out] buffer where to copy the null-terminated content of the scalar node
+ * \param[in] size the size of buffer in bytes, an error is returned if the
+ *                 content and its terminating null byte don't fit
+ * \param[out] len the length of the content (excluding the terminating null
+ *                 byte), set even if the buffer is too small, can be NULL
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_string_copy(PC_tree_t tree, char* buffer, int size, int* len);
+
 /** Returns the boolean value of a scalar node
  *
  * Does nothing if the provided tree is in error
@@ -254,10 +849,292 @@ PC_status_t PARACONF_EXPORT PC_string(PC_tree_t tree, char** value);
  */
 PC_status_t PARACONF_EXPORT PC_bool(PC_tree_t tree, int* value);
 
-/** Destroy the tree.
- * All the trees referring to this tree will become unusable
+/** Returns the int value of an optional scalar node
+ *
+ * Unlike PC_get, a missing node is not an error: the default value is
+ * returned without anything being reported to the error handler. A node that
+ * exists but is not a valid integer is still an error.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] index the ypath index of the node
+ * \param[in] default_value the value to return if the node is missing
+ * \param[out] value the int value of the scalar node or default_value
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_int_or(PC_tree_t tree, const char* index, long default_value, long* value);
+
+/** Returns the floating point value of an optional scalar node
+ *
+ * Behaves as PC_int_or for floating point values.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] index the ypath index of the node
+ * \param[in] default_value the value to return if the node is missing
+ * \param[out] value the floating point value of the scalar node or default_value
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_double_or(PC_tree_t tree, const char* index, double default_value, double* value);
+
+/** Returns the boolean value of an optional scalar node
+ *
+ * Behaves as PC_int_or for boolean values.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] index the ypath index of the node
+ * \param[in] default_value the value to return if the node is missing
+ * \param[out] value the logical value (false=0, true=1) of the scalar node or default_value
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_bool_or(PC_tree_t tree, const char* index, int default_value, int* value);
+
+/** Returns the string content of an optional scalar node
+ *
+ * Behaves as PC_int_or for string values.
+ *
+ * \param[in] tree a yaml tree
+ * \param[in] index the ypath index of the node
+ * \param[in] default_value the value to return if the node is missing, can be NULL
+ * \param[out] value the content of the scalar node or a copy of default_value
+ *                   (NULL if default_value is NULL) as a newly allocated string that
+ *                   must be deallocated using free
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_string_or(PC_tree_t tree, const char* index, const char* default_value, char** value);
+
+/** Returns the integer values of all the items of a sequence node
+ *
+ * This is equivalent to calling PC_int on each item, but in a single pass.
+ * All items are converted, those that are invalid are reported in a single
+ * error.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the sequence node
+ * \param[out] values the integer values of the items
+ * \param[in] size the number of items expected in the sequence, the size of values
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_int_array(PC_tree_t tree, long* values, int size);
+
+/** Returns the floating point values of all the items of a sequence node
+ *
+ * This is equivalent to calling PC_double on each item, but in a single pass.
+ * All items are converted, those that are invalid are reported in a single
+ * error.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the sequence node
+ * \param[out] values the floating point values of the items
+ * \param[in] size the number of items expected in the sequence, the size of values
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_double_array(PC_tree_t tree, double* values, int size);
+
+/** Returns the boolean values of all the items of a sequence node
+ *
+ * This is equivalent to calling PC_bool on each item, but in a single pass.
+ * All items are converted, those that are invalid are reported in a single
+ * error.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the sequence node
+ * \param[out] values the logical values (false=0, true=1) of the items
+ * \param[in] size the number of items expected in the sequence, the size of values
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_bool_array(PC_tree_t tree, int* values, int size);
+
+/** Fills the fields of a C struct from a tree according to a table of descriptors
+ *
+ * This is equivalent to calling PC_get followed by the conversion function
+ * matching its type for each field, but the fields are ordered so that the
+ * path steps they have in common are only walked once. All fields are
+ * processed, those that are missing and not optional or that are invalid
+ * are reported in a single error whose status is that of the first field in
+ * error in the table.
+ *
+ * String fields are allocated with malloc and must be released by the caller,
+ * even in case of error. Fields that could not be filled are left untouched.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree the tree to extract the values from
+ * \param[in] fields the description of the fields to fill
+ * \param[in] nb_fields the number of fields
+ * \param[out] data the struct to fill
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_extract(PC_tree_t tree, const PC_field_t* fields, int nb_fields, void* data);
+
+/** Freezes the document containing a tree into a compact immutable form
+ *
+ * All nodes, sequence items, mapping pairs, tags and scalar values are moved
+ * to a single memory block with nodes in depth-first order. This improves
+ * the locality of later accesses, reduces the memory footprint and makes
+ * PC_tree_destroy a single deallocation. The document can be accessed with
+ * the usual functions afterwards.
+ *
+ * Freezing moves the nodes: the provided tree is updated, but all other trees
+ * referring to the document become unusable. Does nothing if the document is
+ * already frozen, fails with PC_INVALID_PARAMETER if more than one reference
+ * is held on it (see PC_tree_retain).
+ *
+ * \param[in,out] tree a tree of the document to freeze, updated to refer to
+ *                     the same node in the frozen document
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_tree_freeze(PC_tree_t* tree);
+
+/** Converts all the scalars of a document once and for all
+ *
+ * The integer, floating point and boolean values of each scalar are computed
+ * and stored along the document. PC_int, PC_double, PC_bool and their array
+ * versions then only check and load the stored value instead of converting
+ * the scalar again, with the exact same results. This is worth it for
+ * documents whose values are read repeatedly. Does nothing if the document
+ * is already resolved.
+ *
+ * \param tree a tree of the document to resolve
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_tree_resolve(PC_tree_t tree);
+
+/** Serializes a document to a compact, position-independent binary buffer
+ *
+ * The buffer contains the whole document the tree belongs to, it remembers
+ * which node the tree refers to. It can only be read back on a machine with
+ * the same byte order. Source positions (marks) are not preserved. The root of
+ * a document parsed with PC_parse_path_lazy can not be serialized.
+ *
+ * \param tree a tree of the document to serialize
+ * \param[out] buffer the serialized document, to release with free
+ * \param[out] size the size of the buffer in bytes
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_serialize(PC_tree_t tree, void** buffer, size_t* size);
+
+/** Rebuilds a document from a buffer created by PC_serialize
+ *
+ * The buffer is fully validated and can be released afterwards. The
+ * resulting document is frozen (see PC_tree_freeze).
+ *
+ * \param buffer the serialized document
+ * \param size the size of the buffer in bytes
+ * \return the tree the document was serialized from, to destroy with PC_tree_destroy
+ */
+PC_tree_t PARACONF_EXPORT PC_deserialize(const void* buffer, size_t size);
+
+/** Shares a document parsed on a single process with all the others
+ *
+ * This is a collective call, the document is serialized on the root process
+ * and sent with calls to the provided broadcast function: one for its size,
+ * then one for each 64 KiB of its content. The other processes rebuild it
+ * without any parsing. When the tree is in error or can not be serialized on
+ * the root process, it sends a size of 0 and the call fails on all processes,
+ * the content is not sent. A process that can not allocate memory for the
+ * document still receives the whole content before failing, so that the
+ * others complete the call.
+ *
+ * \param tree the tree to share on the root process, ignored elsewhere
+ * \param root whether this process is the root of the broadcast
+ * \param bcast the function used to broadcast data
+ * \param context the context provided to bcast
+ * \return tree itself on the root process, a new tree to destroy with
+ *         PC_tree_destroy elsewhere
+ */
+PC_tree_t PARACONF_EXPORT PC_broadcast(PC_tree_t tree, int root, PC_bcast_f bcast, void* context);
+
+/** Writes a tree as a YAML document to a file
+ *
+ * The output is buffered and written one buffer at a time, scalars are quoted
+ * as needed and keep their explicit tags, so that parsing the output gives
+ * back the same tree. Nodes referred to more than once through aliases are
+ * written each time, nodes that contain themselves can not be written. An
+ * empty tree writes nothing.
+ *
+ * \param[in] tree the tree to write, a whole document or any subtree
+ * \param[in] file where to write the tree
+ * \param[in] style the layout of the collections
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_emit(PC_tree_t tree, FILE* file, PC_emit_style_t style);
+
+/** Writes a tree as a YAML document to a newly allocated string
+ *
+ * The output is the same as that of PC_emit.
+ *
+ * \param[in] tree the tree to write, a whole document or any subtree
+ * \param[in] style the layout of the collections
+ * \param[out] string the null-terminated document, to release with free
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_emit_string(PC_tree_t tree, PC_emit_style_t style, char** string);
+
+/** Returns the instrumentation counters of the document containing a tree
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree a tree of the document
+ * \param[out] stats the counters of the document
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_stats(PC_tree_t tree, PC_stats_t* stats);
+
+/** Prints the instrumentation counters of the document containing a tree
+ *
  * Does nothing if the provided tree is in error
  *
+ * \param[in] tree a tree of the document
+ * \param[in] file where to print the counters
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_stats_print(PC_tree_t tree, FILE* file);
+
+/** Takes a new reference on the document containing a tree
+ *
+ * Documents are reference counted, the function creating a document holds
+ * its first reference. The document is freed when its last reference is
+ * released with PC_tree_release or PC_tree_destroy, the trees of a document
+ * remain valid as long as a reference is held on it.
+ *
+ * Any number of threads can concurrently read a document they hold a
+ * reference on, without any synchronization: all the functions that take a
+ * tree without modifying its document are thread-safe, including the lookups,
+ * iterators, typed getters, PC_tree_resolve, PC_stats and the values of
+ * documents parsed by PC_parse_path_lazy. The caches built on demand (mapping
+ * key indices, converted scalars, lazily parsed values) are published
+ * atomically: concurrent first uses may build them more than once, only one
+ * is kept. Errors are reported to the handler of the calling thread. Only
+ * PC_tree_freeze modifies a document, it must not be called once it is shared.
+ *
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in] tree a tree of the document
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_tree_retain(PC_tree_t tree);
+
+/** Releases a reference on the document containing a tree
+ *
+ * The document is freed with its last reference, see PC_tree_retain.
+ * Does nothing if the provided tree is in error
+ *
+ * \param[in,out] tree a tree of the document, reset
+ * \return the status of the execution
+ */
+PC_status_t PARACONF_EXPORT PC_tree_release(PC_tree_t* tree);
+
+/** Destroy the tree.
+ * This releases the reference on the document held by the function that
+ * created it, see PC_tree_release. Once the last reference is released, all
+ * the trees referring to this tree will become unusable. Trees with no
+ * document, such as the trees in error returned by the parse functions, are
+ * left as is.
+ *
  * \param[in,out] tree the node
  * \return the status of the tree
  */
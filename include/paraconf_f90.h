@@ -57,6 +57,23 @@ interface
   end function PC_get
   
   
+  subroutine PC_path_compile(ypath, path, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    character(len = *), intent(IN) :: ypath
+    type(PC_path_t), intent(OUT) :: path
+    integer, intent(OUT), optional :: status
+  end subroutine PC_path_compile
+  
+  
+  subroutine PC_path_destroy(path, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_path_t), intent(INOUT) :: path
+    integer, intent(OUT), optional :: status
+  end subroutine PC_path_destroy
+  
+  
   subroutine PC_int(tree_in, value, status)
     use ISO_C_binding
     include 'paraconf_f90_types.h'
@@ -93,6 +110,102 @@ interface
   end subroutine PC_log
   
   
+  subroutine PC_int_array(tree_in, values, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    integer, intent(OUT) :: values(:)
+    integer, intent(OUT), optional :: status
+  end subroutine PC_int_array
+  
+  
+  subroutine PC_double_array(tree_in, values, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    real(8), intent(OUT) :: values(:)
+    integer, intent(OUT), optional :: status
+  end subroutine PC_double_array
+  
+  
+  subroutine PC_log_array(tree_in, values, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    logical, intent(OUT) :: values(:)
+    integer, intent(OUT), optional :: status
+  end subroutine PC_log_array
+  
+  
+  subroutine PC_seq_begin(tree_in, iter, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    type(PC_seq_iter_t), intent(OUT) :: iter
+    integer, intent(OUT), optional :: status
+  end subroutine PC_seq_begin
+  
+  
+  logical function PC_seq_next(iter)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_seq_iter_t), intent(INOUT) :: iter
+  end function PC_seq_next
+  
+  
+  type(PC_tree_t) function PC_seq_value(iter)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_seq_iter_t), intent(IN) :: iter
+  end function PC_seq_value
+  
+  
+  subroutine PC_map_begin(tree_in, iter, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    type(PC_map_iter_t), intent(OUT) :: iter
+    integer, intent(OUT), optional :: status
+  end subroutine PC_map_begin
+  
+  
+  logical function PC_map_next(iter)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t), intent(INOUT) :: iter
+  end function PC_map_next
+  
+  
+  type(PC_tree_t) function PC_map_key(iter)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t), intent(IN) :: iter
+  end function PC_map_key
+  
+  
+  type(PC_tree_t) function PC_map_value(iter)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t), intent(IN) :: iter
+  end function PC_map_value
+  
+  
+  subroutine PC_tree_retain(tree_in, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree_in
+    integer, intent(OUT), optional :: status
+  end subroutine PC_tree_retain
+  
+  
+  subroutine PC_tree_release(tree_in, status)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(INOUT), target :: tree_in
+    integer, intent(OUT), optional :: status
+  end subroutine PC_tree_release
+  
+  
   subroutine PC_tree_destroy(tree_in, status)
     use ISO_C_binding
     include 'paraconf_f90_types.h'
@@ -103,4 +216,27 @@ interface
 end interface
 
 
+interface PC_cget
+
+  type(PC_tree_t) function PC_cget(tree, path, indices)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree
+    type(PC_path_t), intent(IN) :: path
+    integer, intent(IN), optional :: indices(:)
+  end function PC_cget
+  
+  
+  type(PC_tree_t) function PC_cget_keys(tree, path, keys, indices)
+    use ISO_C_binding
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree
+    type(PC_path_t), intent(IN) :: path
+    character(len = *), intent(IN) :: keys(:)
+    integer, intent(IN), optional :: indices(:)
+  end function PC_cget_keys
+
+end interface
+
+
 include 'paraconf_f90_consts.h'
@@ -14,3 +14,22 @@ type, bind(C) :: PC_errhandler_t
   type(C_funptr) :: func
   type(C_ptr) :: context
 end type PC_errhandler_t
+
+
+type, bind(C) :: PC_path_t
+  type(C_ptr) :: ptr
+end type PC_path_t
+
+
+type, bind(C) :: PC_seq_iter_t
+  type(PC_tree_t) :: tree
+  integer(C_int) :: index
+  integer(C_int) :: len
+end type PC_seq_iter_t
+
+
+type, bind(C) :: PC_map_iter_t
+  type(PC_tree_t) :: tree
+  integer(C_int) :: index
+  integer(C_int) :: len
+end type PC_map_iter_t
@@ -8,17 +8,29 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "paraconf.h"
 
+#include "keyindex.h"
+#include "lazy.h"
+#include "native.h"
+#include "overlay.h"
+#include "scalar.h"
+#include "stats.h"
 #include "status.h"
 #include "ypath.h"
 
 #define PC_BUFFER_SIZE 256
 #define ERRBUF_SIZE 512
+/// number of invalid items detailed in the error message of array conversions
+#define PC_ARRAY_ERRORS 4
 
 static const char* nodetype[4] = {"none", "scalar", "sequence", "mapping"};
 
@@ -34,8 +46,9 @@ static inline void pc_set_path(PC_tree_t tree, const char* path)
 	pc_path_free(tree.pcdoc->path);
 	size_t pathlen = strlen(path);
 	char* pathcpy = malloc((pathlen + 1) * sizeof(char));
-	strncpy(pathcpy, path, pathlen);
+	memcpy(pathcpy, path, pathlen + 1);
 	tree.pcdoc->path = pathcpy;
+	PC_STATS_ALLOC(tree.pcdoc, pathlen + 1);
 }
 
 uint64_t PC_version()
@@ -43,30 +56,157 @@ uint64_t PC_version()
 	return PARACONF_VERSION;
 }
 
+/** A backend loading documents held in memory
+ */
+typedef struct parser_backend_s {
+	/// the name of the backend, as given to the PARACONF_PARSER environment variable
+	const char* name;
+
+	/** Loads a document
+	 *
+	 * \param data the document to load
+	 * \param size the size of the document in bytes
+	 * \param[out] document the document loaded
+	 * \return whether the document was loaded, if not, the next backend is tried
+	 */
+	int (*load)(const unsigned char* data, size_t size, yaml_document_t* document);
+} parser_backend_t;
+
+/// the backends tried in order before libyaml, that loads all other documents and reports their errors
+static const parser_backend_t parser_backends[] = {
+	{"native", pc_native_load},
+};
+
+int pc_backend_load(const unsigned char* data, size_t size, yaml_document_t* document)
+{
+	const char* selected = getenv("PARACONF_PARSER");
+	for (size_t idx = 0; idx < sizeof(parser_backends) / sizeof(parser_backends[0]); ++idx) {
+		if (selected && strcmp(selected, parser_backends[idx].name)) continue;
+		if (parser_backends[idx].load(data, size, document)) return 1;
+	}
+	return 0;
+}
+
+/** Loads the document from a parser whose input is set, errors are reported
+ * the way PC_parse_file does
+ *
+ * \param conf_parser the parser to load from
+ * \return the tree at the root of the document
+ */
+static PC_tree_t load_file_document(yaml_parser_t* conf_parser)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+
+	PC_STATS_START(start);
+	yaml_document_t conf_doc;
+	if (!yaml_parser_load(conf_parser, &conf_doc)) {
+		if (conf_parser->context) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_INVALID_FORMAT,
+					"%lu:%lu: Error: %s \n%lu:%lu: Error: %s",
+					(unsigned long)conf_parser->problem_mark.line,
+					(unsigned long)conf_parser->problem_mark.column,
+					conf_parser->problem,
+					(unsigned long)conf_parser->context_mark.line,
+					(unsigned long)conf_parser->context_mark.column,
+					conf_parser->context
+				),
+				err0
+			);
+		} else {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_INVALID_FORMAT,
+					"%lu:%lu: Error: %s",
+					(unsigned long)conf_parser->problem_mark.line,
+					(unsigned long)conf_parser->problem_mark.column,
+					conf_parser->problem
+				),
+				err0
+			);
+		}
+	}
+
+	restree = PC_root(&conf_doc);
+	PC_STATS_PARSED(restree.pcdoc, start, conf_parser->offset);
+
+	return restree;
+
+err0:
+	return restree;
+}
+
+/** Parses a regular file by mapping it in memory
+ *
+ * \param fd the file descriptor of the file
+ * \param size the size of the file
+ * \param[out] restree the parsed tree
+ * \return whether the file could be mapped, if not, nothing was parsed
+ */
+static int parse_mapped(int fd, size_t size, PC_tree_t* restree)
+{
+	void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED) return 0;
+	posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+	PC_STATS_START(start);
+	yaml_document_t conf_doc;
+	yaml_parser_t conf_parser;
+	if (pc_backend_load(data, size, &conf_doc)) {
+		*restree = PC_root(&conf_doc);
+		if (!PC_status(*restree)) PC_STATS_PARSED(restree->pcdoc, start, size);
+	} else if (!yaml_parser_initialize(&conf_parser)) {
+		restree->status = PC_make_err(PC_SYSTEM_ERROR, "unable to load yaml library");
+	} else {
+		yaml_parser_set_input_string(&conf_parser, data, size);
+		*restree = load_file_document(&conf_parser);
+		yaml_parser_delete(&conf_parser);
+	}
+
+	munmap(data, size);
+	return 1;
+}
+
 PC_tree_t PC_parse_path(const char* path)
 {
 	PC_tree_t restree = {PC_OK, NULL, NULL};
+	PC_STATS_START(start);
 
-	FILE* conf_file = fopen(path, "rb");
-	if (!conf_file) {
+	int conf_fd = open(path, O_RDONLY);
+	if (conf_fd < 0) {
 		char errbuf[ERRBUF_SIZE];
 		strerror_r(errno, errbuf, ERRBUF_SIZE);
-		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, errbuf), err0);
+		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "%s", errbuf), err0);
 	}
 
 	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER); // aka PC_try
-	restree = PC_parse_file(conf_file);
+	// regular files are mapped in memory, pipes, special files & co. go through stdio
+	struct stat conf_stat;
+	if (fstat(conf_fd, &conf_stat) || !S_ISREG(conf_stat.st_mode) || conf_stat.st_size <= 0
+	    || !parse_mapped(conf_fd, conf_stat.st_size, &restree))
+	{
+		FILE* conf_file = fdopen(conf_fd, "rb");
+		if (conf_file) {
+			restree = PC_parse_file(conf_file);
+			fclose(conf_file);
+			conf_fd = -1;
+		} else {
+			char errbuf[ERRBUF_SIZE];
+			strerror_r(errno, errbuf, ERRBUF_SIZE);
+			restree.status = PC_make_err(PC_SYSTEM_ERROR, "%s", errbuf);
+		}
+	}
 	PC_errhandler(handler);
+	if (conf_fd >= 0) close(conf_fd);
 	if (PC_status(restree)) { // aka PC_catch
-		PC_handle_err_tree(PC_make_err(restree.status, "can not parse file `%s`\n%s", path, PC_errmsg()), err1);
+		PC_handle_err_tree(PC_make_err(restree.status, "can not parse file `%s`\n%s", path, PC_errmsg()), err0);
 	}
 
-	fclose(conf_file);
 	pc_set_path(restree, path);
+	PC_STATS_SET(restree.pcdoc, parse_time, pc_stats_elapsed(&start)); // including opening & mapping the file
 	return restree;
 
-err1:
-	fclose(conf_file);
 err0:
 	return restree;
 }
@@ -75,19 +215,24 @@ PC_tree_t PC_parse_string(const char* document)
 {
 	PC_tree_t restree = {PC_OK, NULL, NULL};
 
+	PC_STATS_START(start);
+	size_t size = strlen(document);
+	yaml_document_t conf_doc;
+	if (pc_backend_load((const unsigned char*)document, size, &conf_doc)) {
+		restree = PC_root(&conf_doc);
+		PC_handle_tree(err0);
+		PC_STATS_PARSED(restree.pcdoc, start, size);
+		return restree;
+	}
+
 	yaml_parser_t conf_parser;
 	if (!yaml_parser_initialize(&conf_parser)) {
 		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to load yaml library"), err0);
 	}
 
-	yaml_parser_set_input_string(&conf_parser, (const unsigned char*)document, strlen(document));
+	yaml_parser_set_input_string(&conf_parser, (const unsigned char*)document, size);
 
-	yaml_document_t* conf_doc = malloc(sizeof(yaml_document_t));
-	if (!conf_doc) {
-		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
-	}
-
-	if (!yaml_parser_load(&conf_parser, conf_doc)) {
+	if (!yaml_parser_load(&conf_parser, &conf_doc)) {
 		if (conf_parser.context) {
 			PC_handle_err_tree(
 				PC_make_err(
@@ -116,9 +261,10 @@ PC_tree_t PC_parse_string(const char* document)
 		}
 	}
 
-	yaml_parser_delete(&conf_parser);
+	restree = PC_root(&conf_doc);
+	PC_STATS_PARSED(restree.pcdoc, start, conf_parser.offset);
 
-	restree = PC_root(conf_doc);
+	yaml_parser_delete(&conf_parser);
 
 	PC_handle_tree(err0);
 
@@ -140,51 +286,12 @@ PC_tree_t PC_parse_file(FILE* conf_file)
 
 	yaml_parser_set_input_file(&conf_parser, conf_file);
 
-	yaml_document_t* conf_doc = malloc(sizeof(yaml_document_t));
-	if (!conf_doc) {
-		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
-	}
-
-	if (!yaml_parser_load(&conf_parser, conf_doc)) {
-		if (conf_parser.context) {
-			PC_handle_err_tree(
-				PC_make_err(
-					PC_INVALID_FORMAT,
-					"%lu:%lu: Error: %s \n%lu:%lu: Error: %s",
-					(unsigned long)conf_parser.problem_mark.line,
-					(unsigned long)conf_parser.problem_mark.column,
-					conf_parser.problem,
-					(unsigned long)conf_parser.context_mark.line,
-					(unsigned long)conf_parser.context_mark.column,
-					conf_parser.context
-				),
-				err1
-			);
-		} else {
-			PC_handle_err_tree(
-				PC_make_err(
-					PC_INVALID_FORMAT,
-					"%lu:%lu: Error: %s",
-					(unsigned long)conf_parser.problem_mark.line,
-					(unsigned long)conf_parser.problem_mark.column,
-					conf_parser.problem
-				),
-				err1
-			);
-		}
-	}
+	restree = load_file_document(&conf_parser);
 
 	yaml_parser_delete(&conf_parser);
 
-	restree = PC_root(conf_doc);
-
-	PC_handle_tree(err0);
-
-
-
 	return restree;
-err1:
-	yaml_parser_delete(&conf_parser);
+
 err0:
 	return restree;
 }
@@ -192,8 +299,11 @@ err0:
 PC_tree_t PC_root(yaml_document_t* document)
 {
 	PC_tree_t restree = {PC_OK, malloc(sizeof(PC_document_t)), yaml_document_get_root_node(document)};
-	PC_document_t pcdoc = {*document, PC_NO_PATH};
-	*restree.pcdoc = pcdoc;
+	memset(restree.pcdoc, 0, sizeof(PC_document_t));
+	restree.pcdoc->document = *document;
+	restree.pcdoc->path = PC_NO_PATH;
+	restree.pcdoc->refs = 1;
+	PC_STATS_ALLOC(restree.pcdoc, sizeof(PC_document_t));
 	return restree;
 }
 
@@ -235,6 +345,27 @@ err0:
 	return restree;
 }
 
+int PC_has(const PC_tree_t tree, const char* index)
+{
+	PC_tree_t restree = pc_sget_quiet(tree, index);
+	return !PC_status(restree) && restree.node;
+}
+
+PC_node_type_t PC_type(const PC_tree_t tree)
+{
+	if (PC_status(tree) || !tree.node) return PC_NODE_NONE;
+	switch (tree.node->type) {
+	case YAML_SCALAR_NODE:
+		return PC_NODE_SCALAR;
+	case YAML_SEQUENCE_NODE:
+		return PC_NODE_SEQUENCE;
+	case YAML_MAPPING_NODE:
+		return PC_NODE_MAPPING;
+	default:
+		return PC_NODE_NONE;
+	}
+}
+
 PC_status_t PC_len(const PC_tree_t tree, int* res)
 {
 	PC_status_t status = PC_OK;
@@ -263,6 +394,7 @@ PC_status_t PC_len(const PC_tree_t tree, int* res)
 	return status;
 
 err0:
+	PC_STATS_ERROR(tree, status);
 	return status;
 }
 
@@ -280,20 +412,24 @@ PC_status_t PC_int(const PC_tree_t tree, long* res)
 		return PC_make_err(PC_INVALID_NODE_TYPE, "Expected a scalar, found %s\n", nodetype[tree.node->type]);
 	}
 
-	char* endptr;
-	long result = strtol((char*)tree.node->data.scalar.value, &endptr, 0);
-	if (*endptr) {
-		char* content;
-		PC_handle_err(PC_string(tree, &content), err0);
-		status = PC_make_err(PC_INVALID_NODE_TYPE, "Expected integer, found `%s'\n", content);
-		free(content);
-		PC_handle_err(status, err0);
+	long result;
+	if (!pc_scalar_long(tree.pcdoc, tree.node, &result)) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_NODE_TYPE,
+				"Expected integer, found `%.*s'\n",
+				(int)tree.node->data.scalar.length,
+				(char*)tree.node->data.scalar.value
+			),
+			err0
+		);
 	}
 
 	*res = result;
 	return status;
 
 err0:
+	PC_STATS_ERROR(tree, status);
 	return status;
 }
 
@@ -310,23 +446,44 @@ PC_status_t PC_double(const PC_tree_t tree, double* value)
 	if (tree.node->type != YAML_SCALAR_NODE) {
 		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a scalar, found %s\n", nodetype[tree.node->type]), err0);
 	}
-	char* endptr;
-	*value = strtod((char*)tree.node->data.scalar.value, &endptr);
-	if (*endptr) {
-		char* content = NULL;
-		PC_handle_err(PC_string(tree, &content), err0);
-		status = PC_make_err(PC_INVALID_PARAMETER, "Expected floating point, found `%s'\n", content);
-		free(content);
-		PC_handle_err(status, err0);
+	if (!pc_scalar_double(tree.pcdoc, tree.node, value)) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_PARAMETER,
+				"Expected floating point, found `%.*s'\n",
+				(int)tree.node->data.scalar.length,
+				(char*)tree.node->data.scalar.value
+			),
+			err0
+		);
 	}
 
 	return status;
 
 err0:
+	PC_STATS_ERROR(tree, status);
 	return status;
 }
 
 PC_status_t PC_string(const PC_tree_t tree, char** value)
+{
+	PC_status_t status = PC_OK;
+
+	const char* view;
+	int len = 0;
+	PC_handle_err(PC_string_view(tree, &view, &len), err0);
+
+	*value = malloc(len + 1);
+	memcpy(*value, view, len + 1);
+	assert((*value)[len] == 0);
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_string_view(const PC_tree_t tree, const char** value, int* len)
 {
 	PC_status_t status = PC_OK;
 	PC_handle_tree_err(tree, err0);
@@ -340,12 +497,39 @@ PC_status_t PC_string(const PC_tree_t tree, char** value)
 		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a scalar, found %s\n", nodetype[tree.node->type]), err0);
 	}
 
-	int len = 0;
-	PC_handle_err(PC_len(tree, &len), err0);
+	*value = (const char*)tree.node->data.scalar.value;
+	if (len) *len = tree.node->data.scalar.length;
 
-	*value = malloc(len + 1);
-	strncpy(*value, (char*)tree.node->data.scalar.value, len + 1);
-	assert((*value)[len] == 0);
+	return status;
+
+err0:
+	PC_STATS_ERROR(tree, status);
+	return status;
+}
+
+PC_status_t PC_string_copy(const PC_tree_t tree, char* buffer, int size, int* len)
+{
+	PC_status_t status = PC_OK;
+
+	const char* view;
+	int view_len = 0;
+	PC_handle_err(PC_string_view(tree, &view, &view_len), err0);
+	if (len) *len = view_len;
+
+	if (view_len >= size) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_PARAMETER,
+				"Buffer of %d bytes too small for `%.*s' (%d bytes including the terminating null byte)\n",
+				size,
+				view_len,
+				view,
+				view_len + 1
+			),
+			err0
+		);
+	}
+	memcpy(buffer, view, view_len + 1);
 
 	return status;
 
@@ -367,25 +551,250 @@ PC_status_t PC_bool(const PC_tree_t tree, int* res)
 		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a scalar, found %s\n", nodetype[tree.node->type]), err0);
 	}
 
-	char* value = (char*)tree.node->data.scalar.value;
+	if (!pc_scalar_bool(tree.pcdoc, tree.node, res)) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_PARAMETER,
+				"Expected logical expression, found `%.*s'\n",
+				(int)tree.node->data.scalar.length,
+				(char*)tree.node->data.scalar.value
+			),
+			err0
+		);
+	}
 
-	if (!strcmp(value, "True") || !strcmp(value, "true") || !strcmp(value, "TRUE") || !strcmp(value, "Yes") || !strcmp(value, "yes")
-	    || !strcmp(value, "YES"))
-	{
-		*res = 1;
-	} else if (!strcmp(value, "False") || !strcmp(value, "false") || !strcmp(value, "FALSE") || !strcmp(value, "No") || !strcmp(value, "no")
-	           || !strcmp(value, "NO"))
-	{
-		*res = 0;
-	} else {
-		char* content = NULL;
-		PC_handle_err(PC_string(tree, &content), err0);
-		status = PC_make_err(PC_INVALID_PARAMETER, "Expected logical expression, found `%s'\n", content);
-		free(content);
-		PC_handle_err(status, err0);
+	return status;
+
+err0:
+	PC_STATS_ERROR(tree, status);
+	return status;
+}
+
+/** Looks for an optional node without reporting it missing
+ *
+ * \param tree the tree to walk from
+ * \param index the ypath index of the node
+ * \param[out] node the node found, an empty tree if it is missing
+ * \return the status of the execution
+ */
+static PC_status_t get_optional(const PC_tree_t tree, const char* index, PC_tree_t* node)
+{
+	*node = pc_sget_quiet(tree, index);
+	if (!PC_status(tree) && PC_status(*node) == PC_NODE_NOT_FOUND) {
+		node->status = PC_OK;
+		node->node = NULL;
+	}
+	return PC_status(*node);
+}
+
+PC_status_t PC_int_or(const PC_tree_t tree, const char* index, long default_value, long* value)
+{
+	PC_status_t status = PC_OK;
+
+	PC_tree_t node;
+	PC_handle_err(get_optional(tree, index, &node), err0);
+	if (!node.node) {
+		*value = default_value;
+		return status;
+	}
+	PC_handle_err(PC_int(node, value), err0);
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_double_or(const PC_tree_t tree, const char* index, double default_value, double* value)
+{
+	PC_status_t status = PC_OK;
+
+	PC_tree_t node;
+	PC_handle_err(get_optional(tree, index, &node), err0);
+	if (!node.node) {
+		*value = default_value;
+		return status;
+	}
+	PC_handle_err(PC_double(node, value), err0);
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_bool_or(const PC_tree_t tree, const char* index, int default_value, int* value)
+{
+	PC_status_t status = PC_OK;
+
+	PC_tree_t node;
+	PC_handle_err(get_optional(tree, index, &node), err0);
+	if (!node.node) {
+		*value = default_value;
+		return status;
+	}
+	PC_handle_err(PC_bool(node, value), err0);
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_string_or(const PC_tree_t tree, const char* index, const char* default_value, char** value)
+{
+	PC_status_t status = PC_OK;
+
+	PC_tree_t node;
+	PC_handle_err(get_optional(tree, index, &node), err0);
+	if (!node.node) {
+		*value = NULL;
+		if (!default_value) return status;
+		size_t len = strlen(default_value);
+		*value = malloc(len + 1);
+		if (!*value) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+		memcpy(*value, default_value, len + 1);
+		return status;
+	}
+	PC_handle_err(PC_string(node, value), err0);
+
+	return status;
+
+err0:
+	return status;
+}
+
+/** Converts the items of a sequence to an array
+ *
+ * All items are converted, invalid ones are reported together in a single
+ * error. This is inlined with a constant converter in each caller to get a
+ * tight loop.
+ *
+ * \param tree the sequence
+ * \param[out] values the converted values
+ * \param value_size the size of a value in bytes
+ * \param size the expected number of items
+ * \param convert the scalar converter, returns whether the conversion succeeded
+ * \param expected a description of the expected values for error messages
+ * \return the status of the execution
+ */
+static inline PC_status_t
+seq_array(const PC_tree_t tree, void* values, size_t value_size, int size, int (*convert)(PC_document_t*, const yaml_node_t*, void*), const char* expected)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	// check type
+	if (!tree.node) {
+		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected node, found empty tree\n"), err0);
+	}
+
+	if (tree.node->type != YAML_SEQUENCE_NODE) {
+		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a sequence, found %s\n", nodetype[tree.node->type]), err0);
 	}
 
+	int len = tree.node->data.sequence.items.top - tree.node->data.sequence.items.start;
+	if (len != size) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Expected a sequence of %d %s, found %d items\n", size, expected, len), err0);
+	}
+
+	// the errors of the first few invalid items are detailed
+	char errbuf[ERRBUF_SIZE];
+	int errlen = 0;
+	int nb_invalid = 0;
+	yaml_node_t* nodes = tree.pcdoc->document.nodes.start;
+	char* value = values;
+	for (int idx = 0; idx < len; ++idx, value += value_size) {
+		yaml_node_t* item = nodes + tree.node->data.sequence.items.start[idx] - 1;
+		if (item->type == YAML_SCALAR_NODE && convert(tree.pcdoc, item, value)) continue;
+		if (nb_invalid++ >= PC_ARRAY_ERRORS || errlen >= ERRBUF_SIZE) continue;
+		if (item->type == YAML_SCALAR_NODE) {
+			errlen += snprintf(
+				errbuf + errlen,
+				ERRBUF_SIZE - errlen,
+				"\n  [%d]: `%.*s'",
+				idx,
+				(int)item->data.scalar.length,
+				(char*)item->data.scalar.value
+			);
+		} else {
+			errlen += snprintf(errbuf + errlen, ERRBUF_SIZE - errlen, "\n  [%d]: %s", idx, nodetype[item->type]);
+		}
+	}
+	if (nb_invalid) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_PARAMETER,
+				"Expected a sequence of %s, found %d invalid items out of %d:%s%s\n",
+				expected,
+				nb_invalid,
+				len,
+				errlen ? errbuf : "",
+				nb_invalid > PC_ARRAY_ERRORS ? "\n  ..." : ""
+			),
+			err0
+		);
+	}
+
+	return status;
+
+err0:
+	PC_STATS_ERROR(tree, status);
+	return status;
+}
+
+static int convert_long(PC_document_t* doc, const yaml_node_t* node, void* value)
+{
+	return pc_scalar_long(doc, node, value);
+}
+
+static int convert_double(PC_document_t* doc, const yaml_node_t* node, void* value)
+{
+	return pc_scalar_double(doc, node, value);
+}
+
+static int convert_bool(PC_document_t* doc, const yaml_node_t* node, void* value)
+{
+	return pc_scalar_bool(doc, node, value);
+}
+
+PC_status_t PC_int_array(const PC_tree_t tree, long* values, int size)
+{
+	return seq_array(tree, values, sizeof(long), size, convert_long, "integers");
+}
+
+PC_status_t PC_double_array(const PC_tree_t tree, double* values, int size)
+{
+	return seq_array(tree, values, sizeof(double), size, convert_double, "floating points");
+}
+
+PC_status_t PC_bool_array(const PC_tree_t tree, int* values, int size)
+{
+	return seq_array(tree, values, sizeof(int), size, convert_bool, "logical expressions");
+}
+
+PC_status_t PC_tree_retain(PC_tree_t tree)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	PC_document_t* doc = tree.pcdoc;
+	while (doc->parent)
+		doc = doc->parent;
+	__atomic_fetch_add(&doc->refs, 1, __ATOMIC_RELAXED);
+
+err0:
 	return status;
+}
+
+PC_status_t PC_tree_release(PC_tree_t* tree)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err((*tree), err0);
+
+	PC_tree_destroy(tree);
 
 err0:
 	return status;
@@ -393,11 +802,28 @@ err0:
 
 PC_status_t PC_tree_destroy(PC_tree_t* tree)
 {
-	yaml_document_delete(&tree->pcdoc->document);
-	pc_path_free(tree->pcdoc->path);
-	tree->pcdoc->path = NULL;
-	free(tree->pcdoc);
+	// trees in error returned by the parse functions have no document
+	if (!tree->pcdoc) return tree->status;
+
+	// the values of a lazily parsed document are owned by the document
+	PC_document_t* doc = tree->pcdoc;
+	while (doc->parent)
+		doc = doc->parent;
 	tree->pcdoc = NULL;
 	tree->node = NULL;
+	// the document is only freed with its last reference
+	if (__atomic_sub_fetch(&doc->refs, 1, __ATOMIC_ACQ_REL)) return tree->status;
+
+	pc_lazy_destroy(doc);
+	pc_overlay_destroy(doc);
+	pc_keyindex_destroy(doc);
+	pc_scalars_destroy(doc);
+	if (doc->arena) {
+		free(doc->arena);
+	} else {
+		yaml_document_delete(&doc->document);
+	}
+	pc_path_free(doc->path);
+	free(doc);
 	return tree->status;
 }
@@ -0,0 +1,251 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "arena.h"
+#include "keyindex.h"
+#include "scalar.h"
+#include "status.h"
+#include "ypath.h"
+
+/// number of distinct tags remembered when deduplicating tags in the string pool
+#define TAG_CACHE_SIZE 8
+
+PC_status_t pc_arena_alloc(pc_arena_t* arena, size_t nb_nodes, size_t nb_items, size_t nb_pairs, size_t strings_size)
+{
+	PC_status_t status = PC_OK;
+
+	if (nb_nodes > SIZE_MAX / 4 / sizeof(yaml_node_t) || nb_pairs > SIZE_MAX / 4 / sizeof(yaml_node_pair_t)
+	    || nb_items > SIZE_MAX / 4 / sizeof(yaml_node_item_t) || strings_size >= SIZE_MAX / 4)
+	{
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory for a document this large"), err0);
+	}
+	size_t nodes_size = nb_nodes * sizeof(yaml_node_t);
+	size_t pairs_size = nb_pairs * sizeof(yaml_node_pair_t);
+	size_t items_size = nb_items * sizeof(yaml_node_item_t);
+	// each part is less than a quarter of the address space, their sum can not overflow
+	arena->size = nodes_size + pairs_size + items_size + strings_size + 1;
+	arena->block = malloc(arena->size);
+	if (!arena->block) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	arena->nodes = arena->block;
+	arena->pairs = (yaml_node_pair_t*)((char*)arena->nodes + nodes_size);
+	arena->items = (yaml_node_item_t*)((char*)arena->pairs + pairs_size);
+	arena->strings = (char*)arena->items + items_size;
+
+	return status;
+
+err0:
+	return status;
+}
+
+void pc_arena_document(yaml_document_t* document, const pc_arena_t* arena, size_t nb_nodes)
+{
+	memset(document, 0, sizeof(yaml_document_t));
+	document->nodes.start = arena->nodes;
+	document->nodes.end = arena->nodes + nb_nodes;
+	document->nodes.top = arena->nodes + nb_nodes;
+	document->start_implicit = 1;
+	document->end_implicit = 1;
+}
+
+/** Computes the depth-first order of the nodes of a document
+ *
+ * \param document the document
+ * \param[out] order the old (1-based) id of each node in DFS order
+ * \param[out] new_id the new (1-based) id of each node indexed by its old id
+ * \return the status of the execution
+ */
+static PC_status_t dfs_order(yaml_document_t* document, int* order, int* new_id)
+{
+	PC_status_t status = PC_OK;
+
+	int nb_nodes = document->nodes.top - document->nodes.start;
+	size_t stack_size = 1;
+	for (yaml_node_t* node = document->nodes.start; node != document->nodes.top; ++node) {
+		if (node->type == YAML_SEQUENCE_NODE) stack_size += node->data.sequence.items.top - node->data.sequence.items.start;
+		if (node->type == YAML_MAPPING_NODE) stack_size += 2 * (node->data.mapping.pairs.top - node->data.mapping.pairs.start);
+	}
+	int* stack = malloc(stack_size * sizeof(int));
+	if (!stack) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+
+	int nb_ordered = 0;
+	for (int start_id = 1; start_id <= nb_nodes; ++start_id) {
+		// the root comes first, then any node not reachable from it
+		if (new_id[start_id]) continue;
+		size_t stack_top = 0;
+		stack[stack_top++] = start_id;
+		while (stack_top) {
+			int id = stack[--stack_top];
+			if (new_id[id]) continue;
+			order[nb_ordered++] = id;
+			new_id[id] = nb_ordered;
+			yaml_node_t* node = yaml_document_get_node(document, id);
+			if (node->type == YAML_SEQUENCE_NODE) {
+				for (yaml_node_item_t* item = node->data.sequence.items.top; item != node->data.sequence.items.start;) {
+					--item;
+					if (!new_id[*item]) stack[stack_top++] = *item;
+				}
+			} else if (node->type == YAML_MAPPING_NODE) {
+				for (yaml_node_pair_t* pair = node->data.mapping.pairs.top; pair != node->data.mapping.pairs.start;) {
+					--pair;
+					if (!new_id[pair->value]) stack[stack_top++] = pair->value;
+					if (!new_id[pair->key]) stack[stack_top++] = pair->key;
+				}
+			}
+		}
+	}
+
+	free(stack);
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_tree_freeze(PC_tree_t* tree)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err((*tree), err0);
+
+	PC_document_t* pcdoc = tree->pcdoc;
+	if (pcdoc->arena) return status; // already frozen
+	if (pcdoc->overlay) return status; // only refers to its layers, never modified
+	// the values of a lazily parsed document are shared with the references of the document
+	PC_document_t* owner = pcdoc;
+	while (owner->parent)
+		owner = owner->parent;
+	unsigned long refs = __atomic_load_n(&owner->refs, __ATOMIC_ACQUIRE);
+	if (refs > 1) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Unable to freeze a document shared by %lu references\n", refs), err0);
+	}
+
+	yaml_document_t* document = &pcdoc->document;
+	int nb_nodes = document->nodes.top - document->nodes.start;
+
+	int* order = malloc((nb_nodes + 1) * sizeof(int));
+	int* new_id = calloc(nb_nodes + 1, sizeof(int));
+	size_t* tag_offset = malloc((nb_nodes + 1) * sizeof(size_t));
+	if (!order || !new_id || !tag_offset) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
+	}
+	PC_handle_err(dfs_order(document, order, new_id), err1);
+
+	// measure the arena & deduplicate tags
+	size_t nb_items = 0, nb_pairs = 0, strings_size = 0;
+	const char* tag_cache[TAG_CACHE_SIZE];
+	size_t tag_cache_offset[TAG_CACHE_SIZE];
+	int tag_cache_len = 0;
+	for (int idx = 0; idx < nb_nodes; ++idx) {
+		yaml_node_t* node = yaml_document_get_node(document, order[idx]);
+		switch (node->type) {
+		case YAML_SCALAR_NODE:
+			strings_size += node->data.scalar.length + 1;
+			break;
+		case YAML_SEQUENCE_NODE:
+			nb_items += node->data.sequence.items.top - node->data.sequence.items.start;
+			break;
+		case YAML_MAPPING_NODE:
+			nb_pairs += node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+			break;
+		default:
+			break;
+		}
+		if (!node->tag) continue;
+		int cached = 0;
+		while (cached < tag_cache_len && strcmp(tag_cache[cached], (char*)node->tag))
+			++cached;
+		if (cached == tag_cache_len) {
+			cached = tag_cache_len < TAG_CACHE_SIZE ? tag_cache_len++ : idx % TAG_CACHE_SIZE;
+			tag_cache[cached] = (char*)node->tag;
+			tag_cache_offset[cached] = strings_size;
+			strings_size += strlen((char*)node->tag) + 1;
+		}
+		tag_offset[order[idx]] = tag_cache_offset[cached];
+	}
+
+	pc_arena_t arena;
+	PC_handle_err(pc_arena_alloc(&arena, nb_nodes, nb_items, nb_pairs, strings_size), err1);
+
+	// fill the arena in DFS order
+	yaml_node_item_t* items = arena.items;
+	yaml_node_pair_t* pairs = arena.pairs;
+	char* strings = arena.strings;
+	for (int idx = 0; idx < nb_nodes; ++idx) {
+		yaml_node_t* node = yaml_document_get_node(document, order[idx]);
+		yaml_node_t* frozen = arena.nodes + idx;
+		*frozen = *node;
+		switch (node->type) {
+		case YAML_SCALAR_NODE:
+			frozen->data.scalar.value = (yaml_char_t*)strings;
+			memcpy(strings, node->data.scalar.value, node->data.scalar.length);
+			strings[node->data.scalar.length] = 0;
+			strings += node->data.scalar.length + 1;
+			break;
+		case YAML_SEQUENCE_NODE:
+			frozen->data.sequence.items.start = items;
+			for (yaml_node_item_t* item = node->data.sequence.items.start; item != node->data.sequence.items.top; ++item) {
+				*items++ = new_id[*item];
+			}
+			frozen->data.sequence.items.end = items;
+			frozen->data.sequence.items.top = items;
+			break;
+		case YAML_MAPPING_NODE:
+			frozen->data.mapping.pairs.start = pairs;
+			for (yaml_node_pair_t* pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; ++pair) {
+				pairs->key = new_id[pair->key];
+				pairs->value = new_id[pair->value];
+				++pairs;
+			}
+			frozen->data.mapping.pairs.end = pairs;
+			frozen->data.mapping.pairs.top = pairs;
+			break;
+		default:
+			break;
+		}
+		// tags are stored on first use, after the scalar value of their node
+		if (node->tag) {
+			frozen->tag = (yaml_char_t*)arena.strings + tag_offset[order[idx]];
+			if ((char*)frozen->tag == strings) strings += strlen((char*)node->tag) + 1;
+			memcpy(frozen->tag, node->tag, strlen((char*)node->tag) + 1);
+		}
+	}
+
+	yaml_document_t frozen_document;
+	pc_arena_document(&frozen_document, &arena, nb_nodes);
+	frozen_document.start_implicit = document->start_implicit;
+	frozen_document.end_implicit = document->end_implicit;
+	frozen_document.start_mark = document->start_mark;
+	frozen_document.end_mark = document->end_mark;
+
+	int tree_id = tree->node ? tree->node - document->nodes.start + 1 : 0;
+
+	// indices & pre-converted values refer to the former node ids
+	int resolved = pcdoc->scalars != NULL;
+	pc_keyindex_destroy(pcdoc);
+	pc_scalars_destroy(pcdoc);
+	yaml_document_delete(document);
+	pcdoc->document = frozen_document;
+	pcdoc->arena = arena.block;
+	PC_STATS_ALLOC(pcdoc, arena.size);
+	if (tree_id) tree->node = arena.nodes + new_id[tree_id] - 1;
+	if (resolved) PC_handle_err(PC_tree_resolve(*tree), err1);
+
+err1:
+	free(tag_offset);
+	free(new_id);
+	free(order);
+err0:
+	return status;
+}
@@ -0,0 +1,62 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ARENA_H__
+#define ARENA_H__
+
+#include <stddef.h>
+
+#include "paraconf.h"
+
+/** The content of a single-allocation document arena
+ *
+ * Nodes, sequence items, mapping pairs and strings (scalar values and tags)
+ * are stored in that order in a single memory block.
+ */
+typedef struct pc_arena_s {
+	/// the memory block, to release with free
+	void* block;
+
+	/// the size of the memory block in bytes
+	size_t size;
+
+	/// the nodes
+	yaml_node_t* nodes;
+
+	/// the items of all sequences, those of each sequence are contiguous
+	yaml_node_item_t* items;
+
+	/// the pairs of all mappings, those of each mapping are contiguous
+	yaml_node_pair_t* pairs;
+
+	/// the string pool
+	char* strings;
+
+} pc_arena_t;
+
+/** Allocates an arena
+ *
+ * \param[out] arena the arena to allocate
+ * \param nb_nodes the number of nodes
+ * \param nb_items the total number of sequence items
+ * \param nb_pairs the total number of mapping pairs
+ * \param strings_size the size of the string pool in bytes
+ * \return the status of the execution
+ */
+PC_status_t pc_arena_alloc(pc_arena_t* arena, size_t nb_nodes, size_t nb_items, size_t nb_pairs, size_t strings_size);
+
+/** Makes a yaml document refer to the nodes of an arena
+ *
+ * The document doesn't own the memory, it must not be deleted with
+ * yaml_document_delete but the arena block freed instead.
+ *
+ * \param[out] document the document to initialize
+ * \param arena the arena
+ * \param nb_nodes the number of nodes in the arena
+ */
+void pc_arena_document(yaml_document_t* document, const pc_arena_t* arena, size_t nb_nodes);
+
+#endif // ARENA_H__
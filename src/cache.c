@@ -0,0 +1,260 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "paraconf.h"
+
+#include "status.h"
+#include "ypath.h"
+
+/* A cache file is made of a header followed by a document serialized with
+ * PC_serialize. The cache is a pure optimization: any problem reading or
+ * writing it falls back to parsing the YAML file and is never reported.
+ */
+
+#define PC_CACHE_MAGIC "PCCACHE\1"
+
+#define PC_CACHE_SUFFIX ".pcache"
+
+typedef struct cache_header_s {
+	char magic[8];
+	/// size of the YAML file the cache was built from
+	uint64_t source_size;
+	/// modification time of the YAML file the cache was built from
+	int64_t source_mtime_sec;
+	int64_t source_mtime_nsec;
+	/// hash of the content of the YAML file the cache was built from
+	uint64_t source_hash;
+	/// size of the serialized document that follows the header
+	uint64_t blob_size;
+	/// hash of the serialized document, to detect corrupted caches
+	uint64_t blob_hash;
+} cache_header_t;
+
+/** Hashes a buffer
+ *
+ * This is a non-cryptographic word-at-a-time hash, fast enough that hashing
+ * the YAML file stays negligible compared to parsing it.
+ */
+static uint64_t content_hash(const void* data, size_t size)
+{
+	const unsigned char* bytes = data;
+	uint64_t hash = 0x9E3779B97F4A7C15ULL ^ size;
+	size_t pos = 0;
+	for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, bytes + pos, sizeof(uint64_t));
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 32;
+	}
+	uint64_t tail = 0;
+	memcpy(&tail, bytes + pos, size - pos);
+	hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ULL;
+	return hash ^ (hash >> 29);
+}
+
+/** Hashes the content of a file
+ *
+ * \param path the path of the file
+ * \param size the expected size of the file
+ * \param[out] hash the hash of the content
+ * \return whether the file could be read
+ */
+static int file_hash(const char* path, size_t size, uint64_t* hash)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return 0;
+	void* data = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close(fd);
+	if (data == MAP_FAILED) return 0;
+	posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+	*hash = content_hash(data, size);
+	if (size) munmap(data, size);
+	return 1;
+}
+
+/** Builds the path of the cache of a YAML file
+ *
+ * \param path the path of the YAML file
+ * \param cache_dir the directory of the cache, NULL for a file next to the YAML one
+ * \return the path of the cache, to release with free, NULL on error
+ */
+static char* cache_path(const char* path, const char* cache_dir)
+{
+	if (!cache_dir) {
+		char* result = malloc(strlen(path) + sizeof(PC_CACHE_SUFFIX));
+		if (result) sprintf(result, "%s" PC_CACHE_SUFFIX, path);
+		return result;
+	}
+
+	// caches of distinct files share the directory, they are named after the absolute path
+	char* absolute_path = realpath(path, NULL);
+	if (!absolute_path) return NULL;
+	uint64_t path_hash = content_hash(absolute_path, strlen(absolute_path));
+	free(absolute_path);
+	char* result = malloc(strlen(cache_dir) + 18 + sizeof(PC_CACHE_SUFFIX));
+	if (result) sprintf(result, "%s/%016" PRIx64 PC_CACHE_SUFFIX, cache_dir, path_hash);
+	return result;
+}
+
+/** Writes a cache file atomically
+ *
+ * The cache is written to a temporary file then renamed, so concurrent
+ * readers see either the former or the new cache, never a partial one.
+ *
+ * \param path the path of the cache
+ * \param header the header of the cache
+ * \param blob the serialized document
+ */
+static void cache_write(const char* path, const cache_header_t* header, const void* blob)
+{
+	char* tmp_path = malloc(strlen(path) + 8);
+	if (!tmp_path) return;
+	sprintf(tmp_path, "%s.XXXXXX", path);
+	int fd = mkstemp(tmp_path);
+	if (fd < 0) {
+		free(tmp_path);
+		return;
+	}
+	int ok = write(fd, header, sizeof(cache_header_t)) == (ssize_t)sizeof(cache_header_t);
+	for (size_t written = 0; ok && written < header->blob_size;) {
+		ssize_t chunk = write(fd, (const char*)blob + written, header->blob_size - written);
+		ok = chunk > 0;
+		if (ok) written += chunk;
+	}
+	ok = !fchmod(fd, 0644) && ok;
+	ok = !close(fd) && ok;
+	if (!ok || rename(tmp_path, path)) unlink(tmp_path);
+	free(tmp_path);
+}
+
+/** Loads a document from its cache
+ *
+ * \param path the path of the YAML file
+ * \param source_stat the status of the YAML file
+ * \param cache the path of the cache
+ * \return the cached document, in error if the cache is missing, stale or corrupted
+ */
+static PC_tree_t cache_load(const char* path, const struct stat* source_stat, const char* cache)
+{
+	PC_tree_t restree = {PC_INVALID_PARAMETER, NULL, NULL};
+
+	int fd = open(cache, O_RDONLY);
+	if (fd < 0) return restree;
+	struct stat cache_stat;
+	void* data = MAP_FAILED;
+	if (!fstat(fd, &cache_stat) && cache_stat.st_size >= (off_t)sizeof(cache_header_t)) {
+		data = mmap(NULL, cache_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+	if (data == MAP_FAILED) return restree;
+
+	cache_header_t header;
+	memcpy(&header, data, sizeof(header));
+	const void* blob = (const char*)data + sizeof(header);
+	if (memcmp(header.magic, PC_CACHE_MAGIC, sizeof(header.magic)) || header.source_size != (uint64_t)source_stat->st_size
+	    || header.blob_size != (uint64_t)cache_stat.st_size - sizeof(header) || header.blob_hash != content_hash(blob, header.blob_size))
+	{
+		goto err0;
+	}
+
+	if (header.source_mtime_sec != source_stat->st_mtim.tv_sec || header.source_mtime_nsec != source_stat->st_mtim.tv_nsec) {
+		// the file was touched, the cache is still valid if the content did not change
+		uint64_t source_hash;
+		if (!file_hash(path, source_stat->st_size, &source_hash) || source_hash != header.source_hash) goto err0;
+		header.source_mtime_sec = source_stat->st_mtim.tv_sec;
+		header.source_mtime_nsec = source_stat->st_mtim.tv_nsec;
+		cache_write(cache, &header, blob);
+	}
+
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER); // aka PC_try
+	restree = PC_deserialize(blob, header.blob_size);
+	PC_errhandler(handler);
+	if (!PC_status(restree)) {
+		// deserialized documents always own their path
+		char* path_copy = strdup(path);
+		if (path_copy) {
+			free((void*)restree.pcdoc->path);
+			restree.pcdoc->path = path_copy;
+		}
+	}
+
+err0:
+	munmap(data, cache_stat.st_size);
+	return restree;
+}
+
+/** Builds the cache of a YAML file from its parsed document
+ *
+ * \param path the path of the YAML file
+ * \param source_stat the status of the YAML file before it was parsed
+ * \param cache the path of the cache
+ * \param tree the parsed document
+ */
+static void cache_store(const char* path, const struct stat* source_stat, const char* cache, PC_tree_t tree)
+{
+	cache_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PC_CACHE_MAGIC, sizeof(header.magic));
+	header.source_size = source_stat->st_size;
+	header.source_mtime_sec = source_stat->st_mtim.tv_sec;
+	header.source_mtime_nsec = source_stat->st_mtim.tv_nsec;
+	if (!file_hash(path, source_stat->st_size, &header.source_hash)) return;
+
+	// the file must not have changed while being parsed & hashed
+	struct stat after_stat;
+	if (stat(path, &after_stat) || after_stat.st_size != source_stat->st_size || after_stat.st_mtim.tv_sec != source_stat->st_mtim.tv_sec
+	    || after_stat.st_mtim.tv_nsec != source_stat->st_mtim.tv_nsec)
+	{
+		return;
+	}
+
+	void* blob;
+	size_t blob_size;
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER); // aka PC_try
+	PC_status_t status = PC_serialize(tree, &blob, &blob_size);
+	PC_errhandler(handler);
+	if (status) return;
+	header.blob_size = blob_size;
+	header.blob_hash = content_hash(blob, blob_size);
+	cache_write(cache, &header, blob);
+	free(blob);
+}
+
+PC_tree_t PC_parse_path_cached(const char* path, const char* cache_dir)
+{
+	if (!cache_dir) cache_dir = getenv("PARACONF_CACHE_DIR");
+	if (cache_dir && !*cache_dir) cache_dir = NULL;
+
+	// only regular files can be cached
+	struct stat source_stat;
+	if (stat(path, &source_stat) || !S_ISREG(source_stat.st_mode)) return PC_parse_path(path);
+	char* cache = cache_path(path, cache_dir);
+	if (!cache) return PC_parse_path(path);
+
+	PC_tree_t restree = cache_load(path, &source_stat, cache);
+	if (PC_status(restree)) {
+		restree = PC_parse_path(path);
+		if (!PC_status(restree)) {
+			if (cache_dir) mkdir(cache_dir, 0755);
+			cache_store(path, &source_stat, cache, restree);
+		}
+	}
+
+	free(cache);
+	return restree;
+}
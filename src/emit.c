@@ -0,0 +1,255 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "status.h"
+#include "ypath.h"
+
+/* Trees are written by libyaml's emitter, fed with the events of a walk of the
+ * tree. The emitter handles the quoting of scalars and keeps its output in a
+ * buffer it hands over to the writer when full, so that large trees are
+ * streamed with one write per buffer.
+ */
+
+/// initial capacity of the string written by PC_emit_string
+#define PC_EMIT_STRING_SIZE 4096
+
+/** The state of the walk of a tree
+ */
+typedef struct emit_state_s {
+	/// the emitter fed with the events of the tree
+	yaml_emitter_t emitter;
+	/// the style of the collections
+	PC_emit_style_t style;
+	/// the collections being written, from the root, to detect recursive ones
+	const yaml_node_t** stack;
+	/// the number of collections being written
+	int depth;
+	/// the capacity of stack
+	int max_depth;
+} emit_state_t;
+
+/** A string being written
+ */
+typedef struct emit_string_s {
+	char* data;
+	size_t size;
+	size_t capacity;
+} emit_string_t;
+
+/** Writes a buffer of the emitter to a file
+ */
+static int write_file(void* data, unsigned char* buffer, size_t size)
+{
+	return fwrite(buffer, 1, size, data) == size;
+}
+
+/** Appends a buffer of the emitter to a string
+ */
+static int write_string(void* data, unsigned char* buffer, size_t size)
+{
+	emit_string_t* string = data;
+	if (string->size + size + 1 > string->capacity) {
+		size_t capacity = string->capacity ? string->capacity : PC_EMIT_STRING_SIZE;
+		while (string->size + size + 1 > capacity)
+			capacity *= 2;
+		char* new_data = realloc(string->data, capacity);
+		if (!new_data) return 0;
+		string->data = new_data;
+		string->capacity = capacity;
+	}
+	memcpy(string->data + string->size, buffer, size);
+	string->size += size;
+	return 1;
+}
+
+/** Reports the error of the emitter
+ *
+ * \param emitter the emitter in error
+ * \return the status of the error
+ */
+static PC_status_t emitter_err(const yaml_emitter_t* emitter)
+{
+	switch (emitter->error) {
+	case YAML_MEMORY_ERROR:
+		return PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory");
+	case YAML_WRITER_ERROR:
+		return PC_make_err(PC_SYSTEM_ERROR, "Unable to write the YAML output\n");
+	default:
+		return PC_make_err(PC_INVALID_FORMAT, "Unable to emit YAML: %s\n", emitter->problem ? emitter->problem : "unknown error");
+	}
+}
+
+/** Returns whether a tag is the one a node of its type gets when it has none
+ */
+static int implicit_tag(const yaml_node_t* node, const char* default_tag)
+{
+	return !node->tag || !strcmp((const char*)node->tag, default_tag);
+}
+
+/** Emits the events of a tree
+ *
+ * \param state the state of the walk
+ * \param tree the tree to emit
+ * \return the status of the execution
+ */
+static PC_status_t emit_tree(emit_state_t* state, PC_tree_t tree)
+{
+	PC_status_t status = PC_OK;
+	const yaml_node_t* node = tree.node;
+	yaml_event_t event;
+
+	if (node->type == YAML_SCALAR_NODE) {
+		int implicit = implicit_tag(node, YAML_DEFAULT_SCALAR_TAG);
+		if (!yaml_scalar_event_initialize(
+				&event,
+				NULL,
+				implicit ? NULL : node->tag,
+				node->data.scalar.value,
+				node->data.scalar.length,
+				implicit,
+				implicit,
+				node->data.scalar.style
+			)
+			|| !yaml_emitter_emit(&state->emitter, &event))
+		{
+			PC_handle_err(emitter_err(&state->emitter), err0);
+		}
+		return status;
+	}
+
+	for (int level = 0; level < state->depth; ++level) {
+		if (state->stack[level] == node) {
+			PC_handle_err(PC_make_err(PC_INVALID_FORMAT, "Unable to emit a node that contains itself\n"), err0);
+		}
+	}
+	if (state->depth == state->max_depth) {
+		int max_depth = state->max_depth ? 2 * state->max_depth : 16;
+		const yaml_node_t** stack = realloc(state->stack, max_depth * sizeof(const yaml_node_t*));
+		if (!stack) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+		state->stack = stack;
+		state->max_depth = max_depth;
+	}
+	state->stack[state->depth++] = node;
+
+	if (node->type == YAML_SEQUENCE_NODE) {
+		int implicit = implicit_tag(node, YAML_DEFAULT_SEQUENCE_TAG);
+		yaml_sequence_style_t style = state->style == PC_EMIT_FLOW ? YAML_FLOW_SEQUENCE_STYLE : YAML_BLOCK_SEQUENCE_STYLE;
+		if (!yaml_sequence_start_event_initialize(&event, NULL, implicit ? NULL : node->tag, implicit, style)
+			|| !yaml_emitter_emit(&state->emitter, &event))
+		{
+			PC_handle_err(emitter_err(&state->emitter), err1);
+		}
+		for (yaml_node_item_t* item = node->data.sequence.items.start; item < node->data.sequence.items.top; ++item) {
+			PC_tree_t item_tree = tree;
+			item_tree.node = yaml_document_get_node(&tree.pcdoc->document, *item);
+			PC_handle_err(emit_tree(state, item_tree), err1);
+		}
+		if (!yaml_sequence_end_event_initialize(&event) || !yaml_emitter_emit(&state->emitter, &event)) {
+			PC_handle_err(emitter_err(&state->emitter), err1);
+		}
+	} else {
+		int implicit = implicit_tag(node, YAML_DEFAULT_MAPPING_TAG);
+		yaml_mapping_style_t style = state->style == PC_EMIT_FLOW ? YAML_FLOW_MAPPING_STYLE : YAML_BLOCK_MAPPING_STYLE;
+		if (!yaml_mapping_start_event_initialize(&event, NULL, implicit ? NULL : node->tag, implicit, style)
+			|| !yaml_emitter_emit(&state->emitter, &event))
+		{
+			PC_handle_err(emitter_err(&state->emitter), err1);
+		}
+		for (yaml_node_pair_t* pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; ++pair) {
+			PC_tree_t key = tree;
+			key.node = yaml_document_get_node(&tree.pcdoc->document, pair->key);
+			PC_handle_err(emit_tree(state, key), err1);
+			// the values of overlays & lazily parsed documents are found elsewhere
+			PC_tree_t value = pc_pair_value(tree, pair);
+			PC_handle_tree_err(value, err1);
+			PC_handle_err(emit_tree(state, value), err1);
+		}
+		if (!yaml_mapping_end_event_initialize(&event) || !yaml_emitter_emit(&state->emitter, &event)) {
+			PC_handle_err(emitter_err(&state->emitter), err1);
+		}
+	}
+
+err1:
+	--state->depth;
+err0:
+	return status;
+}
+
+/** Emits a tree as a single YAML document
+ *
+ * \param tree the tree to emit
+ * \param style the style of the collections
+ * \param handler the writer of the output
+ * \param data the context of handler
+ * \return the status of the execution
+ */
+static PC_status_t emit(PC_tree_t tree, PC_emit_style_t style, yaml_write_handler_t* handler, void* data)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+	if (!tree.node) return status; // an empty document has no content
+
+	emit_state_t state = {.style = style};
+	if (!yaml_emitter_initialize(&state.emitter)) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	yaml_emitter_set_output(&state.emitter, handler, data);
+	yaml_emitter_set_unicode(&state.emitter, 1);
+	yaml_emitter_set_width(&state.emitter, -1);
+
+	yaml_event_t event;
+	if (!yaml_stream_start_event_initialize(&event, YAML_UTF8_ENCODING) || !yaml_emitter_emit(&state.emitter, &event)
+		|| !yaml_document_start_event_initialize(&event, NULL, NULL, NULL, 1) || !yaml_emitter_emit(&state.emitter, &event))
+	{
+		PC_handle_err(emitter_err(&state.emitter), err1);
+	}
+	PC_handle_err(emit_tree(&state, tree), err1);
+	if (!yaml_document_end_event_initialize(&event, 1) || !yaml_emitter_emit(&state.emitter, &event)
+		|| !yaml_stream_end_event_initialize(&event) || !yaml_emitter_emit(&state.emitter, &event))
+	{
+		PC_handle_err(emitter_err(&state.emitter), err1);
+	}
+
+err1:
+	free(state.stack);
+	yaml_emitter_delete(&state.emitter);
+err0:
+	return status;
+}
+
+PC_status_t PC_emit(PC_tree_t tree, FILE* file, PC_emit_style_t style)
+{
+	return emit(tree, style, write_file, file);
+}
+
+PC_status_t PC_emit_string(PC_tree_t tree, PC_emit_style_t style, char** string)
+{
+	PC_status_t status = PC_OK;
+
+	emit_string_t output = {NULL, 0, 0};
+	PC_handle_err(emit(tree, style, write_string, &output), err0);
+	if (!output.data) {
+		output.data = malloc(1);
+		if (!output.data) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+	}
+	output.data[output.size] = '\0';
+	*string = output.data;
+	return status;
+
+err0:
+	free(output.data);
+	return status;
+}
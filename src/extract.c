@@ -0,0 +1,296 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "scalar.h"
+#include "status.h"
+#include "ypath.h"
+
+/** A field to extract along with its compiled path
+ */
+typedef struct entry_s {
+	/// the compiled path of the field, NULL if it could not be compiled
+	PC_path_t* path;
+
+	/// the field description
+	const PC_field_t* field;
+
+} entry_t;
+
+/** The detailed errors of an extraction
+ */
+typedef struct report_s {
+	/// the status of the error of the first field in the table
+	PC_status_t status;
+
+	/// the index in the table of the first field in error
+	ptrdiff_t first_field;
+
+	/// the number of errors
+	int nb_errors;
+
+	/// the details of all errors, NULL if none
+	char* buffer;
+
+	/// the length of the details
+	size_t len;
+
+} report_t;
+
+/** Orders entries by path so that those sharing steps are next to each other,
+ * invalid paths come first
+ */
+static int entry_compare(const void* entry1, const void* entry2)
+{
+	const PC_path_t* path1 = ((const entry_t*)entry1)->path;
+	const PC_path_t* path2 = ((const entry_t*)entry2)->path;
+	if (!path1 || !path2) return !!path1 - !!path2;
+	return pc_path_compare(path1, path2, NULL);
+}
+
+/** Records the error of a field in the report
+ *
+ * \param report the report to update
+ * \param fields the fields table
+ * \param field the field in error
+ * \param status the status of the error
+ * \param message the error message
+ */
+static void report_add(report_t* report, const PC_field_t* fields, const PC_field_t* field, PC_status_t status, const char* message)
+{
+	if (!report->nb_errors++ || field - fields < report->first_field) {
+		report->status = status;
+		report->first_field = field - fields;
+	}
+	size_t msg_len = strlen(message);
+	while (msg_len && message[msg_len - 1] == '\n')
+		--msg_len;
+	size_t add_len = strlen(field->path) + msg_len + 8;
+	char* buffer = realloc(report->buffer, report->len + add_len + 1);
+	if (!buffer) return; // keep the details already recorded
+	report->buffer = buffer;
+	report->len += snprintf(report->buffer + report->len, add_len + 1, "\n  `%s': %.*s", field->path, (int)msg_len, message);
+}
+
+/** Stores a value in a field
+ *
+ * \param field the field description
+ * \param value the node holding the value
+ * \param data the struct to fill
+ * \return the status of the execution
+ */
+static PC_status_t store_node(const PC_field_t* field, PC_tree_t value, char* data)
+{
+	PC_status_t status = PC_OK;
+
+	switch (field->type) {
+	case PC_FIELD_INT: {
+		long int_value;
+		PC_handle_err(PC_int(value, &int_value), err0);
+		if (int_value < INT_MIN || int_value > INT_MAX) {
+			PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Integer %ld does not fit in an int\n", int_value), err0);
+		}
+		int field_value = int_value;
+		memcpy(data + field->offset, &field_value, sizeof(int));
+	} break;
+	case PC_FIELD_LONG: {
+		long field_value;
+		PC_handle_err(PC_int(value, &field_value), err0);
+		memcpy(data + field->offset, &field_value, sizeof(long));
+	} break;
+	case PC_FIELD_DOUBLE: {
+		double field_value;
+		PC_handle_err(PC_double(value, &field_value), err0);
+		memcpy(data + field->offset, &field_value, sizeof(double));
+	} break;
+	case PC_FIELD_BOOL: {
+		int field_value;
+		PC_handle_err(PC_bool(value, &field_value), err0);
+		memcpy(data + field->offset, &field_value, sizeof(int));
+	} break;
+	case PC_FIELD_STRING: {
+		char* field_value;
+		PC_handle_err(PC_string(value, &field_value), err0);
+		memcpy(data + field->offset, &field_value, sizeof(char*));
+	} break;
+	default:
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Invalid field type: %d\n", (int)field->type), err0);
+	}
+
+	return status;
+
+err0:
+	return status;
+}
+
+/** Stores the default value of an optional field
+ *
+ * \param field the field description
+ * \param data the struct to fill
+ * \return the status of the execution
+ */
+static PC_status_t store_default(const PC_field_t* field, char* data)
+{
+	PC_status_t status = PC_OK;
+
+	// the default value is converted as a plain scalar node
+	yaml_node_t node;
+	memset(&node, 0, sizeof(node));
+	node.type = YAML_SCALAR_NODE;
+	node.data.scalar.value = (yaml_char_t*)field->default_value;
+	node.data.scalar.length = strlen(field->default_value);
+	node.data.scalar.style = YAML_PLAIN_SCALAR_STYLE;
+
+	int valid = 0;
+	switch (field->type) {
+	case PC_FIELD_INT: {
+		long int_value;
+		valid = scalar_long(&node, &int_value) && int_value >= INT_MIN && int_value <= INT_MAX;
+		int field_value = int_value;
+		if (valid) memcpy(data + field->offset, &field_value, sizeof(int));
+	} break;
+	case PC_FIELD_LONG: {
+		long field_value;
+		valid = scalar_long(&node, &field_value);
+		if (valid) memcpy(data + field->offset, &field_value, sizeof(long));
+	} break;
+	case PC_FIELD_DOUBLE: {
+		double field_value;
+		valid = scalar_double(&node, &field_value);
+		if (valid) memcpy(data + field->offset, &field_value, sizeof(double));
+	} break;
+	case PC_FIELD_BOOL: {
+		int field_value;
+		valid = scalar_bool(&node, &field_value);
+		if (valid) memcpy(data + field->offset, &field_value, sizeof(int));
+	} break;
+	case PC_FIELD_STRING: {
+		char* field_value = malloc(node.data.scalar.length + 1);
+		if (!field_value) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+		memcpy(field_value, field->default_value, node.data.scalar.length + 1);
+		memcpy(data + field->offset, &field_value, sizeof(char*));
+		valid = 1;
+	} break;
+	default:
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Invalid field type: %d\n", (int)field->type), err0);
+	}
+	if (!valid) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Invalid default value: `%s'\n", field->default_value), err0);
+	}
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_extract(const PC_tree_t tree, const PC_field_t* fields, int nb_fields, void* data)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	if (nb_fields <= 0) return status;
+
+	entry_t* entries = malloc(nb_fields * sizeof(entry_t));
+	if (!entries) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+
+	report_t report = {PC_OK, 0, 0, NULL, 0};
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+
+	int max_len = 0;
+	for (int field_idx = 0; field_idx < nb_fields; ++field_idx) {
+		entry_t* entry = &entries[field_idx];
+		entry->field = &fields[field_idx];
+		entry->path = NULL;
+		PC_status_t field_status = PC_path_compile(entry->field->path, &entry->path);
+		if (!field_status && pc_path_nb_slots(entry->path)) {
+			PC_path_destroy(entry->path);
+			entry->path = NULL;
+			field_status = PC_make_err(PC_INVALID_PARAMETER, "Argument slots are not supported in field paths\n");
+		}
+		if (field_status) {
+			report_add(&report, fields, entry->field, field_status, PC_errmsg());
+			continue;
+		}
+		if (pc_path_length(entry->path) > max_len) max_len = pc_path_length(entry->path);
+	}
+
+	// the nodes reached by each step of the previous path, nodes[0] is the root
+	PC_tree_t* nodes = malloc((max_len + 1) * sizeof(PC_tree_t));
+	if (!nodes) {
+		PC_errhandler(handler);
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
+	}
+	nodes[0] = tree;
+
+	qsort(entries, nb_fields, sizeof(entry_t), entry_compare);
+
+	// the number of steps of the previous path whose node is known
+	int nb_known = 0;
+	const PC_path_t* previous = NULL;
+	for (int entry_idx = 0; entry_idx < nb_fields; ++entry_idx) {
+		const entry_t* entry = &entries[entry_idx];
+		if (!entry->path) continue;
+
+		int common = 0;
+		if (previous) pc_path_compare(previous, entry->path, &common);
+		int step = common < nb_known ? common : nb_known;
+		int len = pc_path_length(entry->path);
+		PC_tree_t value = nodes[step];
+		while (step < len) {
+			value = pc_path_step(value, entry->path, step);
+			if (PC_status(value)) break;
+			nodes[++step] = value;
+		}
+		nb_known = step;
+		previous = entry->path;
+
+		PC_status_t field_status = PC_status(value);
+		if (field_status == PC_NODE_NOT_FOUND && (entry->field->flags & PC_FIELD_OPTIONAL)) {
+			if (!entry->field->default_value) continue;
+			field_status = store_default(entry->field, data);
+		} else if (!field_status) {
+			field_status = store_node(entry->field, value, data);
+		}
+		if (field_status) report_add(&report, fields, entry->field, field_status, PC_errmsg());
+	}
+
+	PC_errhandler(handler);
+	if (report.nb_errors) {
+		PC_handle_err(
+			PC_make_err(
+				report.status,
+				"Unable to extract %d fields out of %d:%s\n",
+				report.nb_errors,
+				nb_fields,
+				report.buffer ? report.buffer : ""
+			),
+			err2
+		);
+	}
+
+err2:
+	free(nodes);
+err1:
+	for (int entry_idx = 0; entry_idx < nb_fields; ++entry_idx) {
+		PC_path_destroy(entries[entry_idx].path);
+	}
+	free(report.buffer);
+	free(entries);
+err0:
+	return status;
+}
@@ -162,6 +162,131 @@ type(PC_tree_t) function PC_get(tree, index_fmt)
 end function PC_get
 
 
+subroutine PC_path_compile(ypath, path, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  character(len = *), intent(IN) :: ypath
+  type(PC_path_t), intent(OUT) :: path
+  integer, intent(OUT), optional :: status
+
+  integer :: i, tmp
+  character(C_char), target :: C_ypath(len_trim(ypath)+1)
+
+  do i = 1, len_trim(ypath)
+      C_ypath(i) = ypath(i:i)
+  end do
+  C_ypath(len_trim(ypath)+1) = C_NULL_CHAR
+
+  tmp = int(PC_path_compile_C(c_loc(C_ypath), path%ptr))
+  if (present(status)) status = tmp
+
+end subroutine PC_path_compile
+
+
+type(PC_tree_t) function PC_cget(tree, path, indices)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree
+  type(PC_path_t), intent(IN) :: path
+  integer, intent(IN), optional :: indices(:)
+
+  integer(C_int), allocatable, target :: C_indices(:)
+  type(C_ptr) :: C_indices_ptr
+
+  if (present(indices)) then
+    allocate(C_indices(size(indices)))
+    C_indices = int(indices, C_int)
+  else
+    allocate(C_indices(0))
+  end if
+  C_indices_ptr = C_NULL_PTR
+  if (size(C_indices) > 0) C_indices_ptr = c_loc(C_indices(1))
+
+  ! the number of indices is checked against the argument slots
+  PC_cget = PC_cget_args_C(tree, path%ptr, int(size(C_indices), C_int), C_indices_ptr, 0_C_int, C_NULL_PTR)
+
+end function PC_cget
+
+
+type(PC_tree_t) function PC_cget_keys(tree, path, keys, indices)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree
+  type(PC_path_t), intent(IN) :: path
+  character(len = *), intent(IN) :: keys(:)
+  integer, intent(IN), optional :: indices(:)
+
+  integer :: i, j
+  integer(C_int), allocatable, target :: C_indices(:)
+  character(C_char), allocatable, target :: C_keys(:, :)
+  type(C_ptr), allocatable, target :: C_keys_ptr(:)
+  type(C_ptr) :: C_indices_ptr, C_keys_array
+
+  if (present(indices)) then
+    allocate(C_indices(size(indices)))
+    C_indices = int(indices, C_int)
+  else
+    allocate(C_indices(0))
+  end if
+  C_indices_ptr = C_NULL_PTR
+  if (size(C_indices) > 0) C_indices_ptr = c_loc(C_indices(1))
+
+  allocate(C_keys(len(keys) + 1, size(keys)), C_keys_ptr(size(keys)))
+  do j = 1, size(keys)
+    do i = 1, len_trim(keys(j))
+      C_keys(i, j) = keys(j)(i:i)
+    end do
+    C_keys(len_trim(keys(j)) + 1, j) = C_NULL_CHAR
+    C_keys_ptr(j) = c_loc(C_keys(1, j))
+  end do
+  C_keys_array = C_NULL_PTR
+  if (size(keys) > 0) C_keys_array = c_loc(C_keys_ptr(1))
+
+  ! the numbers of indices & keys are checked against the argument slots
+  PC_cget_keys = PC_cget_args_C(tree, path%ptr, int(size(C_indices), C_int), C_indices_ptr, int(size(keys), C_int), C_keys_array)
+
+end function PC_cget_keys
+
+
+subroutine PC_path_destroy(path, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_path_t), intent(INOUT) :: path
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+
+  tmp = int(PC_path_destroy_C(path%ptr))
+  if (present(status)) status = tmp
+  path%ptr = C_NULL_PTR
+
+end subroutine PC_path_destroy
+
+
 subroutine PC_int(tree_in, value, status)
 
   use ISO_C_binding
@@ -231,28 +356,25 @@ subroutine PC_string(tree_in, value, status)
   integer, intent(OUT), optional :: status
 
   integer :: i, tmp
-  integer, dimension(1), target :: tab_lengh
+  integer(C_int), target :: C_length
   type(C_ptr), target :: C_pointer
   CHARACTER, dimension(:), pointer :: F_pointer
 
   value = ""
-  tmp = int(PC_string_C(tree_in, c_loc(C_pointer)))
+  tmp = int(PC_string_view_C(tree_in, c_loc(C_pointer), c_loc(C_length)))
   if (present(status)) status = tmp
 
   if (tmp ==  PC_OK) then
 
-    tmp = int(PC_len_C(tree_in, C_loc(tab_lengh(1))))
-
-    call C_F_pointer(C_pointer, F_pointer, tab_lengh)
-    do i = 1, tab_lengh(1)
+    call C_F_pointer(C_pointer, F_pointer, [C_length])
+    do i = 1, min(int(C_length), len(value))
       value(i:i) = F_pointer(i)
     end do
 
-    do i = tab_lengh(1)+1, len(value)
+    do i = int(C_length)+1, len(value)
       value(i:i) = ' '
     end do
 
-    call free_C(C_pointer)
   end if
 end subroutine PC_string
 
@@ -289,6 +411,255 @@ subroutine PC_log(tree_in, value, status)
 end subroutine PC_log
 
 
+subroutine PC_int_array(tree_in, values, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_consts.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  integer, intent(OUT) :: values(:)
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+  integer(C_long), allocatable, target :: longvalues(:)
+
+  allocate(longvalues(size(values)))
+  tmp = int(PC_int_array_C(tree_in, c_loc(longvalues), int(size(values), C_int)))
+  if (present(status)) status = tmp
+
+  if (tmp ==  PC_OK) values(:) = int(longvalues(:))
+  deallocate(longvalues)
+
+end subroutine PC_int_array
+
+
+subroutine PC_double_array(tree_in, values, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_consts.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  real(8), intent(OUT) :: values(:)
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+  real(C_double), allocatable, target :: doublevalues(:)
+
+  allocate(doublevalues(size(values)))
+  tmp = int(PC_double_array_C(tree_in, c_loc(doublevalues), int(size(values), C_int)))
+  if (present(status)) status = tmp
+
+  if (tmp ==  PC_OK) values(:) = real(doublevalues(:), 8)
+  deallocate(doublevalues)
+
+end subroutine PC_double_array
+
+
+subroutine PC_log_array(tree_in, values, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_consts.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  logical, intent(OUT) :: values(:)
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+  integer(C_int), allocatable, target :: ilogs(:)
+
+  allocate(ilogs(size(values)))
+  tmp = int(PC_bool_array_C(tree_in, c_loc(ilogs), int(size(values), C_int)))
+  if (present(status)) status = tmp
+
+  if (tmp ==  PC_OK) values(:) = ilogs(:) /= 0
+  deallocate(ilogs)
+
+end subroutine PC_log_array
+
+
+subroutine PC_seq_begin(tree_in, iter, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  type(PC_seq_iter_t), intent(OUT) :: iter
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+
+  tmp = int(PC_seq_begin_C(tree_in, iter))
+  if (present(status)) status = tmp
+
+end subroutine PC_seq_begin
+
+
+logical function PC_seq_next(iter)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_seq_iter_t), intent(INOUT) :: iter
+
+  PC_seq_next = PC_seq_next_C(iter) /= 0
+
+end function PC_seq_next
+
+
+type(PC_tree_t) function PC_seq_value(iter)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_seq_iter_t), intent(IN) :: iter
+
+  PC_seq_value = PC_seq_value_C(iter)
+
+end function PC_seq_value
+
+
+subroutine PC_map_begin(tree_in, iter, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  type(PC_map_iter_t), intent(OUT) :: iter
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+
+  tmp = int(PC_map_begin_C(tree_in, iter))
+  if (present(status)) status = tmp
+
+end subroutine PC_map_begin
+
+
+logical function PC_map_next(iter)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_map_iter_t), intent(INOUT) :: iter
+
+  PC_map_next = PC_map_next_C(iter) /= 0
+
+end function PC_map_next
+
+
+type(PC_tree_t) function PC_map_key(iter)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_map_iter_t), intent(IN) :: iter
+
+  PC_map_key = PC_map_key_C(iter)
+
+end function PC_map_key
+
+
+type(PC_tree_t) function PC_map_value(iter)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_map_iter_t), intent(IN) :: iter
+
+  PC_map_value = PC_map_value_C(iter)
+
+end function PC_map_value
+
+
+subroutine PC_tree_retain(tree_in, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(IN) :: tree_in
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+
+  if(present(status)) then
+    status = int(PC_tree_retain_C(tree_in))
+  else
+    tmp = int(PC_tree_retain_C(tree_in))
+  end if
+
+end subroutine PC_tree_retain
+
+
+subroutine PC_tree_release(tree_in, status)
+
+  use ISO_C_binding
+
+  implicit none
+
+  include 'paraconf_f90_types.h'
+  include 'paraconf_f90_c.h'
+
+  type(PC_tree_t), intent(INOUT), target :: tree_in
+  integer, intent(OUT), optional :: status
+
+  integer :: tmp
+
+  if(present(status)) then
+    status = int(PC_tree_release_C(tree_in))
+  else
+    tmp = int(PC_tree_release_C(tree_in))
+  end if
+
+end subroutine PC_tree_release
+
+
 subroutine PC_tree_destroy(tree_in, status)
 
   use ISO_C_binding
@@ -40,6 +40,37 @@ interface
     type(PC_tree_t) :: PC_get_C
   end function PC_get_C
 
+  function PC_path_compile_C(ypath, path) &
+    bind(C, name="PC_path_compile")
+    use ISO_C_binding
+    implicit none
+    type(C_ptr), value :: ypath
+    type(C_ptr) :: path
+    integer(C_int) :: PC_path_compile_C
+  end function PC_path_compile_C
+
+  function PC_path_destroy_C(path) &
+    bind(C, name="PC_path_destroy")
+    use ISO_C_binding
+    implicit none
+    type(C_ptr), value :: path
+    integer(C_int) :: PC_path_destroy_C
+  end function PC_path_destroy_C
+
+  function PC_cget_args_C(tree, path, nb_indices, indices, nb_keys, keys) &
+    bind(C, name="PC_cget_args")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(C_ptr), value :: path
+    integer(C_int), value :: nb_indices
+    type(C_ptr), value :: indices
+    integer(C_int), value :: nb_keys
+    type(C_ptr), value :: keys
+    type(PC_tree_t) :: PC_cget_args_C
+  end function PC_cget_args_C
+
   function PC_len_C(tree, value) &
     bind(C, name="PC_len")
     use ISO_C_binding
@@ -80,6 +111,17 @@ interface
     integer(C_int) :: PC_string_C
   end function PC_string_C
 
+  function PC_string_view_C(tree, value, len) &
+    bind(C, name="PC_string_view")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(C_ptr), value :: value
+    type(C_ptr), value :: len
+    integer(C_int) :: PC_string_view_C
+  end function PC_string_view_C
+
   function PC_bool_C(tree, value) &
     bind(C, name="PC_bool")
     use ISO_C_binding
@@ -90,6 +132,122 @@ interface
     integer(C_int) :: PC_bool_C
   end function PC_bool_C
 
+  function PC_int_array_C(tree, values, size) &
+    bind(C, name="PC_int_array")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(C_ptr), value :: values
+    integer(C_int), value :: size
+    integer(C_int) :: PC_int_array_C
+  end function PC_int_array_C
+
+  function PC_double_array_C(tree, values, size) &
+    bind(C, name="PC_double_array")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(C_ptr), value :: values
+    integer(C_int), value :: size
+    integer(C_int) :: PC_double_array_C
+  end function PC_double_array_C
+
+  function PC_bool_array_C(tree, values, size) &
+    bind(C, name="PC_bool_array")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(C_ptr), value :: values
+    integer(C_int), value :: size
+    integer(C_int) :: PC_bool_array_C
+  end function PC_bool_array_C
+
+  function PC_seq_begin_C(tree, iter) &
+    bind(C, name="PC_seq_begin")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(PC_seq_iter_t) :: iter
+    integer(C_int) :: PC_seq_begin_C
+  end function PC_seq_begin_C
+
+  function PC_seq_next_C(iter) &
+    bind(C, name="PC_seq_next")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_seq_iter_t) :: iter
+    integer(C_int) :: PC_seq_next_C
+  end function PC_seq_next_C
+
+  function PC_seq_value_C(iter) &
+    bind(C, name="PC_seq_value")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_seq_iter_t) :: iter
+    type(PC_tree_t) :: PC_seq_value_C
+  end function PC_seq_value_C
+
+  function PC_map_begin_C(tree, iter) &
+    bind(C, name="PC_map_begin")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    type(PC_map_iter_t) :: iter
+    integer(C_int) :: PC_map_begin_C
+  end function PC_map_begin_C
+
+  function PC_map_next_C(iter) &
+    bind(C, name="PC_map_next")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t) :: iter
+    integer(C_int) :: PC_map_next_C
+  end function PC_map_next_C
+
+  function PC_map_key_C(iter) &
+    bind(C, name="PC_map_key")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t) :: iter
+    type(PC_tree_t) :: PC_map_key_C
+  end function PC_map_key_C
+
+  function PC_map_value_C(iter) &
+    bind(C, name="PC_map_value")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_map_iter_t) :: iter
+    type(PC_tree_t) :: PC_map_value_C
+  end function PC_map_value_C
+
+  function PC_tree_retain_C(tree) &
+    bind(C, name="PC_tree_retain")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), value :: tree
+    integer(C_int) :: PC_tree_retain_C
+  end function PC_tree_retain_C
+
+  function PC_tree_release_C(tree) &
+    bind(C, name="PC_tree_release")
+    use ISO_C_binding
+    implicit none
+    include 'paraconf_f90_types.h'
+    type(PC_tree_t), intent(IN) :: tree
+    integer(C_int) :: PC_tree_release_C
+  end function PC_tree_release_C
+
   function PC_tree_destroy_C(tree) &
     bind(C, name="PC_tree_destroy")
     use ISO_C_binding
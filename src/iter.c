@@ -0,0 +1,106 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+
+#include "paraconf.h"
+
+#include "status.h"
+#include "ypath.h"
+
+static const char* nodetype[4] = {"none", "scalar", "sequence", "mapping"};
+
+/** Checks a tree is a valid node of a given type
+ *
+ * \param tree the tree to check
+ * \param type the expected node type
+ * \return the status of the execution
+ */
+static PC_status_t check_type(const PC_tree_t tree, yaml_node_type_t type)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	if (!tree.node) {
+		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected node, found empty tree\n"), err0);
+	}
+
+	if (tree.node->type != type) {
+		PC_handle_err(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a %s, found %s\n", nodetype[type], nodetype[tree.node->type]), err0);
+	}
+
+	return status;
+
+err0:
+	PC_STATS_ERROR(tree, status);
+	return status;
+}
+
+PC_status_t PC_seq_begin(const PC_tree_t tree, PC_seq_iter_t* iter)
+{
+	PC_status_t status = PC_OK;
+	iter->tree = tree;
+	iter->index = -1;
+	iter->len = 0;
+
+	PC_handle_err(check_type(tree, YAML_SEQUENCE_NODE), err0);
+	iter->len = tree.node->data.sequence.items.top - tree.node->data.sequence.items.start;
+
+	return status;
+
+err0:
+	return status;
+}
+
+int PC_seq_next(PC_seq_iter_t* iter)
+{
+	if (iter->index >= iter->len) return 0;
+	return ++iter->index < iter->len;
+}
+
+PC_tree_t PC_seq_value(const PC_seq_iter_t* iter)
+{
+	assert(iter->index >= 0 && iter->index < iter->len);
+	PC_tree_t restree = iter->tree;
+	restree.node = yaml_document_get_node(&restree.pcdoc->document, restree.node->data.sequence.items.start[iter->index]);
+	return restree;
+}
+
+PC_status_t PC_map_begin(const PC_tree_t tree, PC_map_iter_t* iter)
+{
+	PC_status_t status = PC_OK;
+	iter->tree = tree;
+	iter->index = -1;
+	iter->len = 0;
+
+	PC_handle_err(check_type(tree, YAML_MAPPING_NODE), err0);
+	iter->len = tree.node->data.mapping.pairs.top - tree.node->data.mapping.pairs.start;
+
+	return status;
+
+err0:
+	return status;
+}
+
+int PC_map_next(PC_map_iter_t* iter)
+{
+	if (iter->index >= iter->len) return 0;
+	return ++iter->index < iter->len;
+}
+
+PC_tree_t PC_map_key(const PC_map_iter_t* iter)
+{
+	assert(iter->index >= 0 && iter->index < iter->len);
+	PC_tree_t restree = iter->tree;
+	restree.node = yaml_document_get_node(&restree.pcdoc->document, restree.node->data.mapping.pairs.start[iter->index].key);
+	return restree;
+}
+
+PC_tree_t PC_map_value(const PC_map_iter_t* iter)
+{
+	assert(iter->index >= 0 && iter->index < iter->len);
+	return pc_pair_value(iter->tree, &iter->tree.node->data.mapping.pairs.start[iter->index]);
+}
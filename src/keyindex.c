@@ -0,0 +1,182 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "keyindex.h"
+#include "ypath.h"
+
+/** An open-addressing hash table of the keys of a single mapping
+ */
+typedef struct mapindex_s {
+	/// number of slots - 1, the number of slots is a power of 2
+	uint32_t mask;
+
+	/// the slots, pair is the 1-based index of the pair in the mapping, 0 for an empty slot
+	struct {
+		uint32_t hash;
+		uint32_t pair;
+	} slots[];
+
+} mapindex_t;
+
+struct pc_keyindex_s {
+	/// number of nodes in the document
+	size_t nb_nodes;
+
+	/// the index of each mapping node, NULL until first looked-up
+	mapindex_t* maps[];
+};
+
+static inline uint32_t key_hash(const char* key, size_t key_len)
+{
+	// 64-bit FNV-1a folded to 32 bits
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t ii = 0; ii < key_len; ++ii) {
+		hash ^= (unsigned char)key[ii];
+		hash *= 1099511628211ULL;
+	}
+	return (uint32_t)(hash ^ (hash >> 32));
+}
+
+static inline int key_equals(const yaml_node_t* key_node, const char* key, size_t key_len)
+{
+	return key_node && key_node->type == YAML_SCALAR_NODE && key_node->data.scalar.length == key_len
+	    && !memcmp(key_node->data.scalar.value, key, key_len);
+}
+
+static yaml_node_pair_t* linear_find(PC_document_t* doc, yaml_node_t* map, const char* key, size_t key_len)
+{
+	for (yaml_node_pair_t* pair = map->data.mapping.pairs.start; pair != map->data.mapping.pairs.top; ++pair) {
+		if (key_equals(yaml_document_get_node(&doc->document, pair->key), key, key_len)) {
+			PC_STATS_ADD(doc, nb_key_compares, pair - map->data.mapping.pairs.start + 1);
+			return pair;
+		}
+	}
+	PC_STATS_ADD(doc, nb_key_compares, map->data.mapping.pairs.top - map->data.mapping.pairs.start);
+	return NULL;
+}
+
+/** Returns the size of the index of a mapping
+ */
+static size_t mapindex_size(const mapindex_t* index)
+{
+	return sizeof(mapindex_t) + ((size_t)index->mask + 1) * sizeof(index->slots[0]);
+}
+
+static mapindex_t* mapindex_build(PC_document_t* doc, yaml_node_t* map)
+{
+	size_t nb_pairs = map->data.mapping.pairs.top - map->data.mapping.pairs.start;
+	size_t nb_slots = 16;
+	while (nb_slots < 2 * nb_pairs)
+		nb_slots *= 2;
+
+	mapindex_t* index = calloc(1, sizeof(mapindex_t) + nb_slots * sizeof(index->slots[0]));
+	if (!index) return NULL;
+	index->mask = nb_slots - 1;
+
+	for (size_t pair_idx = 0; pair_idx < nb_pairs; ++pair_idx) {
+		yaml_node_t* key_node = yaml_document_get_node(&doc->document, map->data.mapping.pairs.start[pair_idx].key);
+		if (!key_node || key_node->type != YAML_SCALAR_NODE) continue;
+		const char* key = (const char*)key_node->data.scalar.value;
+		size_t key_len = key_node->data.scalar.length;
+		uint32_t hash = key_hash(key, key_len);
+		uint32_t slot = hash & index->mask;
+		for (; index->slots[slot].pair; slot = (slot + 1) & index->mask) {
+			if (index->slots[slot].hash != hash) continue;
+			yaml_node_pair_t* other = map->data.mapping.pairs.start + index->slots[slot].pair - 1;
+			if (key_equals(yaml_document_get_node(&doc->document, other->key), key, key_len)) break;
+		}
+		if (index->slots[slot].pair) continue; // duplicate key, the first one wins
+		index->slots[slot].hash = hash;
+		index->slots[slot].pair = pair_idx + 1;
+	}
+
+	return index;
+}
+
+/** Returns the index of a mapping, building it if required
+ *
+ * Concurrent readers may race to build the same index, only one of them
+ * publishes it, the others free their copy.
+ */
+static mapindex_t* mapindex_get(PC_document_t* doc, yaml_node_t* map)
+{
+	pc_keyindex_t* keyindex = __atomic_load_n(&doc->keyindex, __ATOMIC_ACQUIRE);
+	if (!keyindex) {
+		size_t nb_nodes = doc->document.nodes.top - doc->document.nodes.start;
+		pc_keyindex_t* new_keyindex = calloc(1, sizeof(pc_keyindex_t) + nb_nodes * sizeof(mapindex_t*));
+		if (!new_keyindex) return NULL;
+		new_keyindex->nb_nodes = nb_nodes;
+		if (__atomic_compare_exchange_n(&doc->keyindex, &keyindex, new_keyindex, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			PC_STATS_ALLOC(doc, sizeof(pc_keyindex_t) + nb_nodes * sizeof(mapindex_t*));
+			keyindex = new_keyindex;
+		} else {
+			free(new_keyindex);
+		}
+	}
+
+	size_t node_idx = map - doc->document.nodes.start;
+	if (node_idx >= keyindex->nb_nodes) return NULL;
+
+	mapindex_t* index = __atomic_load_n(&keyindex->maps[node_idx], __ATOMIC_ACQUIRE);
+	if (!index) {
+		mapindex_t* new_index = mapindex_build(doc, map);
+		if (!new_index) return NULL;
+		if (__atomic_compare_exchange_n(&keyindex->maps[node_idx], &index, new_index, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			PC_STATS_ALLOC(doc, mapindex_size(new_index));
+			index = new_index;
+		} else {
+			free(new_index);
+		}
+	}
+	return index;
+}
+
+yaml_node_pair_t* pc_keyindex_find(PC_document_t* doc, yaml_node_t* map, const char* key, size_t key_len)
+{
+	if (map->data.mapping.pairs.top - map->data.mapping.pairs.start < PC_KEYINDEX_MIN_PAIRS) {
+		return linear_find(doc, map, key, key_len);
+	}
+
+	mapindex_t* index = mapindex_get(doc, map);
+	if (!index) return linear_find(doc, map, key, key_len); // out of memory, degrade gracefully
+
+	uint32_t hash = key_hash(key, key_len);
+	for (uint32_t slot = hash & index->mask; index->slots[slot].pair; slot = (slot + 1) & index->mask) {
+		if (index->slots[slot].hash != hash) continue;
+		PC_STATS_ADD(doc, nb_key_compares, 1);
+		yaml_node_pair_t* pair = map->data.mapping.pairs.start + index->slots[slot].pair - 1;
+		if (key_equals(yaml_document_get_node(&doc->document, pair->key), key, key_len)) return pair;
+	}
+	return NULL;
+}
+
+size_t pc_keyindex_memory(PC_document_t* doc)
+{
+	pc_keyindex_t* keyindex = __atomic_load_n(&doc->keyindex, __ATOMIC_ACQUIRE);
+	if (!keyindex) return 0;
+	size_t memory = sizeof(pc_keyindex_t) + keyindex->nb_nodes * sizeof(mapindex_t*);
+	for (size_t node_idx = 0; node_idx < keyindex->nb_nodes; ++node_idx) {
+		mapindex_t* index = __atomic_load_n(&keyindex->maps[node_idx], __ATOMIC_ACQUIRE);
+		if (index) memory += mapindex_size(index);
+	}
+	return memory;
+}
+
+void pc_keyindex_destroy(PC_document_t* doc)
+{
+	if (!doc->keyindex) return;
+	for (size_t node_idx = 0; node_idx < doc->keyindex->nb_nodes; ++node_idx) {
+		free(doc->keyindex->maps[node_idx]);
+	}
+	free(doc->keyindex);
+	doc->keyindex = NULL;
+}
@@ -0,0 +1,50 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef KEYINDEX_H__
+#define KEYINDEX_H__
+
+#include <stddef.h>
+
+#include "paraconf.h"
+
+/** Mappings with less pairs than this are searched linearly, larger ones are
+ * hashed on their first lookup
+ */
+#define PC_KEYINDEX_MIN_PAIRS 8
+
+/** The per-mapping key indices of a document, one (possibly NULL) slot per
+ * node of the document
+ */
+typedef struct pc_keyindex_s pc_keyindex_t;
+
+/** Looks for a key in a mapping node
+ *
+ * The index of the mapping is built on first use and cached in the document.
+ * Only scalar keys are considered, the first occurence of a key wins.
+ *
+ * \param doc the document containing the mapping
+ * \param map the mapping node
+ * \param key the key to look for (not null-terminated)
+ * \param key_len the length of key
+ * \return the pair with that key or NULL if not found
+ */
+yaml_node_pair_t* pc_keyindex_find(PC_document_t* doc, yaml_node_t* map, const char* key, size_t key_len);
+
+/** Returns the memory used by the key indices cached in a document
+ *
+ * \param doc the document
+ * \return the size of the indices in bytes
+ */
+size_t pc_keyindex_memory(PC_document_t* doc);
+
+/** Releases all the key indices cached in a document
+ *
+ * \param doc the document whose indices to release
+ */
+void pc_keyindex_destroy(PC_document_t* doc);
+
+#endif // KEYINDEX_H__
@@ -0,0 +1,398 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "paraconf.h"
+
+#include "lazy.h"
+#include "stats.h"
+#include "status.h"
+#include "ypath.h"
+
+/* A lazily parsed document is made of a skeleton: a root mapping whose keys are
+ * read from the source and whose values all are a single placeholder node.
+ * Each top-level `key: value' pair occupies a range of lines of the source
+ * starting at column 0. It is parsed as a document of its own the first time
+ * its value is accessed. This document is owned by the skeleton.
+ *
+ * The index is only built for sources that can be split safely, i.e. whose
+ * root is a block mapping, that contain neither directives, anchors nor
+ * aliases, and whose flow collections & quoted scalars each fit on a single
+ * line. Other sources are parsed eagerly.
+ */
+
+/// tag of the placeholder node standing for the values not parsed yet
+#define PC_LAZY_TAG "tag:paraconf,2024:lazy"
+
+/// initial number of values in an index
+#define PC_LAZY_MIN_VALUES 64
+
+/** A top-level pair of a lazily parsed document
+ */
+typedef struct lazy_value_s {
+	/// offset of the pair in the source
+	size_t start;
+	/// offset of the end of the pair in the source
+	size_t end;
+	/// length of the key, at the start of the pair
+	size_t key_len;
+	/// line of the pair in the source
+	size_t line;
+	/// the document holding the parsed pair, NULL until its value is accessed
+	PC_document_t* doc;
+} lazy_value_t;
+
+struct pc_lazy_s {
+	/// a private copy of the source, so that the file can change while values remain to be parsed
+	const char* data;
+	/// the size of the source
+	size_t size;
+	/// the number of top-level pairs
+	size_t nb_values;
+	/// the top-level pairs, in order
+	lazy_value_t values[];
+};
+
+/** Checks whether a line can be parsed independently from the next ones
+ *
+ * \param line the start of the line content
+ * \param end the end of the line
+ * \return whether the line contains no anchor nor alias and leaves no flow
+ *         collection or quoted scalar open
+ */
+static int simple_line(const char* line, const char* end)
+{
+	int depth = 0;
+	char quote = 0;
+	for (const char* cur = line; cur < end; ++cur) {
+		if (quote) {
+			if (quote == '"' && *cur == '\\') {
+				++cur;
+			} else if (*cur == quote) {
+				quote = 0;
+			}
+			continue;
+		}
+		int token_start = cur == line || cur[-1] == ' ' || cur[-1] == '\t' || cur[-1] == '[' || cur[-1] == '{' || cur[-1] == ',';
+		switch (*cur) {
+		case '#':
+			if (cur == line || cur[-1] == ' ' || cur[-1] == '\t') return !depth; // comment
+			break;
+		case '"':
+		case '\'':
+			if (token_start) quote = *cur;
+			break;
+		case '[':
+		case '{':
+			if (token_start || depth) ++depth;
+			break;
+		case ']':
+		case '}':
+			if (depth) --depth;
+			break;
+		case '&':
+		case '*':
+			if (token_start && cur + 1 < end && cur[1] != ' ' && cur[1] != '\t') return 0;
+			break;
+		default:
+			break;
+		}
+	}
+	return !quote && !depth;
+}
+
+/** Indexes the top-level pairs of a source
+ *
+ * \param data the source
+ * \param size the size of the source
+ * \return the index, NULL if the source can not be split or on memory shortage
+ */
+static pc_lazy_t* index_source(const char* data, size_t size)
+{
+	if (size >= 3 && !memcmp(data, "\xEF\xBB\xBF", 3)) return NULL; // byte order mark
+
+	size_t capacity = PC_LAZY_MIN_VALUES;
+	pc_lazy_t* lazy = malloc(sizeof(pc_lazy_t) + capacity * sizeof(lazy_value_t));
+	if (!lazy) return NULL;
+	lazy->data = data;
+	lazy->size = size;
+	lazy->nb_values = 0;
+
+	int content_seen = 0; // whether a non-comment line was found, after which `---' is not supported
+	int empty_value = 0; // whether the last key has no value on its line, which can then be a sequence at column 0
+	size_t line = 0;
+	for (size_t pos = 0; pos < size; ++line) {
+		const char* begin = data + pos;
+		const char* eol = memchr(begin, '\n', size - pos);
+		const char* end = eol ? eol : data + size;
+		pos = end - data + 1;
+		if (end > begin && end[-1] == '\r') --end;
+
+		const char* content = begin;
+		while (content < end && *content == ' ')
+			++content;
+		if (content == end || *content == '#') continue; // blank or comment line
+
+		// indented lines belong to the value of the last key
+		if (content > begin) {
+			if (!lazy->nb_values || !simple_line(content, end)) goto err0;
+			continue;
+		}
+
+		if (end - begin >= 3 && (!memcmp(begin, "---", 3) || !memcmp(begin, "...", 3))
+		    && (end - begin == 3 || begin[3] == ' ' || begin[3] == '\t'))
+		{
+			if (content_seen || *begin == '.') goto err0;
+			const char* rest = begin + 3;
+			while (rest < end && (*rest == ' ' || *rest == '\t'))
+				++rest;
+			if (rest < end && *rest != '#') goto err0;
+			content_seen = 1;
+			continue;
+		}
+		content_seen = 1;
+
+		// a sequence at column 0 is the value of the last key
+		if (*begin == '-' && (end - begin == 1 || begin[1] == ' ')) {
+			if (!lazy->nb_values || !empty_value || !simple_line(begin, end)) goto err0;
+			continue;
+		}
+
+		// only plain keys are supported
+		if (strchr("-?:,[]{}#&*!|>'\"%@`\t", *begin)) goto err0;
+		const char* colon = begin;
+		while (colon < end && !(*colon == ':' && (colon + 1 == end || colon[1] == ' ' || colon[1] == '\t'))) {
+			if (*colon == '#' && (colon[-1] == ' ' || colon[-1] == '\t')) goto err0;
+			++colon;
+		}
+		if (colon == end) goto err0;
+		const char* key_end = colon;
+		while (key_end[-1] == ' ' || key_end[-1] == '\t')
+			--key_end;
+		const char* value = colon + 1;
+		while (value < end && (*value == ' ' || *value == '\t'))
+			++value;
+		if (!simple_line(value, end)) goto err0;
+		empty_value = value == end || *value == '#';
+
+		if (lazy->nb_values == capacity) {
+			capacity *= 2;
+			pc_lazy_t* grown = realloc(lazy, sizeof(pc_lazy_t) + capacity * sizeof(lazy_value_t));
+			if (!grown) goto err0;
+			lazy = grown;
+		}
+		if (lazy->nb_values) lazy->values[lazy->nb_values - 1].end = begin - data;
+		lazy_value_t* pair = &lazy->values[lazy->nb_values++];
+		pair->start = begin - data;
+		pair->key_len = key_end - begin;
+		pair->line = line;
+		pair->doc = NULL;
+	}
+	if (!lazy->nb_values) goto err0;
+	lazy->values[lazy->nb_values - 1].end = size;
+
+	return lazy;
+
+err0:
+	free(lazy);
+	return NULL;
+}
+
+/** Builds the skeleton document of an index
+ *
+ * \param lazy the index
+ * \param[out] document the skeleton
+ * \return whether the skeleton could be built, it fails on keys that are not valid UTF-8 or on memory shortage
+ */
+static int build_skeleton(const pc_lazy_t* lazy, yaml_document_t* document)
+{
+	if (!yaml_document_initialize(document, NULL, NULL, NULL, 1, 1)) return 0;
+	int map = yaml_document_add_mapping(document, NULL, YAML_BLOCK_MAPPING_STYLE);
+	int placeholder = yaml_document_add_scalar(document, (yaml_char_t*)PC_LAZY_TAG, (yaml_char_t*)"", 0, YAML_PLAIN_SCALAR_STYLE);
+	if (!map || !placeholder) goto err0;
+	for (size_t idx = 0; idx < lazy->nb_values; ++idx) {
+		const lazy_value_t* value = &lazy->values[idx];
+		int key = yaml_document_add_scalar(document, NULL, (yaml_char_t*)lazy->data + value->start, value->key_len, YAML_PLAIN_SCALAR_STYLE);
+		if (!key || !yaml_document_append_mapping_pair(document, map, key, placeholder)) goto err0;
+	}
+	return 1;
+
+err0:
+	yaml_document_delete(document);
+	return 0;
+}
+
+/** Reads a whole file in a newly allocated buffer
+ *
+ * \param fd the file descriptor
+ * \param capacity the expected size of the file
+ * \param[out] size the number of bytes read, less than capacity if the file shrunk meanwhile
+ * \return the buffer, NULL on error
+ */
+static char* read_source(int fd, size_t capacity, size_t* size)
+{
+	char* data = malloc(capacity);
+	if (!data) return NULL;
+	*size = 0;
+	while (*size < capacity) {
+		ssize_t len = read(fd, data + *size, capacity - *size);
+		if (len < 0 && errno == EINTR) continue;
+		if (len < 0) {
+			free(data);
+			return NULL;
+		}
+		if (!len) break;
+		*size += len;
+	}
+	return data;
+}
+
+PC_tree_t PC_parse_path_lazy(const char* path)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+	PC_STATS_START(start);
+
+	// anything but a non-empty regular file is parsed eagerly, errors included
+	int conf_fd = open(path, O_RDONLY);
+	if (conf_fd < 0) return PC_parse_path(path);
+	struct stat conf_stat;
+	char* data = NULL;
+	size_t size = 0;
+	if (!fstat(conf_fd, &conf_stat) && S_ISREG(conf_stat.st_mode) && conf_stat.st_size > 0) {
+		data = read_source(conf_fd, conf_stat.st_size, &size);
+	}
+	close(conf_fd);
+	if (!data || !size) {
+		free(data);
+		return PC_parse_path(path);
+	}
+
+	yaml_document_t document;
+	pc_lazy_t* lazy = index_source(data, size);
+	if (!lazy || !build_skeleton(lazy, &document)) {
+		free(lazy);
+		free(data);
+		return PC_parse_path(path);
+	}
+
+	restree = PC_root(&document);
+	restree.pcdoc->lazy = lazy;
+	restree.pcdoc->path = strdup(path);
+	PC_STATS_ALLOC(restree.pcdoc, size);
+	PC_STATS_ALLOC(restree.pcdoc, sizeof(pc_lazy_t) + lazy->nb_values * sizeof(lazy_value_t));
+	PC_STATS_PARSED(restree.pcdoc, start, size);
+	return restree;
+}
+
+/** Parses a top-level pair of a lazily parsed document
+ *
+ * \param doc the lazily parsed document
+ * \param value the pair to parse
+ * \param[out] value_doc the document holding the pair
+ * \return the status of the execution
+ */
+static PC_status_t parse_value(PC_document_t* doc, const lazy_value_t* value, PC_document_t** value_doc)
+{
+	PC_status_t status = PC_OK;
+
+	yaml_parser_t parser;
+	if (!yaml_parser_initialize(&parser)) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to load yaml library"), err0);
+	}
+	yaml_parser_set_input_string(&parser, (const unsigned char*)doc->lazy->data + value->start, value->end - value->start);
+
+	PC_STATS_START(start);
+	yaml_document_t document;
+	if (!yaml_parser_load(&parser, &document)) {
+		PC_handle_err(
+			PC_make_err(
+				PC_INVALID_FORMAT,
+				"can not parse file `%s`\n%lu:%lu: Error: %s",
+				doc->path,
+				(unsigned long)(value->line + parser.problem_mark.line),
+				(unsigned long)parser.problem_mark.column,
+				parser.problem
+			),
+			err1
+		);
+	}
+	yaml_node_t* root = yaml_document_get_root_node(&document);
+	if (!root || root->type != YAML_MAPPING_NODE || root->data.mapping.pairs.top - root->data.mapping.pairs.start != 1) {
+		yaml_document_delete(&document);
+		PC_handle_err(
+			PC_make_err(PC_INVALID_FORMAT, "can not parse file `%s`\n%lu:0: Error: invalid top-level mapping entry", doc->path, (unsigned long)value->line),
+			err1
+		);
+	}
+
+	PC_tree_t value_tree = PC_root(&document);
+	value_tree.pcdoc->path = strdup(doc->path);
+	value_tree.pcdoc->parent = doc;
+	PC_STATS_PARSED(value_tree.pcdoc, start, parser.offset);
+	*value_doc = value_tree.pcdoc;
+
+err1:
+	yaml_parser_delete(&parser);
+err0:
+	return status;
+}
+
+PC_tree_t pc_lazy_value(PC_tree_t map, const yaml_node_pair_t* pair)
+{
+	PC_tree_t restree = map;
+	PC_document_t* doc = map.pcdoc;
+
+	// only the values of the root mapping are parsed lazily
+	if (map.node != yaml_document_get_root_node(&doc->document)) {
+		restree.node = yaml_document_get_node(&doc->document, pair->value);
+		return restree;
+	}
+
+	lazy_value_t* value = &doc->lazy->values[pair - map.node->data.mapping.pairs.start];
+	PC_document_t* value_doc = __atomic_load_n(&value->doc, __ATOMIC_ACQUIRE);
+	if (!value_doc) {
+		PC_handle_err_tree(parse_value(doc, value, &value_doc), err0);
+		// concurrent accesses to the same value keep the first one parsed
+		PC_document_t* expected = NULL;
+		if (!__atomic_compare_exchange_n(&value->doc, &expected, value_doc, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			PC_tree_t discarded = {PC_OK, value_doc, NULL};
+			value_doc->parent = NULL;
+			PC_tree_destroy(&discarded);
+			value_doc = expected;
+		}
+	}
+
+	const yaml_node_t* value_map = yaml_document_get_root_node(&value_doc->document);
+	restree.pcdoc = value_doc;
+	restree.node = yaml_document_get_node(&value_doc->document, value_map->data.mapping.pairs.start->value);
+	return restree;
+
+err0:
+	return restree;
+}
+
+void pc_lazy_destroy(PC_document_t* doc)
+{
+	pc_lazy_t* lazy = doc->lazy;
+	if (!lazy) return;
+	for (size_t idx = 0; idx < lazy->nb_values; ++idx) {
+		if (!lazy->values[idx].doc) continue;
+		PC_tree_t value_tree = {PC_OK, lazy->values[idx].doc, NULL};
+		value_tree.pcdoc->parent = NULL;
+		PC_tree_destroy(&value_tree);
+	}
+	free((void*)lazy->data);
+	free(lazy);
+	doc->lazy = NULL;
+}
@@ -0,0 +1,26 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LAZY_H__
+#define LAZY_H__
+
+#include "paraconf.h"
+
+#include "ypath.h"
+
+/** The index of the top-level values of a lazily parsed document, along with
+ * the source they are parsed from on demand
+ */
+typedef struct pc_lazy_s pc_lazy_t;
+
+/** Releases the index of a lazily parsed document and all the values parsed
+ * from it
+ *
+ * \param doc the document whose index to release
+ */
+void pc_lazy_destroy(PC_document_t* doc);
+
+#endif // LAZY_H__
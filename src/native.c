@@ -0,0 +1,786 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "native.h"
+
+/* The native scanner reads a document line by line. The indentation of each
+ * line decides whether it continues the current collection, opens a nested
+ * one or closes it, the way libyaml's block context does. Within a line, the
+ * scanner only looks for the few characters that end the current token, with
+ * SIMD instructions when available: the whole document is first checked for
+ * characters that need a closer look, then each scalar is scanned for its end.
+ *
+ * Nodes are added to the document in the order libyaml's loader adds them, so
+ * that both give the same node ids. Whenever the scanner meets something it
+ * does not support, it gives up and libyaml loads the document instead.
+ */
+
+#if !defined(PC_NATIVE_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define PC_NATIVE_X86
+#include <immintrin.h>
+#endif
+
+/// longest simple key, libyaml rejects keys longer than 1024 characters
+#define PC_NATIVE_MAX_KEY 1000
+
+/// deepest nesting of collections, deeper documents are left to libyaml rather than overflowing the stack
+#define PC_NATIVE_MAX_DEPTH 1000
+
+/** The state of the scanner
+ */
+typedef struct scanner_s {
+	/// the current position, at the first content character of the line once it is reached
+	const char* cur;
+	/// the end of the document
+	const char* end;
+	/// the indentation of the current line, -1 at the end of the document
+	int indent;
+	/// the document being loaded
+	yaml_document_t* document;
+	/// a buffer holding unescaped quoted scalars
+	char* scratch;
+	/// the capacity of scratch
+	size_t scratch_size;
+	/// whether AVX2 instructions are available
+	int avx2;
+	/// the number of collections being parsed
+	int depth;
+} scanner_t;
+
+/** A scalar found in the document
+ */
+typedef struct token_s {
+	/// the first character of the value, after the opening quote if any
+	const char* start;
+	/// the end of the value, before the closing quote if any
+	const char* stop;
+	/// the position following the scalar, after the closing quote if any
+	const char* next;
+	/// the style of the scalar
+	yaml_scalar_style_t style;
+} token_t;
+
+/** Returns whether a byte of the document needs a closer look: a control
+ * character or a byte of a non-ASCII one
+ */
+static inline int special_byte(unsigned char c)
+{
+	return c >= 0x7F || (c < 0x20 && c != '\n' && c != '\t');
+}
+
+/** Returns the first special byte in a range, end if none
+ */
+static const unsigned char* skip_ascii_scalar(const unsigned char* p, const unsigned char* end)
+{
+	while (p < end && !special_byte(*p))
+		++p;
+	return p;
+}
+
+/** Returns the first occurrence of any of 4 characters in a range, end if none
+ */
+static const char* find_scalar(const char* p, const char* end, char c1, char c2, char c3, char c4)
+{
+	for (; p < end; ++p) {
+		char c = *p;
+		if (c == c1 || c == c2 || c == c3 || c == c4) return p;
+	}
+	return end;
+}
+
+#ifdef PC_NATIVE_X86
+
+/** Returns the first special byte in a range, end if none, 16 bytes at a time
+ */
+static const unsigned char* skip_ascii_sse2(const unsigned char* p, const unsigned char* end)
+{
+	const __m128i space = _mm_set1_epi8(0x20), del = _mm_set1_epi8(0x7F), lf = _mm_set1_epi8('\n'), tab = _mm_set1_epi8('\t');
+	for (; end - p >= 16; p += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		// bytes of non-ASCII characters are negative, thus below space
+		__m128i special = _mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, del));
+		__m128i allowed = _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, tab));
+		int mask = _mm_movemask_epi8(_mm_andnot_si128(allowed, special));
+		if (mask) return p + __builtin_ctz(mask);
+	}
+	return skip_ascii_scalar(p, end);
+}
+
+/** Returns the first occurrence of any of 4 characters in a range, end if
+ * none, 16 bytes at a time
+ */
+static const char* find_sse2(const char* p, const char* end, char c1, char c2, char c3, char c4)
+{
+	const __m128i v1 = _mm_set1_epi8(c1), v2 = _mm_set1_epi8(c2), v3 = _mm_set1_epi8(c3), v4 = _mm_set1_epi8(c4);
+	for (; end - p >= 16; p += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		__m128i hits = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, v3), _mm_cmpeq_epi8(chunk, v4))
+		);
+		int mask = _mm_movemask_epi8(hits);
+		if (mask) return p + __builtin_ctz(mask);
+	}
+	return find_scalar(p, end, c1, c2, c3, c4);
+}
+
+#ifndef PC_NATIVE_NO_AVX2
+
+/** Returns the first special byte in a range, end if none, 32 bytes at a time
+ */
+__attribute__((target("avx2"))) static const unsigned char* skip_ascii_avx2(const unsigned char* p, const unsigned char* end)
+{
+	const __m256i space = _mm256_set1_epi8(0x20), del = _mm256_set1_epi8(0x7F), lf = _mm256_set1_epi8('\n'), tab = _mm256_set1_epi8('\t');
+	for (; end - p >= 32; p += 32) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+		// bytes of non-ASCII characters are negative, thus below space
+		__m256i special = _mm256_or_si256(_mm256_cmpgt_epi8(space, chunk), _mm256_cmpeq_epi8(chunk, del));
+		__m256i allowed = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lf), _mm256_cmpeq_epi8(chunk, tab));
+		unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_andnot_si256(allowed, special));
+		if (mask) return p + __builtin_ctz(mask);
+	}
+	return skip_ascii_sse2(p, end);
+}
+
+/** Returns the first occurrence of any of 4 characters in a range, end if
+ * none, 32 bytes at a time
+ */
+__attribute__((target("avx2"))) static const char* find_avx2(const char* p, const char* end, char c1, char c2, char c3, char c4)
+{
+	const __m256i v1 = _mm256_set1_epi8(c1), v2 = _mm256_set1_epi8(c2), v3 = _mm256_set1_epi8(c3), v4 = _mm256_set1_epi8(c4);
+	for (; end - p >= 32; p += 32) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+		__m256i hits = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, v1), _mm256_cmpeq_epi8(chunk, v2)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, v3), _mm256_cmpeq_epi8(chunk, v4))
+		);
+		unsigned mask = (unsigned)_mm256_movemask_epi8(hits);
+		if (mask) return p + __builtin_ctz(mask);
+	}
+	return find_sse2(p, end, c1, c2, c3, c4);
+}
+
+#endif // PC_NATIVE_NO_AVX2
+
+#endif // PC_NATIVE_X86
+
+/** Returns the first special byte from a position, the end of the document if none
+ */
+static inline const unsigned char* skip_ascii(const scanner_t* s, const unsigned char* p)
+{
+	const unsigned char* end = (const unsigned char*)s->end;
+#ifdef PC_NATIVE_X86
+#ifndef PC_NATIVE_NO_AVX2
+	if (s->avx2) return skip_ascii_avx2(p, end);
+#endif
+	return skip_ascii_sse2(p, end);
+#else
+	(void)s;
+	return skip_ascii_scalar(p, end);
+#endif
+}
+
+/** Returns the first occurrence of any of 4 characters from a position, the
+ * end of the document if none
+ */
+static inline const char* find4(const scanner_t* s, const char* p, char c1, char c2, char c3, char c4)
+{
+#ifdef PC_NATIVE_X86
+#ifndef PC_NATIVE_NO_AVX2
+	if (s->avx2) return find_avx2(p, s->end, c1, c2, c3, c4);
+#endif
+	return find_sse2(p, s->end, c1, c2, c3, c4);
+#else
+	return find_scalar(p, s->end, c1, c2, c3, c4);
+#endif
+}
+
+/** Checks a special character of the document
+ *
+ * \param p the first byte of the character
+ * \param end the end of the document
+ * \return the size of the character, 0 if it is not supported
+ */
+static size_t check_char(const unsigned char* p, const unsigned char* end)
+{
+	unsigned c = p[0];
+	if (c < 0x80) return !special_byte(c);
+
+	size_t width;
+	uint32_t value;
+	if ((c & 0xE0) == 0xC0) {
+		width = 2;
+		value = c & 0x1F;
+	} else if ((c & 0xF0) == 0xE0) {
+		width = 3;
+		value = c & 0x0F;
+	} else if ((c & 0xF8) == 0xF0) {
+		width = 4;
+		value = c & 0x07;
+	} else {
+		return 0;
+	}
+	if ((size_t)(end - p) < width) return 0;
+	for (size_t idx = 1; idx < width; ++idx) {
+		if ((p[idx] & 0xC0) != 0x80) return 0;
+		value = (value << 6) | (p[idx] & 0x3F);
+	}
+	if ((width == 2 && value < 0x80) || (width == 3 && value < 0x800) || (width == 4 && value < 0x10000)) return 0;
+	// NEL, LS & PS are line breaks for YAML, BOMs are only allowed at the start, which is not supported either
+	if (value == 0x85 || value == 0x2028 || value == 0x2029 || value == 0xFEFF) return 0;
+	// the printable characters libyaml accepts
+	if ((value >= 0xA0 && value <= 0xD7FF) || (value >= 0xE000 && value <= 0xFFFD) || (value >= 0x10000 && value <= 0x10FFFF)) return width;
+	return 0;
+}
+
+/** Checks the characters of the whole document
+ *
+ * Line breaks other than '\n' and characters libyaml rejects are not supported.
+ *
+ * \param s the scanner
+ * \return whether all characters are supported
+ */
+static int check_input(const scanner_t* s)
+{
+	const unsigned char* p = (const unsigned char*)s->cur;
+	const unsigned char* end = (const unsigned char*)s->end;
+	for (;;) {
+		p = skip_ascii(s, p);
+		if (p == end) return 1;
+		size_t width = check_char(p, end);
+		if (!width) return 0;
+		p += width;
+	}
+}
+
+/** Returns whether a position is followed by a blank: a space, a line break
+ * or the end of the document
+ */
+static inline int blank_at(const scanner_t* s, const char* p)
+{
+	return p == s->end || *p == ' ' || *p == '\n';
+}
+
+/** Returns whether a block sequence entry starts at a position of the document
+ */
+static inline int dash_at(const scanner_t* s, const char* p)
+{
+	return *p == '-' && blank_at(s, p + 1);
+}
+
+/** Returns whether a document marker starts at a position of the document
+ */
+static inline int marker_at(const scanner_t* s, const char* p)
+{
+	return s->end - p >= 3 && (!memcmp(p, "---", 3) || !memcmp(p, "...", 3)) && blank_at(s, p + 3);
+}
+
+/** Moves to the first content character of the next line that has one
+ *
+ * \param s the scanner, positioned at the start of a line
+ * \return whether the line is supported
+ */
+static int next_line(scanner_t* s)
+{
+	const char* line = s->cur;
+	for (;;) {
+		const char* p = line;
+		while (p < s->end && *p == ' ')
+			++p;
+		if (p < s->end && *p == '\t') return 0;
+		if (p < s->end && *p != '\n' && *p != '#') {
+			s->cur = p;
+			s->indent = p - line;
+			return p != line || !marker_at(s, p);
+		}
+		if (p < s->end) p = memchr(p, '\n', s->end - p);
+		if (!p || p == s->end) {
+			s->cur = s->end;
+			s->indent = -1;
+			return 1;
+		}
+		line = p + 1;
+	}
+}
+
+/** Moves to the next line once the content of the current one is read, only
+ * a comment may follow
+ *
+ * \param s the scanner
+ * \param p the position following the content
+ * \return whether the remaining of the line is supported
+ */
+static int finish_line(scanner_t* s, const char* p)
+{
+	const char* q = p;
+	while (q < s->end && *q == ' ')
+		++q;
+	if (q < s->end && *q != '\n') {
+		// a comment must be separated from the content
+		if (*q != '#' || q == p) return 0;
+		q = memchr(q, '\n', s->end - q);
+		if (!q) q = s->end;
+	}
+	s->cur = q < s->end ? q + 1 : q;
+	return next_line(s);
+}
+
+/** Returns whether a plain scalar may start at a position of the document,
+ * the cases where libyaml allows indicators are not supported
+ */
+static int plain_start(const scanner_t* s, const char* p)
+{
+	switch (*p) {
+	case '-':
+		return !blank_at(s, p + 1);
+	case '?':
+	case ':':
+	case ',':
+	case '[':
+	case ']':
+	case '{':
+	case '}':
+	case '#':
+	case '&':
+	case '*':
+	case '!':
+	case '|':
+	case '>':
+	case '\'':
+	case '"':
+	case '%':
+	case '@':
+	case '`':
+	case ' ':
+	case '\t':
+	case '\n':
+		return 0;
+	default:
+		return 1;
+	}
+}
+
+/** Scans a single-line quoted scalar
+ *
+ * \param s the scanner
+ * \param p the opening quote
+ * \param[out] token the scalar
+ * \return whether the scalar is supported
+ */
+static int scan_quoted(const scanner_t* s, const char* p, token_t* token)
+{
+	char quote = *p;
+	token->style = quote == '\'' ? YAML_SINGLE_QUOTED_SCALAR_STYLE : YAML_DOUBLE_QUOTED_SCALAR_STYLE;
+	token->start = ++p;
+	for (;;) {
+		p = quote == '\'' ? find4(s, p, '\'', '\n', '\'', '\'') : find4(s, p, '"', '\\', '\n', '"');
+		if (p == s->end || *p == '\n') return 0; // multi-line or unterminated
+		if (*p == '\\') {
+			if (p + 1 == s->end || p[1] == '\n') return 0;
+			p += 2;
+		} else if (quote == '\'' && p + 1 < s->end && p[1] == '\'') {
+			p += 2;
+		} else {
+			token->stop = p;
+			token->next = p + 1;
+			return 1;
+		}
+	}
+}
+
+/** Scans the key of a block mapping pair
+ *
+ * \param s the scanner
+ * \param p the start of the key
+ * \param[out] token the key, token->next is after the ':' indicator
+ * \return 1 for a key, 0 if there is none, -1 if it is not supported
+ */
+static int scan_key(const scanner_t* s, const char* p, token_t* token)
+{
+	const char* q;
+	if (*p == '\'' || *p == '"') {
+		if (!scan_quoted(s, p, token)) return -1;
+		q = token->next;
+		while (q < s->end && *q == ' ')
+			++q;
+		if (q == s->end || *q != ':' || !blank_at(s, q + 1)) return 0;
+	} else {
+		if (!plain_start(s, p)) return -1;
+		token->start = p;
+		token->style = YAML_PLAIN_SCALAR_STYLE;
+		for (q = p;; ++q) {
+			q = find4(s, q, ':', '#', '\n', '\t');
+			if (q == s->end || *q == '\n') return 0;
+			if (*q == '\t') return -1;
+			if (*q == '#' && q[-1] == ' ') return 0;
+			if (*q == ':' && blank_at(s, q + 1)) break;
+		}
+		token->stop = q;
+		while (token->stop[-1] == ' ')
+			--token->stop;
+	}
+	if (q - p > PC_NATIVE_MAX_KEY) return -1;
+	token->next = q + 1;
+	return 1;
+}
+
+/** Scans a plain scalar that is not a key
+ *
+ * \param s the scanner
+ * \param p the start of the scalar
+ * \param[out] token the scalar
+ * \return whether the scalar is supported
+ */
+static int scan_plain(const scanner_t* s, const char* p, token_t* token)
+{
+	if (!plain_start(s, p)) return 0;
+	token->start = p;
+	token->style = YAML_PLAIN_SCALAR_STYLE;
+	const char* q;
+	for (q = p;; ++q) {
+		q = find4(s, q, ':', '#', '\n', '\t');
+		if (q == s->end || *q == '\n') break;
+		if (*q == '\t') return 0;
+		if (*q == '#' && q[-1] == ' ') break;
+		if (*q == ':' && blank_at(s, q + 1)) return 0; // a key where a scalar is expected
+	}
+	while (q[-1] == ' ')
+		--q;
+	token->stop = q;
+	token->next = q;
+	return 1;
+}
+
+/** Returns a buffer of at least a given size
+ */
+static char* get_scratch(scanner_t* s, size_t size)
+{
+	if (size > s->scratch_size) {
+		char* scratch = realloc(s->scratch, size);
+		if (!scratch) return NULL;
+		s->scratch = scratch;
+		s->scratch_size = size;
+	}
+	return s->scratch;
+}
+
+/** Writes a code point in UTF-8
+ *
+ * \return the position following the code point
+ */
+static char* put_utf8(char* out, uint32_t value)
+{
+	if (value < 0x80) {
+		*out++ = value;
+	} else if (value < 0x800) {
+		*out++ = 0xC0 | (value >> 6);
+		*out++ = 0x80 | (value & 0x3F);
+	} else if (value < 0x10000) {
+		*out++ = 0xE0 | (value >> 12);
+		*out++ = 0x80 | ((value >> 6) & 0x3F);
+		*out++ = 0x80 | (value & 0x3F);
+	} else {
+		*out++ = 0xF0 | (value >> 18);
+		*out++ = 0x80 | ((value >> 12) & 0x3F);
+		*out++ = 0x80 | ((value >> 6) & 0x3F);
+		*out++ = 0x80 | (value & 0x3F);
+	}
+	return out;
+}
+
+/** Returns the value of an hexadecimal digit, -1 for another character
+ */
+static int hex_digit(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/** Unescapes the value of a double-quoted scalar
+ *
+ * \param src the escaped value
+ * \param len the length of src
+ * \param out a buffer of at least 2*len bytes receiving the value
+ * \param[out] out_len the length of the value
+ * \return whether all escapes are valid
+ */
+static int unescape_double(const char* src, size_t len, char* out, size_t* out_len)
+{
+	const char* end = src + len;
+	char* o = out;
+	while (src < end) {
+		const char* backslash = memchr(src, '\\', end - src);
+		if (!backslash) backslash = end;
+		memcpy(o, src, backslash - src);
+		o += backslash - src;
+		src = backslash;
+		if (src == end) break;
+
+		// scan_quoted ensures a backslash is followed by a character
+		char c = src[1];
+		src += 2;
+		int nb_digits = 0;
+		switch (c) {
+		case '0':
+			*o++ = '\0';
+			break;
+		case 'a':
+			*o++ = '\a';
+			break;
+		case 'b':
+			*o++ = '\b';
+			break;
+		case 't':
+		case '\t':
+			*o++ = '\t';
+			break;
+		case 'n':
+			*o++ = '\n';
+			break;
+		case 'v':
+			*o++ = '\v';
+			break;
+		case 'f':
+			*o++ = '\f';
+			break;
+		case 'r':
+			*o++ = '\r';
+			break;
+		case 'e':
+			*o++ = '\x1B';
+			break;
+		case ' ':
+		case '"':
+		case '/':
+		case '\\':
+			*o++ = c;
+			break;
+		case 'N':
+			o = put_utf8(o, 0x85);
+			break;
+		case '_':
+			o = put_utf8(o, 0xA0);
+			break;
+		case 'L':
+			o = put_utf8(o, 0x2028);
+			break;
+		case 'P':
+			o = put_utf8(o, 0x2029);
+			break;
+		case 'x':
+			nb_digits = 2;
+			break;
+		case 'u':
+			nb_digits = 4;
+			break;
+		case 'U':
+			nb_digits = 8;
+			break;
+		default:
+			return 0;
+		}
+		if (nb_digits) {
+			if (end - src < nb_digits) return 0;
+			uint32_t value = 0;
+			for (int digit = 0; digit < nb_digits; ++digit) {
+				int digit_value = hex_digit(src[digit]);
+				if (digit_value < 0) return 0;
+				value = (value << 4) | digit_value;
+			}
+			if ((value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF) return 0;
+			o = put_utf8(o, value);
+			src += nb_digits;
+		}
+	}
+	*out_len = o - out;
+	return 1;
+}
+
+/** Adds a scalar to the document
+ *
+ * \param s the scanner
+ * \param token the scalar
+ * \param[out] id the id of the node added
+ * \return whether the scalar was added
+ */
+static int add_scalar(scanner_t* s, const token_t* token, int* id)
+{
+	const char* value = token->start;
+	size_t len = token->stop - token->start;
+	if (token->style == YAML_SINGLE_QUOTED_SCALAR_STYLE && memchr(value, '\'', len)) {
+		char* out = get_scratch(s, len);
+		if (!out) return 0;
+		size_t out_len = 0;
+		for (size_t idx = 0; idx < len; ++idx) {
+			out[out_len++] = value[idx];
+			if (value[idx] == '\'') ++idx; // quotes are doubled
+		}
+		value = out;
+		len = out_len;
+	} else if (token->style == YAML_DOUBLE_QUOTED_SCALAR_STYLE && memchr(value, '\\', len)) {
+		char* out = get_scratch(s, 2 * len);
+		if (!out || !unescape_double(value, len, out, &len)) return 0;
+		value = out;
+	}
+	if (len > INT_MAX) return 0;
+	*id = yaml_document_add_scalar(s->document, NULL, (const yaml_char_t*)value, (int)len, token->style);
+	return *id != 0;
+}
+
+static int parse_block(scanner_t* s, int* id);
+
+static int parse_mapping(scanner_t* s, int col, int* id);
+
+static int parse_sequence(scanner_t* s, int col, int* id);
+
+/** Parses the node following a ':' or '-' indicator, on the same line or the
+ * next ones
+ *
+ * \param s the scanner
+ * \param p the position following the indicator
+ * \param col the column of the collection holding the node
+ * \param in_mapping whether the node is the value of a mapping pair rather than an item of a sequence
+ * \param[out] id the id of the node
+ * \return whether the node is supported
+ */
+static int parse_entry(scanner_t* s, const char* p, int col, int in_mapping, int* id)
+{
+	const char* q = p;
+	while (q < s->end && *q == ' ')
+		++q;
+	if (q == s->end || *q == '\n' || *q == '#') {
+		if (!finish_line(s, p)) return 0;
+		if (s->indent > col) return parse_block(s, id);
+		// sequences may be as indented as the key of their pair
+		if (in_mapping && s->indent == col && dash_at(s, s->cur)) return parse_sequence(s, col, id);
+		*id = yaml_document_add_scalar(s->document, NULL, (const yaml_char_t*)"", 0, YAML_PLAIN_SCALAR_STYLE);
+		return *id != 0;
+	}
+
+	if (!in_mapping) {
+		// compact collections start on the line of the item
+		int item_col = col + (q - (p - 1));
+		if (dash_at(s, q)) {
+			s->cur = q;
+			return parse_sequence(s, item_col, id);
+		}
+		token_t key;
+		int is_key = scan_key(s, q, &key);
+		if (is_key < 0) return 0;
+		if (is_key) {
+			s->cur = q;
+			return parse_mapping(s, item_col, id);
+		}
+	}
+
+	token_t value;
+	if (*q == '\'' || *q == '"') {
+		if (!scan_quoted(s, q, &value)) return 0;
+	} else if (!scan_plain(s, q, &value)) {
+		return 0;
+	}
+	if (!add_scalar(s, &value, id) || !finish_line(s, value.next)) return 0;
+	// multi-line scalars are not supported
+	return s->indent <= col;
+}
+
+/** Parses a block mapping
+ *
+ * \param s the scanner, at the first key
+ * \param col the column of the keys
+ * \param[out] id the id of the mapping
+ * \return whether the mapping is supported
+ */
+static int parse_mapping(scanner_t* s, int col, int* id)
+{
+	if (++s->depth > PC_NATIVE_MAX_DEPTH) return 0;
+	*id = yaml_document_add_mapping(s->document, NULL, YAML_BLOCK_MAPPING_STYLE);
+	if (!*id) return 0;
+	for (;;) {
+		token_t key;
+		int key_id, value_id;
+		if (scan_key(s, s->cur, &key) != 1 || !add_scalar(s, &key, &key_id) || !parse_entry(s, key.next, col, 1, &value_id)
+			|| !yaml_document_append_mapping_pair(s->document, *id, key_id, value_id))
+		{
+			return 0;
+		}
+		if (s->indent < col) break;
+		if (s->indent > col) return 0;
+	}
+	--s->depth;
+	return 1;
+}
+
+/** Parses a block sequence
+ *
+ * \param s the scanner, at the first '-' indicator
+ * \param col the column of the indicators
+ * \param[out] id the id of the sequence
+ * \return whether the sequence is supported
+ */
+static int parse_sequence(scanner_t* s, int col, int* id)
+{
+	if (++s->depth > PC_NATIVE_MAX_DEPTH) return 0;
+	*id = yaml_document_add_sequence(s->document, NULL, YAML_BLOCK_SEQUENCE_STYLE);
+	if (!*id) return 0;
+	for (;;) {
+		int item_id;
+		if (!parse_entry(s, s->cur + 1, col, 0, &item_id) || !yaml_document_append_sequence_item(s->document, *id, item_id)) return 0;
+		if (s->indent < col) break;
+		if (s->indent > col) return 0;
+		// the following key of the mapping holding the sequence
+		if (!dash_at(s, s->cur)) break;
+	}
+	--s->depth;
+	return 1;
+}
+
+/** Parses the block collection starting at the current line
+ *
+ * \param s the scanner
+ * \param[out] id the id of the collection
+ * \return whether the collection is supported
+ */
+static int parse_block(scanner_t* s, int* id)
+{
+	if (dash_at(s, s->cur)) return parse_sequence(s, s->indent, id);
+	return parse_mapping(s, s->indent, id);
+}
+
+int pc_native_load(const unsigned char* data, size_t size, yaml_document_t* document)
+{
+	scanner_t s = {(const char*)data, (const char*)data + size, -1, document, NULL, 0, 0, 0};
+#if defined(PC_NATIVE_X86) && !defined(PC_NATIVE_NO_AVX2)
+	__builtin_cpu_init();
+	s.avx2 = __builtin_cpu_supports("avx2");
+#endif
+	if (!check_input(&s)) return 0;
+
+	int start_implicit = 1;
+	if (!next_line(&s)) {
+		// the explicit start of the document is the only marker supported
+		if (*s.cur != '-' || !finish_line(&s, s.cur + 3)) return 0;
+		start_implicit = 0;
+	}
+	if (s.indent < 0) return 0; // empty documents
+
+	if (!yaml_document_initialize(document, NULL, NULL, NULL, start_implicit, 1)) return 0;
+	int root;
+	int loaded = parse_block(&s, &root) && s.indent < 0;
+	free(s.scratch);
+	if (!loaded) {
+		yaml_document_delete(document);
+		return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,34 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef NATIVE_H__
+#define NATIVE_H__
+
+#include <stddef.h>
+
+#include <yaml.h>
+
+/** Loads a document written in the block subset of YAML the native scanner
+ * supports
+ *
+ * The subset is that of most configuration files: block mappings & sequences
+ * whose keys and values are single-line plain or quoted scalars, and comments.
+ * Anything else (flow collections, anchors, aliases, tags, block scalars,
+ * multi-line scalars, tabs, directives, multiple documents, ...) is declined,
+ * as well as all invalid documents, so that libyaml loads them and reports
+ * their errors.
+ *
+ * The document loaded is identical to the one libyaml would load, except for
+ * the marks of the nodes that are not set.
+ *
+ * \param data the document to load
+ * \param size the size of the document in bytes
+ * \param[out] document the document loaded, not initialized if declined
+ * \return whether the document was loaded
+ */
+int pc_native_load(const unsigned char* data, size_t size, yaml_document_t* document);
+
+#endif // NATIVE_H__
@@ -0,0 +1,448 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <float.h>
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number.h"
+#include "number_pow5.h"
+
+/* Floating points are parsed in three steps:
+ * - the decimal digits are accumulated in a 64-bit mantissa w and a power of
+ *   ten q, with up to 19 significant digits,
+ * - if w and 10^q are both exact doubles, the result is w*10^q or w/10^-q,
+ *   exact with IEEE arithmetic (Clinger's fast path),
+ * - otherwise, the Eisel-Lemire algorithm computes the correctly rounded
+ *   result from a 128-bit approximation of 5^q.
+ * When there are more than 19 significant digits, the result is computed for
+ * both the truncated mantissa and the next one, if they differ, the string is
+ * handed to strtod in the "C" locale. Hexadecimal floating points are handed to
+ * strtod in the "C" locale as well.
+ */
+
+/// number of bits of the mantissa of a double, excluding the implicit one
+#define MANTISSA_BITS 52
+
+/// biased exponent of infinity
+#define INFINITE_POWER 0x7FF
+
+/// mantissa accumulation stops before overflowing 19 digits
+#define MANTISSA_LIMIT 1000000000000000000ULL
+
+/// 8 more digits can be accumulated below this without reaching MANTISSA_LIMIT
+#define MANTISSA_LIMIT_8 10000000000ULL
+
+static const double exact_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/** Loads 8 characters as a little-endian 64-bit word
+ */
+static inline uint64_t load_8(const char* str)
+{
+	uint64_t word;
+	memcpy(&word, str, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+	return word;
+}
+
+/** Checks whether 8 characters loaded with load_8 are all decimal digits
+ */
+static inline int is_8_digits(uint64_t word)
+{
+	return !(((word + 0x4646464646464646ULL) | (word - 0x3030303030303030ULL)) & 0x8080808080808080ULL);
+}
+
+/** Converts 8 decimal digits loaded with load_8 to their value
+ */
+static inline uint32_t parse_8_digits(uint64_t word)
+{
+	word -= 0x3030303030303030ULL;
+	word = (word * 10) + (word >> 8);
+	word = (((word & 0x000000FF000000FFULL) * 0x000F424000000064ULL) + (((word >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+	return (uint32_t)word;
+}
+
+/** Returns the value of a digit in base up to 36, 255 for non-digits
+ */
+static inline unsigned digit_value(char chr)
+{
+	if (chr >= '0' && chr <= '9') return chr - '0';
+	chr |= 0x20; // lower case
+	if (chr >= 'a' && chr <= 'z') return chr - 'a' + 10;
+	return 255;
+}
+
+/** Compares a string to a lower case word, ignoring the case of ASCII letters only
+ */
+static inline int ascii_iequals(const char* str, size_t len, const char* word)
+{
+	for (size_t idx = 0; idx < len; ++idx) {
+		if (!word[idx] || (str[idx] | 0x20) != word[idx]) return 0;
+	}
+	return !word[len];
+}
+
+/** Skips leading white spaces, like strtol & strtod in the "C" locale
+ */
+static inline const char* skip_spaces(const char* str, const char* end)
+{
+	while (str != end && (*str == ' ' || (*str >= '\t' && *str <= '\r')))
+		++str;
+	return str;
+}
+
+int pc_parse_long(const char* str, size_t len, long* value)
+{
+	const char* end = str + len;
+	str = skip_spaces(str, end);
+	int negative = 0;
+	if (str != end && (*str == '+' || *str == '-')) negative = *str++ == '-';
+
+	unsigned base = 10;
+	if (end - str >= 2 && str[0] == '0') {
+		switch (str[1] | 0x20) {
+		case 'x':
+			base = 16;
+			str += 2;
+			break;
+		case 'o':
+			base = 8;
+			str += 2;
+			break;
+		case 'b':
+			base = 2;
+			str += 2;
+			break;
+		default:
+			base = 8; // legacy C-style octal
+		}
+	}
+
+	uint64_t result = 0;
+	int nb_digits = 0;
+	if (base == 10) {
+		while (end - str >= 8 && result < MANTISSA_LIMIT_8) {
+			uint64_t word = load_8(str);
+			if (!is_8_digits(word)) break;
+			result = result * 100000000 + parse_8_digits(word);
+			str += 8;
+			nb_digits += 8;
+		}
+	}
+	for (; str != end; ++str) {
+		unsigned digit = digit_value(*str);
+		if (digit >= base) {
+			if (*str == '_' && nb_digits) continue;
+			return 0;
+		}
+		if (result > (UINT64_MAX - digit) / base) return 0;
+		result = result * base + digit;
+		++nb_digits;
+	}
+	if (!nb_digits) return 0;
+
+	if (negative) {
+		if (result > (uint64_t)LONG_MAX + 1) return 0;
+		*value = result ? -(long)(result - 1) - 1 : 0;
+	} else {
+		if (result > LONG_MAX) return 0;
+		*value = result;
+	}
+	return 1;
+}
+
+/** Multiplies two 64-bit integers into a 128-bit one
+ */
+static inline uint64_t mul_128(uint64_t lhs, uint64_t rhs, uint64_t* high)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = (unsigned __int128)lhs * rhs;
+	*high = product >> 64;
+	return (uint64_t)product;
+#else
+	uint64_t lhs_lo = (uint32_t)lhs, lhs_hi = lhs >> 32, rhs_lo = (uint32_t)rhs, rhs_hi = rhs >> 32;
+	uint64_t lo_lo = lhs_lo * rhs_lo, hi_lo = lhs_hi * rhs_lo, lo_hi = lhs_lo * rhs_hi, hi_hi = lhs_hi * rhs_hi;
+	uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+	*high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+	return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+/** Builds a double from its biased exponent and mantissa
+ */
+static inline double make_double(uint64_t mantissa, int32_t power2)
+{
+	uint64_t bits = mantissa | ((uint64_t)power2 << MANTISSA_BITS);
+	double result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+/** Computes the double nearest to w*10^q with the Eisel-Lemire algorithm
+ *
+ * \param w the decimal mantissa, not 0
+ * \param q the power of 10
+ * \return the correctly rounded result
+ */
+static double eisel_lemire(uint64_t w, int64_t q)
+{
+	if (q < PC_POW5_MIN) return 0.;
+	if (q > PC_POW5_MAX) return INFINITY;
+
+	int lz = __builtin_clzll(w);
+	w <<= lz;
+
+	// 128-bit approximation of w * 5^q, the second half of the table entry is
+	// only required when the first product is too close to a rounding boundary
+	size_t index = 2 * (q - PC_POW5_MIN);
+	uint64_t high;
+	uint64_t low = mul_128(w, pc_pow5_128[index], &high);
+	const uint64_t precision_mask = UINT64_MAX >> (MANTISSA_BITS + 3);
+	if ((high & precision_mask) == precision_mask) {
+		uint64_t second_high;
+		mul_128(w, pc_pow5_128[index + 1], &second_high);
+		low += second_high;
+		if (second_high > low) ++high;
+	}
+
+	int upperbit = high >> 63;
+	int shift = upperbit + 64 - MANTISSA_BITS - 3;
+	uint64_t mantissa = high >> shift;
+	// floor(log2(10^q)) + 63, then biased
+	int32_t power2 = (int32_t)((((152170 + 65536) * (int32_t)q) >> 16) + 63) + upperbit - lz + 1023;
+
+	if (power2 <= 0) { // subnormal
+		if (-power2 + 1 >= 64) return 0.;
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		// rounding up may have made it normal
+		return make_double(mantissa, mantissa < (1ULL << MANTISSA_BITS) ? 0 : 1);
+	}
+
+	// exactly halfway between two doubles: round to even, this can only
+	// happen when 5^q is exact in 64 bits
+	if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+		mantissa &= ~1ULL;
+	}
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (2ULL << MANTISSA_BITS)) {
+		mantissa = 1ULL << MANTISSA_BITS;
+		++power2;
+	}
+	mantissa &= ~(1ULL << MANTISSA_BITS);
+	if (power2 >= INFINITE_POWER) return INFINITY;
+	return make_double(mantissa, power2);
+}
+
+/** Computes the double nearest to w*10^q
+ */
+static inline double compute_double(uint64_t w, int64_t q)
+{
+	if (!w) return 0.;
+	if (FLT_EVAL_METHOD == 0 && q >= -22 && q <= 22 && w <= (1ULL << 53)) {
+		return q < 0 ? (double)w / exact_pow10[-q] : (double)w * exact_pow10[q];
+	}
+	return eisel_lemire(w, q);
+}
+
+/** Returns the "C" locale, created on first use
+ */
+static locale_t c_locale(void)
+{
+	static locale_t locale = (locale_t)0;
+	locale_t result = __atomic_load_n(&locale, __ATOMIC_ACQUIRE);
+	if (!result) {
+		locale_t new_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+		if (!new_locale) return (locale_t)0;
+		if (__atomic_compare_exchange_n(&locale, &result, new_locale, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			result = new_locale;
+		} else {
+			freelocale(new_locale);
+		}
+	}
+	return result;
+}
+
+/** Calls strtod in the "C" locale
+ */
+static double strtod_c(const char* str, char** str_end)
+{
+	locale_t locale = c_locale();
+	locale_t previous_locale = locale ? uselocale(locale) : (locale_t)0;
+	double value = strtod(str, str_end);
+	if (locale) uselocale(previous_locale);
+	return value;
+}
+
+/** Parses a valid floating point with more than 19 significant digits using
+ * strtod in the "C" locale
+ *
+ * \param str the string to parse, a valid decimal floating point
+ * \param len the length of the string
+ * \param[in,out] value an approximation of the value, replaced by the exact one
+ */
+static void parse_double_slow(const char* str, size_t len, double* value)
+{
+	char buffer[128];
+	char* copy = len < sizeof(buffer) ? buffer : malloc(len + 1);
+	if (!copy) return; // keep the approximation
+	size_t copy_len = 0;
+	for (size_t idx = 0; idx < len; ++idx) {
+		if (str[idx] != '_') copy[copy_len++] = str[idx];
+	}
+	copy[copy_len] = 0;
+
+	*value = strtod_c(copy, NULL);
+
+	if (copy != buffer) free(copy);
+}
+
+/** Parses a hexadecimal floating point, e.g. 0x1.8p3, using strtod in the "C"
+ * locale
+ *
+ * \param str the string to parse, without leading spaces
+ * \param len the length of the string
+ * \param[out] value the value parsed
+ * \return whether the whole string is a valid hexadecimal floating point
+ */
+static int parse_double_hex(const char* str, size_t len, double* value)
+{
+	char buffer[128];
+	char* copy = len < sizeof(buffer) ? buffer : malloc(len + 1);
+	if (!copy) return 0;
+	memcpy(copy, str, len);
+	copy[len] = 0;
+
+	char* copy_end;
+	*value = strtod_c(copy, &copy_end);
+	int valid = copy_end == copy + len;
+
+	if (copy != buffer) free(copy);
+	return valid;
+}
+
+int pc_parse_double(const char* str, size_t len, double* value)
+{
+	const char* end = str + len;
+	str = skip_spaces(str, end);
+	const char* start = str;
+	int negative = 0;
+	if (str != end && (*str == '+' || *str == '-')) negative = *str++ == '-';
+
+	// YAML .inf & .nan, and the C inf, infinity & nan
+	const char* special = str != end && *str == '.' ? str + 1 : str;
+	if (ascii_iequals(special, end - special, "inf") || ascii_iequals(special, end - special, "infinity")) {
+		*value = negative ? -INFINITY : INFINITY;
+		return 1;
+	}
+	if (ascii_iequals(special, end - special, "nan")) {
+		*value = NAN;
+		return 1;
+	}
+
+	uint64_t mantissa = 0;
+	int64_t exponent = 0;
+	int nb_digits = 0;
+	int truncated = 0;
+
+	// integral part
+	while (end - str >= 8 && mantissa < MANTISSA_LIMIT_8) {
+		uint64_t word = load_8(str);
+		if (!is_8_digits(word)) break;
+		mantissa = mantissa * 100000000 + parse_8_digits(word);
+		str += 8;
+		nb_digits += 8;
+	}
+	for (; str != end; ++str) {
+		unsigned digit = (unsigned char)*str - '0';
+		if (digit > 9) {
+			if (*str == '_' && nb_digits) continue;
+			break;
+		}
+		++nb_digits;
+		if (mantissa < MANTISSA_LIMIT) {
+			mantissa = mantissa * 10 + digit;
+		} else {
+			++exponent;
+			truncated |= digit;
+		}
+	}
+
+	// fractional part
+	if (str != end && *str == '.') {
+		++str;
+		while (end - str >= 8 && mantissa < MANTISSA_LIMIT_8) {
+			uint64_t word = load_8(str);
+			if (!is_8_digits(word)) break;
+			mantissa = mantissa * 100000000 + parse_8_digits(word);
+			exponent -= 8;
+			str += 8;
+			nb_digits += 8;
+		}
+		for (; str != end; ++str) {
+			unsigned digit = (unsigned char)*str - '0';
+			if (digit > 9) {
+				if (*str == '_' && nb_digits) continue;
+				break;
+			}
+			++nb_digits;
+			if (mantissa < MANTISSA_LIMIT) {
+				mantissa = mantissa * 10 + digit;
+				--exponent;
+			} else {
+				truncated |= digit;
+			}
+		}
+	}
+
+	// exponent
+	if (nb_digits && str != end && (*str | 0x20) == 'e') {
+		++str;
+		int exponent_negative = 0;
+		if (str != end && (*str == '+' || *str == '-')) exponent_negative = *str++ == '-';
+		if (str == end) return 0;
+		int64_t explicit_exponent = 0;
+		for (; str != end; ++str) {
+			unsigned digit = (unsigned char)*str - '0';
+			if (digit > 9) break;
+			// beyond that, the result is 0 or infinity anyway
+			if (explicit_exponent < 100000) explicit_exponent = explicit_exponent * 10 + digit;
+		}
+		exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+	}
+
+	if (!nb_digits || str != end) {
+		// hexadecimal, octal, etc. integers are valid floating points too
+		long integer;
+		if (pc_parse_long(start, end - start, &integer)) {
+			*value = integer;
+			return 1;
+		}
+		// as are hexadecimal floating points, as accepted by strtod
+		const char* digits = start != end && (*start == '+' || *start == '-') ? start + 1 : start;
+		if (end - digits > 2 && digits[0] == '0' && (digits[1] | 0x20) == 'x') return parse_double_hex(start, end - start, value);
+		return 0;
+	}
+
+	*value = compute_double(mantissa, exponent);
+	if (truncated && compute_double(mantissa + 1, exponent) != *value) {
+		parse_double_slow(start, end - start, value);
+		return 1;
+	}
+	if (negative) *value = -*value;
+	return 1;
+}
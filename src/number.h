@@ -0,0 +1,40 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef NUMBER_H__
+#define NUMBER_H__
+
+#include <stddef.h>
+
+/** Parses an integer, independently of the locale
+ *
+ * Accepts leading white spaces and an optional sign followed by decimal
+ * digits, `0x` hexadecimal, `0o` octal, `0b` binary or legacy `0` octal
+ * digits, with optional `_` separators between digits.
+ *
+ * \param str the string to parse, null-terminated
+ * \param len the length of the string
+ * \param[out] value the parsed value
+ * \return whether the whole string is a valid integer that fits in a long
+ */
+int pc_parse_long(const char* str, size_t len, long* value);
+
+/** Parses a floating point, independently of the locale
+ *
+ * Accepts leading white spaces and an optional sign followed by decimal
+ * digits with an optional fraction and exponent and optional `_` separators,
+ * `.inf`, `.nan` and their variants as well as any integer accepted by
+ * pc_parse_long. The result is correctly rounded, like strtod in the "C"
+ * locale.
+ *
+ * \param str the string to parse, null-terminated
+ * \param len the length of the string
+ * \param[out] value the parsed value
+ * \return whether the whole string is a valid floating point
+ */
+int pc_parse_double(const char* str, size_t len, double* value);
+
+#endif // NUMBER_H__
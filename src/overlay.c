@@ -0,0 +1,230 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "keyindex.h"
+#include "overlay.h"
+#include "status.h"
+#include "ypath.h"
+
+/* An overlay document only contains the mappings that exist in more than one
+ * layer, merged, along with their keys. The values of their pairs all are a
+ * single placeholder node, the actual value of each pair is found in a table:
+ * either the pair of the top-most layer that has the key, or another merged
+ * mapping of the overlay document. Nothing else is copied, lookups that leave
+ * the merged mappings continue in the layers themselves.
+ */
+
+static const char* nodetype[4] = {"none", "scalar", "sequence", "mapping"};
+
+/** The value of a pair of a merged mapping
+ */
+typedef struct overlay_value_s {
+	/// the mapping holding the value in its layer, or the merged mapping if pair is NULL
+	PC_tree_t tree;
+	/// the pair holding the value in tree, NULL for a merged mapping
+	const yaml_node_pair_t* pair;
+	/// the id of the merged mapping in the overlay document
+	int id;
+} overlay_value_t;
+
+struct pc_overlay_s {
+	/// the number of slots in values
+	size_t nb_slots;
+	/// for each node of the overlay document, the values of its pairs if it is a mapping, NULL otherwise
+	overlay_value_t** values;
+	/// the id of the placeholder node for all values, 0 until created
+	int placeholder;
+};
+
+/** Adds the merge of some mappings to an overlay document
+ *
+ * Keys come in the order they first appear from the lowest layer up. The value
+ * of each key is that of the top-most layer having it, unless it is a mapping
+ * and the layers below have mappings for that key as well, in which case they
+ * are merged recursively.
+ *
+ * \param overlay the tables of the overlay document
+ * \param document the overlay document
+ * \param maps the mappings to merge, lowest priority first
+ * \param nb_maps the number of mappings
+ * \param[out] map_id the id of the merged mapping in the overlay document
+ * \return the status of the execution
+ */
+static PC_status_t merge(pc_overlay_t* overlay, yaml_document_t* document, const PC_tree_t* maps, int nb_maps, int* map_id)
+{
+	PC_status_t status = PC_OK;
+
+	const yaml_node_t* top = maps[nb_maps - 1].node;
+	*map_id = yaml_document_add_mapping(document, top->tag, top->data.mapping.style);
+	if (!*map_id) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	if (!overlay->placeholder) {
+		overlay->placeholder = yaml_document_add_scalar(document, NULL, (yaml_char_t*)"", 0, YAML_PLAIN_SCALAR_STYLE);
+		if (!overlay->placeholder) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+	}
+	if ((size_t)*map_id > overlay->nb_slots) {
+		size_t nb_slots = 2 * *map_id;
+		overlay_value_t** values = realloc(overlay->values, nb_slots * sizeof(overlay_value_t*));
+		if (!values) {
+			PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+		}
+		memset(values + overlay->nb_slots, 0, (nb_slots - overlay->nb_slots) * sizeof(overlay_value_t*));
+		overlay->values = values;
+		overlay->nb_slots = nb_slots;
+	}
+
+	size_t max_pairs = 0;
+	for (int layer = 0; layer < nb_maps; ++layer) {
+		max_pairs += maps[layer].node->data.mapping.pairs.top - maps[layer].node->data.mapping.pairs.start;
+	}
+	overlay_value_t* values = malloc((max_pairs ? max_pairs : 1) * sizeof(overlay_value_t));
+	PC_tree_t* chain = malloc(nb_maps * sizeof(PC_tree_t));
+	overlay->values[*map_id - 1] = values;
+	if (!values || !chain) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
+	}
+
+	int nb_values = 0;
+	for (int layer = 0; layer < nb_maps; ++layer) {
+		const yaml_node_t* map = maps[layer].node;
+		for (yaml_node_pair_t* pair = map->data.mapping.pairs.start; pair < map->data.mapping.pairs.top; ++pair) {
+			const yaml_node_t* key = yaml_document_get_node(&maps[layer].pcdoc->document, pair->key);
+			if (key->type != YAML_SCALAR_NODE) continue; // out of reach of lookups
+			const char* key_value = (const char*)key->data.scalar.value;
+			size_t key_len = key->data.scalar.length;
+
+			// only the first occurence of a key in the lowest layer having it is handled
+			if (pc_keyindex_find(maps[layer].pcdoc, maps[layer].node, key_value, key_len) != pair) continue;
+			int seen = 0;
+			for (int lower = 0; lower < layer && !seen; ++lower) {
+				seen = pc_keyindex_find(maps[lower].pcdoc, maps[lower].node, key_value, key_len) != NULL;
+			}
+			if (seen) continue;
+
+			// the top-most value shadows the others, unless it is a mapping with mappings below to merge with
+			int nb_layers = 1;
+			for (int upper = layer + 1; upper < nb_maps; ++upper) {
+				nb_layers += pc_keyindex_find(maps[upper].pcdoc, maps[upper].node, key_value, key_len) != NULL;
+			}
+			overlay_value_t* value = &values[nb_values++];
+			value->tree = maps[layer];
+			value->pair = pair;
+			// the values of keys found in a single layer are not needed, they stay unparsed in lazily parsed layers
+			int nb_chain = 0;
+			for (int upper = nb_maps - 1; nb_layers > 1 && upper >= layer; --upper) {
+				yaml_node_pair_t* upper_pair = upper == layer ? pair : pc_keyindex_find(maps[upper].pcdoc, maps[upper].node, key_value, key_len);
+				if (!upper_pair) continue;
+				if (!nb_chain) {
+					value->tree = maps[upper];
+					value->pair = upper_pair;
+				}
+				PC_tree_t upper_value = pc_pair_value(maps[upper], upper_pair);
+				PC_handle_tree_err(upper_value, err1);
+				if (upper_value.node->type != YAML_MAPPING_NODE) break;
+				chain[nb_maps - 1 - nb_chain++] = upper_value;
+			}
+			if (nb_chain > 1) {
+				PC_handle_err(merge(overlay, document, chain + nb_maps - nb_chain, nb_chain, &value->id), err1);
+				value->pair = NULL;
+			}
+
+			int key_id = yaml_document_add_scalar(document, key->tag, key->data.scalar.value, key_len, key->data.scalar.style);
+			if (!key_id || !yaml_document_append_mapping_pair(document, *map_id, key_id, overlay->placeholder)) {
+				PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
+			}
+		}
+	}
+
+err1:
+	free(chain);
+err0:
+	return status;
+}
+
+PC_tree_t PC_overlay(const PC_tree_t* trees, int nb_trees)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+
+	if (nb_trees <= 0) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_PARAMETER, "No tree to overlay\n"), err0);
+	}
+	for (int layer = 0; layer < nb_trees; ++layer) {
+		PC_handle_err_tree(PC_status(trees[layer]), err0);
+		if (!trees[layer].node) {
+			PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a mapping for layer %d, found an empty tree\n", layer), err0);
+		}
+		if (trees[layer].node->type != YAML_MAPPING_NODE) {
+			PC_handle_err_tree(
+				PC_make_err(PC_INVALID_NODE_TYPE, "Expected a mapping for layer %d, found a %s\n", layer, nodetype[trees[layer].node->type]),
+				err0
+			);
+		}
+	}
+
+	pc_overlay_t* overlay = calloc(1, sizeof(pc_overlay_t));
+	yaml_document_t document;
+	if (!overlay || !yaml_document_initialize(&document, NULL, NULL, NULL, 1, 1)) {
+		free(overlay);
+		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	int root_id;
+	PC_handle_err_tree(merge(overlay, &document, trees, nb_trees, &root_id), err1);
+
+	restree = PC_root(&document);
+	restree.pcdoc->overlay = overlay;
+
+	// the merged mappings can only be referred to once the document is complete
+	for (size_t slot = 0; slot < overlay->nb_slots; ++slot) {
+		if (!overlay->values[slot]) continue;
+		const yaml_node_t* map = yaml_document_get_node(&restree.pcdoc->document, slot + 1);
+		for (long pair_idx = 0; pair_idx < map->data.mapping.pairs.top - map->data.mapping.pairs.start; ++pair_idx) {
+			overlay_value_t* value = &overlay->values[slot][pair_idx];
+			if (value->pair) continue;
+			value->tree.status = PC_OK;
+			value->tree.pcdoc = restree.pcdoc;
+			value->tree.node = yaml_document_get_node(&restree.pcdoc->document, value->id);
+		}
+	}
+
+	return restree;
+
+err1:
+	for (size_t slot = 0; slot < overlay->nb_slots; ++slot) {
+		free(overlay->values[slot]);
+	}
+	free(overlay->values);
+	free(overlay);
+	yaml_document_delete(&document);
+err0:
+	return restree;
+}
+
+PC_tree_t pc_overlay_value(PC_tree_t map, const yaml_node_pair_t* pair)
+{
+	const overlay_value_t* value
+		= &map.pcdoc->overlay->values[map.node - map.pcdoc->document.nodes.start][pair - map.node->data.mapping.pairs.start];
+	return value->pair ? pc_pair_value(value->tree, value->pair) : value->tree;
+}
+
+void pc_overlay_destroy(PC_document_t* doc)
+{
+	pc_overlay_t* overlay = doc->overlay;
+	if (!overlay) return;
+	for (size_t slot = 0; slot < overlay->nb_slots; ++slot) {
+		free(overlay->values[slot]);
+	}
+	free(overlay->values);
+	free(overlay);
+	doc->overlay = NULL;
+}
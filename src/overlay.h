@@ -0,0 +1,26 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OVERLAY_H__
+#define OVERLAY_H__
+
+#include "paraconf.h"
+
+#include "ypath.h"
+
+/** Where the values of the mappings of an overlay document are found, one
+ * (possibly NULL) slot per node of the document
+ */
+typedef struct pc_overlay_s pc_overlay_t;
+
+/** Releases the value tables of an overlay document, the layers are left
+ * untouched
+ *
+ * \param doc the document whose tables to release
+ */
+void pc_overlay_destroy(PC_document_t* doc);
+
+#endif // OVERLAY_H__
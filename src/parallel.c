@@ -0,0 +1,606 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "paraconf.h"
+
+#include "stats.h"
+#include "status.h"
+#include "ypath.h"
+
+/* PC_parse_path_parallel splits a file before some of the keys of its root
+ * mapping, those found at column 0 outside of block scalars, quoted scalars and
+ * flow collections. Each chunk is a block mapping of its own, parsed on a
+ * worker thread. The nodes of the chunks are then moved to a single document:
+ * the pairs of their root mappings are appended to the first one and the ids
+ * of their other nodes are shifted by the number of nodes of the chunks
+ * before. As libyaml numbers the nodes in the order they appear, this gives
+ * the same document as a parse of the whole file.
+ *
+ * The split does not need to understand all of YAML: if it is wrong, a chunk
+ * ends inside a quoted scalar or flow collection, or does not hold a block
+ * mapping, and fails to parse. The whole file is then parsed serially, which
+ * also reports the errors the same way PC_parse_path does.
+ */
+
+/// smallest number of bytes worth parsing on a thread of its own
+#define PC_PARALLEL_MIN_CHUNK (256 * 1024)
+
+/// number of chunks per worker, so that the workers finishing first take over the remaining ones
+#define PC_PARALLEL_CHUNKS_PER_WORKER 4
+
+/** The files parsed by a pool of workers
+ */
+typedef struct batch_s {
+	/// the paths of the files
+	const char* const* paths;
+	/// the number of files
+	int nb_paths;
+	/// the parsed trees, one per file
+	PC_tree_t* trees;
+	/// the error messages of the files that could not be parsed, NULL for the others
+	char** messages;
+	/// the index of the next file to parse
+	int next;
+} batch_t;
+
+/** Parses files of a batch until none is left
+ *
+ * \param context the batch
+ * \return NULL
+ */
+static void* batch_worker(void* context)
+{
+	batch_t* batch = context;
+	// errors are collected & reported by the calling thread
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	for (;;) {
+		int path_idx = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+		if (path_idx >= batch->nb_paths) break;
+		batch->trees[path_idx] = PC_parse_path(batch->paths[path_idx]);
+		if (PC_status(batch->trees[path_idx])) batch->messages[path_idx] = strdup(PC_errmsg());
+	}
+	PC_errhandler(handler);
+	return NULL;
+}
+
+PC_status_t PC_parse_paths(const char* const* paths, int nb_paths, int nb_workers, PC_tree_t* trees)
+{
+	PC_status_t status = PC_OK;
+
+	if (nb_paths <= 0) return status;
+	if (nb_workers <= 0) {
+		long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+		nb_workers = nb_cores > 0 ? nb_cores : 1;
+	}
+	if (nb_workers > nb_paths) nb_workers = nb_paths;
+
+	batch_t batch = {paths, nb_paths, trees, calloc(nb_paths, sizeof(char*)), 0};
+	pthread_t* threads = malloc(nb_workers * sizeof(pthread_t));
+	if (!batch.messages || !threads) {
+		PC_tree_t failed = {PC_SYSTEM_ERROR, NULL, NULL};
+		for (int path_idx = 0; path_idx < nb_paths; ++path_idx) {
+			trees[path_idx] = failed;
+		}
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+
+	// the calling thread is a worker as well, the files go to the threads that could be started
+	int nb_threads = 0;
+	while (nb_threads < nb_workers - 1 && !pthread_create(&threads[nb_threads], NULL, batch_worker, &batch)) {
+		++nb_threads;
+	}
+	batch_worker(&batch);
+	for (int thread = 0; thread < nb_threads; ++thread) {
+		pthread_join(threads[thread], NULL);
+	}
+
+	// report all the files in error at once
+	int nb_errors = 0;
+	size_t details_len = 0;
+	for (int path_idx = 0; path_idx < nb_paths; ++path_idx) {
+		if (!PC_status(trees[path_idx])) continue;
+		if (!nb_errors++) status = PC_status(trees[path_idx]);
+		details_len += strlen(paths[path_idx]) + (batch.messages[path_idx] ? strlen(batch.messages[path_idx]) : 0) + 8;
+	}
+	if (nb_errors) {
+		char* details = malloc(details_len + 1);
+		size_t len = 0;
+		for (int path_idx = 0; details && path_idx < nb_paths; ++path_idx) {
+			if (!PC_status(trees[path_idx])) continue;
+			const char* message = batch.messages[path_idx] ? batch.messages[path_idx] : "";
+			size_t msg_len = strlen(message);
+			while (msg_len && message[msg_len - 1] == '\n')
+				--msg_len;
+			len += snprintf(details + len, details_len + 1 - len, "\n  `%s': %.*s", paths[path_idx], (int)msg_len, message);
+		}
+		status = PC_make_err(status, "Unable to parse %d files out of %d:%s\n", nb_errors, nb_paths, details ? details : "");
+		free(details);
+	}
+
+err0:
+	if (batch.messages) {
+		for (int path_idx = 0; path_idx < nb_paths; ++path_idx) {
+			free(batch.messages[path_idx]);
+		}
+	}
+	free(batch.messages);
+	free(threads);
+	return status;
+}
+
+/** A part of a file parsed on its own
+ */
+typedef struct chunk_s {
+	/// offset of the chunk in the file
+	size_t start;
+	/// size of the chunk
+	size_t size;
+	/// the document parsed from the chunk
+	yaml_document_t document;
+	/// whether document is loaded and holds a block mapping
+	int loaded;
+	/// whether document was loaded by a parser backend rather than libyaml, its nodes then have no marks
+	int native;
+	/// number of characters in the chunk, as libyaml counts them in marks
+	size_t nb_chars;
+	/// number of lines in the chunk, as libyaml counts them in marks
+	size_t nb_lines;
+	/// index in the whole document of the first node of the chunk after its root
+	size_t first_node;
+	/// index in the root of the whole document of the first pair of the chunk root
+	size_t first_pair;
+	/// number of characters in the file before the chunk, that its marks are shifted by
+	size_t chars_before;
+	/// number of lines in the file before the chunk, that its marks are shifted by
+	size_t lines_before;
+} chunk_t;
+
+/** The chunks of a file parsed by a pool of workers
+ */
+typedef struct split_s {
+	/// the content of the file
+	const char* data;
+	/// the chunks
+	chunk_t* chunks;
+	/// the number of chunks
+	int nb_chunks;
+	/// whether only the chunks loaded by a backend are loaded, again, with libyaml
+	int libyaml_only;
+	/// the nodes of the whole document the chunks are moved to, NULL while they are parsed
+	yaml_node_t* nodes;
+	/// the pairs of the root of the whole document
+	yaml_node_pair_t* pairs;
+	/// the index of the next chunk to parse
+	int next;
+} split_t;
+
+/** Follows the quoted scalars and flow collections of a line that may span
+ * the following ones
+ *
+ * \param content the start of the line content
+ * \param end the end of the line
+ * \param[in,out] quote the quote of the scalar open at the start of the line, 0 if none
+ * \param[in,out] depth the number of flow collections open at the start of the line
+ * \param[out] block whether the line ends with a block scalar indicator
+ * \return whether the line can be split around, i.e. contains no anchor, alias
+ *         nor line break libyaml counts in marks but the split does not
+ */
+static int scan_line(const char* content, const char* end, char* quote, int* depth, int* block)
+{
+	// most characters play no part in the split, they are skipped by a table lookup
+	static const char special[256] = {
+		['\r'] = 1, ['"'] = 1, ['\''] = 1, ['\\'] = 1, ['#'] = 1, ['['] = 1, ['{'] = 1,
+		[']'] = 1, ['}'] = 1, ['&'] = 1, ['*'] = 1, ['|'] = 1, ['>'] = 1,
+	};
+	const char* indicator = NULL; // the last block scalar indicator
+	for (const char* cur = content; cur < end; ++cur) {
+		while (!special[(unsigned char)*cur]) {
+			if (++cur == end) goto done;
+		}
+		if (*cur == '\r' && cur + 1 != end) return 0;
+		if (*quote) {
+			if (*quote == '"' && *cur == '\\') {
+				++cur;
+			} else if (*quote == '\'' && *cur == '\'' && cur + 1 < end && cur[1] == '\'') {
+				++cur;
+			} else if (*cur == *quote) {
+				*quote = 0;
+			}
+			continue;
+		}
+		int token_start = cur == content || cur[-1] == ' ' || cur[-1] == '\t' || cur[-1] == '[' || cur[-1] == '{' || cur[-1] == ',';
+		switch (*cur) {
+		case '#':
+			if (cur == content || cur[-1] == ' ' || cur[-1] == '\t') goto done; // comment
+			break;
+		case '"':
+		case '\'':
+			if (token_start) *quote = *cur;
+			break;
+		case '[':
+		case '{':
+			if (token_start || *depth) ++*depth;
+			break;
+		case ']':
+		case '}':
+			if (*depth) --*depth;
+			break;
+		case '&':
+		case '*':
+			if (token_start && cur + 1 < end && cur[1] != ' ' && cur[1] != '\t') return 0;
+			break;
+		case '|':
+		case '>':
+			if (token_start) indicator = cur;
+			break;
+		default:
+			break;
+		}
+	}
+
+done:
+	// the indicator must be the last token of the line, only followed by its modifiers & a comment
+	*block = 0;
+	if (!*quote && !*depth && indicator) {
+		const char* cur = indicator + 1;
+		while (cur < end && (*cur == '+' || *cur == '-' || (*cur >= '0' && *cur <= '9')))
+			++cur;
+		while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r'))
+			++cur;
+		*block = cur == end || *cur == '#';
+	}
+	return 1;
+}
+
+/** Splits a file in chunks before keys of its root mapping
+ *
+ * \param data the content of the file
+ * \param size the size of the file
+ * \param max_chunks the maximum number of chunks
+ * \param[out] chunks the max_chunks chunks, in order
+ * \return the number of chunks, 0 if the file can not be split
+ */
+static int split_chunks(const char* data, size_t size, int max_chunks, chunk_t* chunks)
+{
+	if (size >= 3 && !memcmp(data, "\xEF\xBB\xBF", 3)) return 0; // byte order mark
+
+	size_t chunk_size = size / max_chunks;
+	int nb_chunks = 1;
+	chunks[0].start = 0;
+
+	char quote = 0;
+	int depth = 0;
+	long block_indent = -1; // the indentation of the line starting the current block scalar, -1 outside of one
+	int root_seen = 0;
+	for (size_t pos = 0; pos < size;) {
+		const char* begin = data + pos;
+		const char* eol = memchr(begin, '\n', size - pos);
+		const char* end = eol ? eol : data + size;
+		pos = end - data + 1;
+
+		const char* content = begin;
+		while (content < end && *content == ' ')
+			++content;
+		int blank = content == end || *content == '\r';
+		if (block_indent >= 0) {
+			if (blank || content - begin > block_indent) continue;
+			block_indent = -1;
+		}
+		if (!quote && !depth) {
+			if (blank || *content == '#') continue;
+			if (content > begin) {
+				if (!root_seen) return 0; // the root must start at column 0
+			} else if (end - begin >= 3 && (!memcmp(begin, "---", 3) || !memcmp(begin, "...", 3))
+			           && (end - begin == 3 || begin[3] == ' ' || begin[3] == '\t' || begin[3] == '\r'))
+			{
+				// only the start of the first document
+				if (root_seen || *begin == '.') return 0;
+				content = begin + 3;
+			} else if (*begin == '%') {
+				return 0; // directives
+			} else {
+				if (root_seen && nb_chunks < max_chunks && (size_t)(begin - data) >= chunks[nb_chunks - 1].start + chunk_size
+				    && !strchr("-?:,[]{}#&*!|>%@`\t", *begin))
+				{
+					chunks[nb_chunks++].start = begin - data;
+				}
+				root_seen = 1;
+			}
+		}
+		int block;
+		if (!scan_line(content, end, &quote, &depth, &block)) return 0;
+		if (block) block_indent = content - begin;
+	}
+
+	for (int idx = 0; idx < nb_chunks; ++idx) {
+		chunks[idx].size = (idx + 1 < nb_chunks ? chunks[idx + 1].start : size) - chunks[idx].start;
+		chunks[idx].loaded = 0;
+	}
+	return nb_chunks;
+}
+
+/** Counts the characters & lines of a chunk as libyaml does in marks
+ */
+static void count_marks(const unsigned char* data, size_t size, chunk_t* chunk)
+{
+	size_t nb_chars = 0, nb_lines = 0;
+	for (size_t idx = 0; idx < size; ++idx) {
+		unsigned char c = data[idx];
+		if ((c & 0xC0) != 0x80) ++nb_chars;
+		if (c == '\n' || (c == '\r' && (idx + 1 == size || data[idx + 1] != '\n'))) {
+			++nb_lines;
+		} else if (c == 0x85 && idx >= 1 && data[idx - 1] == 0xC2) {
+			++nb_lines; // NEL
+		} else if ((c == 0xA8 || c == 0xA9) && idx >= 2 && data[idx - 1] == 0x80 && data[idx - 2] == 0xE2) {
+			++nb_lines; // LS & PS
+		}
+	}
+	chunk->nb_chars = nb_chars;
+	chunk->nb_lines = nb_lines;
+}
+
+/** Parses a chunk
+ *
+ * \param split the chunks of the file
+ * \param chunk the chunk to parse, loaded if it holds a block mapping
+ */
+static void load_chunk(const split_t* split, chunk_t* chunk)
+{
+	const unsigned char* data = (const unsigned char*)split->data + chunk->start;
+	chunk->native = !split->libyaml_only && pc_backend_load(data, chunk->size, &chunk->document);
+	if (!chunk->native) {
+		yaml_parser_t parser;
+		if (!yaml_parser_initialize(&parser)) return;
+		yaml_parser_set_input_string(&parser, data, chunk->size);
+		int loaded = yaml_parser_load(&parser, &chunk->document);
+		yaml_parser_delete(&parser);
+		if (!loaded) return;
+		count_marks(data, chunk->size, chunk);
+	}
+
+	// the chunks after the first one start with a key, their root can not be tagged
+	yaml_node_t* root = yaml_document_get_root_node(&chunk->document);
+	if (!root || root->type != YAML_MAPPING_NODE || root->data.mapping.style != YAML_BLOCK_MAPPING_STYLE
+	    || (chunk != split->chunks && strcmp((const char*)root->tag, YAML_DEFAULT_MAPPING_TAG)))
+	{
+		yaml_document_delete(&chunk->document);
+		return;
+	}
+	chunk->loaded = 1;
+}
+
+/** Moves a mark of a chunk to its position in the whole file
+ */
+static void shift_mark(yaml_mark_t* mark, size_t nb_chars, size_t nb_lines)
+{
+	mark->index += nb_chars;
+	mark->line += nb_lines;
+}
+
+/** Moves the nodes of a chunk to the whole document, shifting their ids &
+ * marks, and frees what remains of the chunk
+ *
+ * \param split the chunks of the file, with the whole document nodes
+ * \param chunk the loaded chunk to move, emptied
+ */
+static void move_chunk(const split_t* split, chunk_t* chunk)
+{
+	yaml_node_t* root = chunk->document.nodes.start;
+	int shift = (int)chunk->first_node - 1; // node 1 of the chunk, its root, is node 1 of the document
+	yaml_node_pair_t* pairs = split->pairs + chunk->first_pair;
+	for (yaml_node_pair_t* pair = root->data.mapping.pairs.start; pair < root->data.mapping.pairs.top; ++pair) {
+		pairs->key = pair->key + shift;
+		pairs->value = pair->value + shift;
+		++pairs;
+	}
+	yaml_node_t* moved = split->nodes + chunk->first_node;
+	for (yaml_node_t* node = root + 1; node < chunk->document.nodes.top; ++node, ++moved) {
+		*moved = *node;
+		if (moved->type == YAML_SEQUENCE_NODE) {
+			for (yaml_node_item_t* item = moved->data.sequence.items.start; item < moved->data.sequence.items.top; ++item) {
+				*item += shift;
+			}
+		} else if (moved->type == YAML_MAPPING_NODE) {
+			for (yaml_node_pair_t* pair = moved->data.mapping.pairs.start; pair < moved->data.mapping.pairs.top; ++pair) {
+				pair->key += shift;
+				pair->value += shift;
+			}
+		}
+		if (!chunk->native) {
+			shift_mark(&moved->start_mark, chunk->chars_before, chunk->lines_before);
+			shift_mark(&moved->end_mark, chunk->chars_before, chunk->lines_before);
+		}
+	}
+
+	// the root tag of the first chunk is that of the whole document root
+	if (chunk != split->chunks) free(root->tag);
+	free(root->data.mapping.pairs.start);
+	free(chunk->document.nodes.start);
+	chunk->loaded = 0;
+}
+
+/** Parses chunks of a file, or moves them to the whole document, until none
+ * is left
+ *
+ * \param context the chunks
+ * \return NULL
+ */
+static void* chunk_worker(void* context)
+{
+	split_t* split = context;
+	for (;;) {
+		int chunk_idx = __atomic_fetch_add(&split->next, 1, __ATOMIC_RELAXED);
+		if (chunk_idx >= split->nb_chunks) break;
+		chunk_t* chunk = &split->chunks[chunk_idx];
+		if (split->nodes) {
+			move_chunk(split, chunk);
+			continue;
+		}
+		if (split->libyaml_only) {
+			if (!chunk->loaded || !chunk->native) continue;
+			yaml_document_delete(&chunk->document);
+			chunk->loaded = 0;
+		}
+		load_chunk(split, chunk);
+	}
+	return NULL;
+}
+
+/** Parses or moves the chunks of a file with a pool of workers
+ *
+ * \param split the chunks
+ * \param threads the threads to start
+ * \param nb_workers the number of workers, the calling thread included
+ */
+static void run_workers(split_t* split, pthread_t* threads, int nb_workers)
+{
+	split->next = 0;
+	int nb_threads = 0;
+	while (nb_threads < nb_workers - 1 && !pthread_create(&threads[nb_threads], NULL, chunk_worker, split)) {
+		++nb_threads;
+	}
+	chunk_worker(split);
+	for (int thread = 0; thread < nb_threads; ++thread) {
+		pthread_join(threads[thread], NULL);
+	}
+}
+
+/** Moves the nodes of the chunks of a file to a single document
+ *
+ * \param split the loaded chunks, emptied
+ * \param threads the threads to start
+ * \param nb_workers the number of workers, the calling thread included
+ * \param[out] document the document of the whole file
+ * \return whether the document could be built, it fails on memory shortage
+ */
+static int stitch_chunks(split_t* split, pthread_t* threads, int nb_workers, yaml_document_t* document)
+{
+	// each chunk takes its place after the previous ones, so that they can be moved concurrently
+	size_t nb_nodes = 1, nb_pairs = 0, nb_chars = 0, nb_lines = 0;
+	for (int chunk_idx = 0; chunk_idx < split->nb_chunks; ++chunk_idx) {
+		chunk_t* chunk = &split->chunks[chunk_idx];
+		yaml_node_t* root = chunk->document.nodes.start;
+		chunk->first_node = nb_nodes;
+		chunk->first_pair = nb_pairs;
+		chunk->chars_before = nb_chars;
+		chunk->lines_before = nb_lines;
+		nb_nodes += chunk->document.nodes.top - root - 1;
+		nb_pairs += root->data.mapping.pairs.top - root->data.mapping.pairs.start;
+		if (!chunk->native) {
+			nb_chars += chunk->nb_chars;
+			nb_lines += chunk->nb_lines;
+		}
+	}
+	if (nb_nodes > INT_MAX) return 0;
+	split->nodes = malloc(nb_nodes * sizeof(yaml_node_t));
+	split->pairs = malloc(nb_pairs * sizeof(yaml_node_pair_t));
+	if (!split->nodes || !split->pairs) {
+		free(split->nodes);
+		free(split->pairs);
+		split->nodes = NULL;
+		return 0;
+	}
+
+	// the document & its root take the directives, tags and start marks of the first chunk, and the end marks of the last one
+	chunk_t* last = &split->chunks[split->nb_chunks - 1];
+	*document = split->chunks[0].document;
+	document->nodes.start = split->nodes;
+	document->nodes.end = split->nodes + nb_nodes;
+	document->nodes.top = split->nodes + nb_nodes;
+	document->end_implicit = last->document.end_implicit;
+	document->end_mark = last->document.end_mark;
+	split->nodes[0] = *split->chunks[0].document.nodes.start;
+	split->nodes[0].data.mapping.pairs.start = split->pairs;
+	split->nodes[0].data.mapping.pairs.end = split->pairs + nb_pairs;
+	split->nodes[0].data.mapping.pairs.top = split->pairs + nb_pairs;
+	split->nodes[0].end_mark = last->document.nodes.start->end_mark;
+	if (!last->native) {
+		shift_mark(&document->end_mark, last->chars_before, last->lines_before);
+		shift_mark(&split->nodes[0].end_mark, last->chars_before, last->lines_before);
+	}
+
+	run_workers(split, threads, nb_workers);
+	return 1;
+}
+
+PC_tree_t PC_parse_path_parallel(const char* path, int nb_workers)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+	PC_STATS_START(start);
+
+	if (nb_workers <= 0) {
+		long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+		nb_workers = nb_cores > 0 ? nb_cores : 1;
+	}
+
+	// anything but a regular file large enough to be split is parsed serially, errors included
+	int conf_fd = open(path, O_RDONLY);
+	if (conf_fd < 0) return PC_parse_path(path);
+	struct stat conf_stat;
+	void* data = MAP_FAILED;
+	if (nb_workers > 1 && !fstat(conf_fd, &conf_stat) && S_ISREG(conf_stat.st_mode) && conf_stat.st_size >= 2 * PC_PARALLEL_MIN_CHUNK) {
+		data = mmap(NULL, conf_stat.st_size, PROT_READ, MAP_PRIVATE, conf_fd, 0);
+	}
+	close(conf_fd);
+	if (data == MAP_FAILED) return PC_parse_path(path);
+	size_t size = conf_stat.st_size;
+
+	size_t max_chunks = size / PC_PARALLEL_MIN_CHUNK;
+	if (max_chunks > (size_t)nb_workers * PC_PARALLEL_CHUNKS_PER_WORKER) max_chunks = (size_t)nb_workers * PC_PARALLEL_CHUNKS_PER_WORKER;
+	split_t split = {data, malloc(max_chunks * sizeof(chunk_t)), 0, 0, NULL, NULL, 0};
+	pthread_t* threads = malloc(nb_workers * sizeof(pthread_t));
+	if (!split.chunks || !threads) goto serial;
+	split.nb_chunks = split_chunks(data, size, max_chunks, split.chunks);
+	if (split.nb_chunks < 2) goto serial;
+
+	run_workers(&split, threads, nb_workers < split.nb_chunks ? nb_workers : split.nb_chunks);
+	int nb_native = 0;
+	for (int chunk_idx = 0; chunk_idx < split.nb_chunks; ++chunk_idx) {
+		if (!split.chunks[chunk_idx].loaded) goto serial;
+		nb_native += split.chunks[chunk_idx].native;
+	}
+	// the chunks are all loaded the same way, so that their nodes all have marks or none has
+	if (nb_native && nb_native < split.nb_chunks) {
+		split.libyaml_only = 1;
+		run_workers(&split, threads, nb_workers < nb_native ? nb_workers : nb_native);
+		for (int chunk_idx = 0; chunk_idx < split.nb_chunks; ++chunk_idx) {
+			if (!split.chunks[chunk_idx].loaded) goto serial;
+		}
+	}
+
+	yaml_document_t document;
+	if (!stitch_chunks(&split, threads, nb_workers < split.nb_chunks ? nb_workers : split.nb_chunks, &document)) goto serial;
+	free(threads);
+	free(split.chunks);
+	munmap(data, size);
+
+	restree = PC_root(&document);
+	if (PC_status(restree)) return restree;
+	restree.pcdoc->path = strdup(path);
+	PC_STATS_PARSED(restree.pcdoc, start, size);
+	return restree;
+
+serial:
+	for (int chunk_idx = 0; chunk_idx < split.nb_chunks; ++chunk_idx) {
+		if (split.chunks[chunk_idx].loaded) yaml_document_delete(&split.chunks[chunk_idx].document);
+	}
+	free(threads);
+	free(split.chunks);
+	munmap(data, size);
+	return PC_parse_path(path);
+}
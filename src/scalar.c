@@ -0,0 +1,61 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+
+#include "paraconf.h"
+
+#include "scalar.h"
+#include "status.h"
+#include "ypath.h"
+
+PC_status_t PC_tree_resolve(PC_tree_t tree)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	PC_document_t* doc = tree.pcdoc;
+	if (__atomic_load_n(&doc->scalars, __ATOMIC_ACQUIRE)) return status; // already resolved
+
+	size_t nb_nodes = doc->document.nodes.top - doc->document.nodes.start;
+	pc_scalars_t* scalars = malloc(sizeof(pc_scalars_t) + nb_nodes * sizeof(pc_scalar_t));
+	if (!scalars) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	scalars->nb_nodes = nb_nodes;
+
+	for (size_t node_idx = 0; node_idx < nb_nodes; ++node_idx) {
+		const yaml_node_t* node = doc->document.nodes.start + node_idx;
+		pc_scalar_t* scalar = scalars->values + node_idx;
+		scalar->int_value = 0;
+		scalar->double_value = 0;
+		scalar->flags = 0;
+		if (node->type != YAML_SCALAR_NODE) continue;
+		if (scalar_long(node, &scalar->int_value)) scalar->flags |= PC_SCALAR_INT;
+		if (scalar_double(node, &scalar->double_value)) scalar->flags |= PC_SCALAR_DOUBLE;
+		int bool_value;
+		if (scalar_bool(node, &bool_value)) scalar->flags |= PC_SCALAR_BOOL | (bool_value ? PC_SCALAR_TRUE : 0);
+	}
+
+	// concurrent resolutions of the same document keep the first one
+	pc_scalars_t* expected = NULL;
+	if (__atomic_compare_exchange_n(&doc->scalars, &expected, scalars, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		PC_STATS_ALLOC(doc, sizeof(pc_scalars_t) + nb_nodes * sizeof(pc_scalar_t));
+	} else {
+		free(scalars);
+	}
+
+	return status;
+
+err0:
+	return status;
+}
+
+void pc_scalars_destroy(PC_document_t* doc)
+{
+	free(doc->scalars);
+	doc->scalars = NULL;
+}
@@ -0,0 +1,159 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SCALAR_H__
+#define SCALAR_H__
+
+#include <stddef.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "number.h"
+#include "ypath.h"
+
+/// the scalar is a valid integer
+#define PC_SCALAR_INT 0x1
+
+/// the scalar is a valid floating point
+#define PC_SCALAR_DOUBLE 0x2
+
+/// the scalar is a valid boolean
+#define PC_SCALAR_BOOL 0x4
+
+/// the scalar is a valid boolean and its value is true
+#define PC_SCALAR_TRUE 0x8
+
+/** The pre-converted values of a scalar node
+ */
+typedef struct pc_scalar_s {
+	/// the integer value, if flags has PC_SCALAR_INT
+	long int_value;
+
+	/// the floating point value, if flags has PC_SCALAR_DOUBLE
+	double double_value;
+
+	/// the valid conversions of the scalar, a combination of PC_SCALAR_*
+	int flags;
+
+} pc_scalar_t;
+
+struct pc_scalars_s {
+	/// number of nodes in the document
+	size_t nb_nodes;
+
+	/// the values of each node indexed by node id - 1, flags is 0 for non-scalar nodes
+	pc_scalar_t values[];
+};
+
+/** Converts a scalar node to an integer
+ * \return whether the conversion succeeded
+ */
+static inline int scalar_long(const yaml_node_t* node, long* res)
+{
+	return pc_parse_long((const char*)node->data.scalar.value, node->data.scalar.length, res);
+}
+
+/** Converts a scalar node to a floating point
+ * \return whether the conversion succeeded
+ */
+static inline int scalar_double(const yaml_node_t* node, double* res)
+{
+	return pc_parse_double((const char*)node->data.scalar.value, node->data.scalar.length, res);
+}
+
+/** Converts a scalar node to a boolean
+ * \return whether the conversion succeeded
+ */
+static inline int scalar_bool(const yaml_node_t* node, int* res)
+{
+	const char* value = (const char*)node->data.scalar.value;
+	switch (node->data.scalar.length) {
+	case 2:
+		if (!memcmp(value, "No", 2) || !memcmp(value, "no", 2) || !memcmp(value, "NO", 2)) {
+			*res = 0;
+			return 1;
+		}
+		return 0;
+	case 3:
+		if (!memcmp(value, "Yes", 3) || !memcmp(value, "yes", 3) || !memcmp(value, "YES", 3)) {
+			*res = 1;
+			return 1;
+		}
+		return 0;
+	case 4:
+		if (!memcmp(value, "True", 4) || !memcmp(value, "true", 4) || !memcmp(value, "TRUE", 4)) {
+			*res = 1;
+			return 1;
+		}
+		return 0;
+	case 5:
+		if (!memcmp(value, "False", 5) || !memcmp(value, "false", 5) || !memcmp(value, "FALSE", 5)) {
+			*res = 0;
+			return 1;
+		}
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+/** Returns the pre-converted values of a scalar node
+ *
+ * \param doc the document containing the node
+ * \param node the scalar node
+ * \return the values, NULL if the document was not resolved with PC_tree_resolve
+ */
+static inline const pc_scalar_t* pc_scalar_find(PC_document_t* doc, const yaml_node_t* node)
+{
+	pc_scalars_t* scalars = __atomic_load_n(&doc->scalars, __ATOMIC_ACQUIRE);
+	if (!scalars) return NULL;
+	return scalars->values + (node - doc->document.nodes.start);
+}
+
+/** Converts a scalar node to an integer, using its pre-converted value if any
+ * \return whether the conversion succeeded
+ */
+static inline int pc_scalar_long(PC_document_t* doc, const yaml_node_t* node, long* res)
+{
+	const pc_scalar_t* resolved = pc_scalar_find(doc, node);
+	if (!resolved) return scalar_long(node, res);
+	if (!(resolved->flags & PC_SCALAR_INT)) return 0;
+	*res = resolved->int_value;
+	return 1;
+}
+
+/** Converts a scalar node to a floating point, using its pre-converted value if any
+ * \return whether the conversion succeeded
+ */
+static inline int pc_scalar_double(PC_document_t* doc, const yaml_node_t* node, double* res)
+{
+	const pc_scalar_t* resolved = pc_scalar_find(doc, node);
+	if (!resolved) return scalar_double(node, res);
+	if (!(resolved->flags & PC_SCALAR_DOUBLE)) return 0;
+	*res = resolved->double_value;
+	return 1;
+}
+
+/** Converts a scalar node to a boolean, using its pre-converted value if any
+ * \return whether the conversion succeeded
+ */
+static inline int pc_scalar_bool(PC_document_t* doc, const yaml_node_t* node, int* res)
+{
+	const pc_scalar_t* resolved = pc_scalar_find(doc, node);
+	if (!resolved) return scalar_bool(node, res);
+	if (!(resolved->flags & PC_SCALAR_BOOL)) return 0;
+	*res = !!(resolved->flags & PC_SCALAR_TRUE);
+	return 1;
+}
+
+/** Releases the pre-converted values of a document, if any
+ *
+ * \param doc the document
+ */
+void pc_scalars_destroy(PC_document_t* doc);
+
+#endif // SCALAR_H__
@@ -0,0 +1,445 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "arena.h"
+#include "status.h"
+#include "ypath.h"
+
+/* The binary format is made of:
+ * - a header,
+ * - one fixed-size record per node,
+ * - the items of all sequences as 32-bit node ids,
+ * - the pairs of all mappings as 32-bit key & value node ids,
+ * - a pool of null-terminated strings (scalar values, tags & path).
+ * All references are indices or offsets so the blob can be moved freely.
+ * Integers are stored in native byte order, checked on load.
+ */
+
+#define PC_BLOB_MAGIC "PCBLOB\0\1"
+
+#define PC_BLOB_BYTE_ORDER 0x01020304u
+
+/// number of distinct tags remembered when deduplicating tags in the string pool
+#define TAG_CACHE_SIZE 8
+
+/// largest part of a serialized document sent by a single call to the broadcast function
+#define BCAST_CHUNK_SIZE ((size_t)64 * 1024)
+
+typedef struct blob_header_s {
+	char magic[8];
+	uint32_t byte_order;
+	uint32_t nb_nodes;
+	uint32_t nb_items;
+	uint32_t nb_pairs;
+	uint64_t strings_size;
+	/// 1-based id of the node the serialized tree refers to, 0 for an empty tree
+	uint32_t root;
+	/// offset of the document path in the string pool
+	uint32_t path;
+	uint8_t start_implicit;
+	uint8_t end_implicit;
+	uint8_t padding[6];
+} blob_header_t;
+
+typedef struct blob_node_s {
+	uint8_t type;
+	uint8_t style;
+	uint8_t padding[2];
+	/// offset of the tag in the string pool + 1, 0 for no tag
+	uint32_t tag;
+	/// scalar: value offset in the string pool, collections: index of the first item/pair
+	uint32_t start;
+	/// scalar: value length, collections: number of items/pairs
+	uint32_t length;
+} blob_node_t;
+
+typedef struct blob_pair_s {
+	uint32_t key;
+	uint32_t value;
+} blob_pair_t;
+
+/** The layout of a blob
+ */
+typedef struct blob_s {
+	blob_header_t* header;
+	blob_node_t* nodes;
+	uint32_t* items;
+	blob_pair_t* pairs;
+	char* strings;
+	size_t size;
+} blob_t;
+
+/** Computes the layout of a blob
+ *
+ * \param[out] blob the layout, only computed if buffer is not NULL
+ * \param header the header describing the blob content
+ * \param buffer the memory holding the blob, can be NULL
+ * \return the size of the blob in bytes
+ */
+static size_t blob_layout(blob_t* blob, const blob_header_t* header, void* buffer)
+{
+	size_t nodes_offset = sizeof(blob_header_t);
+	size_t items_offset = nodes_offset + (size_t)header->nb_nodes * sizeof(blob_node_t);
+	size_t pairs_offset = items_offset + ((size_t)header->nb_items + (header->nb_items & 1)) * sizeof(uint32_t);
+	size_t strings_offset = pairs_offset + (size_t)header->nb_pairs * sizeof(blob_pair_t);
+	if (buffer) {
+		blob->header = buffer;
+		blob->nodes = (blob_node_t*)((char*)buffer + nodes_offset);
+		blob->items = (uint32_t*)((char*)buffer + items_offset);
+		blob->pairs = (blob_pair_t*)((char*)buffer + pairs_offset);
+		blob->strings = (char*)buffer + strings_offset;
+	}
+	return strings_offset + header->strings_size;
+}
+
+PC_status_t PC_serialize(PC_tree_t tree, void** buffer, size_t* size)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+	if (tree.pcdoc->lazy) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Lazily parsed documents can not be serialized, only their values can\n"), err0);
+	}
+	if (tree.pcdoc->overlay) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Overlay documents can not be serialized, only their layers can\n"), err0);
+	}
+
+	yaml_document_t* document = &tree.pcdoc->document;
+	size_t nb_nodes = document->nodes.top - document->nodes.start;
+
+	// measure
+	blob_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PC_BLOB_MAGIC, sizeof(header.magic));
+	header.byte_order = PC_BLOB_BYTE_ORDER;
+	size_t total_items = 0, total_pairs = 0;
+	size_t strings_size = strlen(tree.pcdoc->path) + 1;
+	const char* tag_cache[TAG_CACHE_SIZE];
+	int tag_cache_len = 0;
+	for (yaml_node_t* node = document->nodes.start; node != document->nodes.top; ++node) {
+		switch (node->type) {
+		case YAML_SCALAR_NODE:
+			strings_size += node->data.scalar.length + 1;
+			break;
+		case YAML_SEQUENCE_NODE:
+			total_items += node->data.sequence.items.top - node->data.sequence.items.start;
+			break;
+		case YAML_MAPPING_NODE:
+			total_pairs += node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+			break;
+		default:
+			break;
+		}
+		if (!node->tag) continue;
+		int cached = 0;
+		while (cached < tag_cache_len && strcmp(tag_cache[cached], (char*)node->tag))
+			++cached;
+		if (cached == tag_cache_len) {
+			cached = tag_cache_len < TAG_CACHE_SIZE ? tag_cache_len++ : (node - document->nodes.start) % TAG_CACHE_SIZE;
+			tag_cache[cached] = (char*)node->tag;
+			strings_size += strlen((char*)node->tag) + 1;
+		}
+	}
+	if (nb_nodes >= UINT32_MAX) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "document too large to be serialized (%zu nodes)\n", nb_nodes), err0);
+	}
+	if (total_items >= UINT32_MAX) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "document too large to be serialized (%zu sequence items)\n", total_items), err0);
+	}
+	if (total_pairs >= UINT32_MAX) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "document too large to be serialized (%zu mapping pairs)\n", total_pairs), err0);
+	}
+	if (strings_size >= UINT32_MAX) {
+		PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "document too large to be serialized (%zu bytes of strings)\n", strings_size), err0);
+	}
+	header.nb_nodes = nb_nodes;
+	header.nb_items = total_items;
+	header.nb_pairs = total_pairs;
+	header.strings_size = strings_size;
+	header.root = tree.node ? tree.node - document->nodes.start + 1 : 0;
+	header.start_implicit = document->start_implicit;
+	header.end_implicit = document->end_implicit;
+
+	blob_t blob;
+	*size = blob_layout(&blob, &header, NULL);
+	*buffer = calloc(1, *size);
+	if (!*buffer) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	memcpy(*buffer, &header, sizeof(header));
+	blob_layout(&blob, &header, *buffer);
+
+	// fill
+	uint32_t nb_items = 0, nb_pairs = 0, strings_pos = 0;
+	uint32_t tag_cache_offset[TAG_CACHE_SIZE];
+	tag_cache_len = 0;
+	for (size_t node_idx = 0; node_idx < nb_nodes; ++node_idx) {
+		yaml_node_t* node = document->nodes.start + node_idx;
+		blob_node_t* blob_node = blob.nodes + node_idx;
+		blob_node->type = node->type;
+		switch (node->type) {
+		case YAML_SCALAR_NODE:
+			blob_node->style = node->data.scalar.style;
+			blob_node->start = strings_pos;
+			blob_node->length = node->data.scalar.length;
+			memcpy(blob.strings + strings_pos, node->data.scalar.value, node->data.scalar.length);
+			strings_pos += node->data.scalar.length + 1;
+			break;
+		case YAML_SEQUENCE_NODE:
+			blob_node->style = node->data.sequence.style;
+			blob_node->start = nb_items;
+			blob_node->length = node->data.sequence.items.top - node->data.sequence.items.start;
+			for (yaml_node_item_t* item = node->data.sequence.items.start; item != node->data.sequence.items.top; ++item) {
+				blob.items[nb_items++] = *item;
+			}
+			break;
+		case YAML_MAPPING_NODE:
+			blob_node->style = node->data.mapping.style;
+			blob_node->start = nb_pairs;
+			blob_node->length = node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+			for (yaml_node_pair_t* pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; ++pair) {
+				blob.pairs[nb_pairs].key = pair->key;
+				blob.pairs[nb_pairs].value = pair->value;
+				++nb_pairs;
+			}
+			break;
+		default:
+			break;
+		}
+		if (!node->tag) continue;
+		int cached = 0;
+		while (cached < tag_cache_len && strcmp(tag_cache[cached], (char*)node->tag))
+			++cached;
+		if (cached == tag_cache_len) {
+			cached = tag_cache_len < TAG_CACHE_SIZE ? tag_cache_len++ : (int)(node_idx % TAG_CACHE_SIZE);
+			tag_cache[cached] = (char*)node->tag;
+			tag_cache_offset[cached] = strings_pos;
+			size_t tag_len = strlen((char*)node->tag);
+			memcpy(blob.strings + strings_pos, node->tag, tag_len);
+			strings_pos += tag_len + 1;
+		}
+		blob_node->tag = tag_cache_offset[cached] + 1;
+	}
+	blob.header->path = strings_pos;
+	memcpy(blob.strings + strings_pos, tree.pcdoc->path, strlen(tree.pcdoc->path));
+
+	return status;
+
+err0:
+	return status;
+}
+
+/** Checks that the parts of a blob described by its header exactly fill it
+ *
+ * Unlike blob_layout, this can not overflow whatever the header contains.
+ *
+ * \param header the header describing the blob content
+ * \param size the size of the blob in bytes, at least that of the header
+ * \return whether the parts fill the blob
+ */
+static int blob_fits(const blob_header_t* header, size_t size)
+{
+	size_t left = size - sizeof(blob_header_t);
+	if (header->nb_nodes > left / sizeof(blob_node_t)) return 0;
+	left -= (size_t)header->nb_nodes * sizeof(blob_node_t);
+	size_t nb_items = (size_t)header->nb_items + (header->nb_items & 1);
+	if (nb_items > left / sizeof(uint32_t)) return 0;
+	left -= nb_items * sizeof(uint32_t);
+	if (header->nb_pairs > left / sizeof(blob_pair_t)) return 0;
+	left -= (size_t)header->nb_pairs * sizeof(blob_pair_t);
+	return header->strings_size == left;
+}
+
+PC_tree_t PC_deserialize(const void* buffer, size_t size)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+	PC_STATS_START(start);
+
+	// the blob is copied to ensure alignment
+	blob_header_t header;
+	if (size < sizeof(header)) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: truncated header\n"), err0);
+	}
+	memcpy(&header, buffer, sizeof(header));
+	if (memcmp(header.magic, PC_BLOB_MAGIC, sizeof(header.magic))) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad magic number\n"), err0);
+	}
+	if (header.byte_order != PC_BLOB_BYTE_ORDER) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: byte order mismatch\n"), err0);
+	}
+	blob_t blob;
+	if (!blob_fits(&header, size) || header.root > header.nb_nodes || header.path >= header.strings_size) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: inconsistent size\n"), err0);
+	}
+	void* aligned = malloc(size);
+	if (!aligned) {
+		PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	memcpy(aligned, buffer, size);
+	blob_layout(&blob, &header, aligned);
+
+	// with a null-terminated pool, any offset in bounds is a valid string
+	pc_arena_t arena;
+	PC_handle_err_tree(pc_arena_alloc(&arena, header.nb_nodes, header.nb_items, header.nb_pairs, header.strings_size), err1);
+	memcpy(arena.strings, blob.strings, header.strings_size);
+	if (blob.strings[header.strings_size - 1]) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad string pool\n"), err2);
+	}
+
+	for (uint32_t node_idx = 0; node_idx < header.nb_nodes; ++node_idx) {
+		blob_node_t* blob_node = blob.nodes + node_idx;
+		yaml_node_t* node = arena.nodes + node_idx;
+		memset(node, 0, sizeof(yaml_node_t));
+		node->type = blob_node->type;
+		if (blob_node->tag) {
+			if (blob_node->tag > header.strings_size) {
+				PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad tag\n"), err2);
+			}
+			node->tag = (yaml_char_t*)arena.strings + blob_node->tag - 1;
+		}
+		switch (blob_node->type) {
+		case YAML_SCALAR_NODE:
+			if ((uint64_t)blob_node->start + blob_node->length >= header.strings_size || blob.strings[blob_node->start + blob_node->length]) {
+				PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad scalar\n"), err2);
+			}
+			node->data.scalar.value = (yaml_char_t*)arena.strings + blob_node->start;
+			node->data.scalar.length = blob_node->length;
+			node->data.scalar.style = blob_node->style;
+			break;
+		case YAML_SEQUENCE_NODE:
+			if ((uint64_t)blob_node->start + blob_node->length > header.nb_items) {
+				PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad sequence\n"), err2);
+			}
+			node->data.sequence.items.start = arena.items + blob_node->start;
+			node->data.sequence.items.end = node->data.sequence.items.start + blob_node->length;
+			node->data.sequence.items.top = node->data.sequence.items.end;
+			node->data.sequence.style = blob_node->style;
+			break;
+		case YAML_MAPPING_NODE:
+			if ((uint64_t)blob_node->start + blob_node->length > header.nb_pairs) {
+				PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad mapping\n"), err2);
+			}
+			node->data.mapping.pairs.start = arena.pairs + blob_node->start;
+			node->data.mapping.pairs.end = node->data.mapping.pairs.start + blob_node->length;
+			node->data.mapping.pairs.top = node->data.mapping.pairs.end;
+			node->data.mapping.style = blob_node->style;
+			break;
+		default:
+			PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad node type\n"), err2);
+		}
+	}
+	for (uint32_t item_idx = 0; item_idx < header.nb_items; ++item_idx) {
+		if (!blob.items[item_idx] || blob.items[item_idx] > header.nb_nodes) {
+			PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad node id\n"), err2);
+		}
+		arena.items[item_idx] = blob.items[item_idx];
+	}
+	for (uint32_t pair_idx = 0; pair_idx < header.nb_pairs; ++pair_idx) {
+		blob_pair_t pair = blob.pairs[pair_idx];
+		if (!pair.key || pair.key > header.nb_nodes || !pair.value || pair.value > header.nb_nodes) {
+			PC_handle_err_tree(PC_make_err(PC_INVALID_FORMAT, "invalid serialized document: bad node id\n"), err2);
+		}
+		arena.pairs[pair_idx].key = pair.key;
+		arena.pairs[pair_idx].value = pair.value;
+	}
+
+	yaml_document_t document;
+	pc_arena_document(&document, &arena, header.nb_nodes);
+	document.start_implicit = header.start_implicit;
+	document.end_implicit = header.end_implicit;
+
+	char* path = strdup(arena.strings + header.path);
+	restree = PC_root(&document);
+	restree.pcdoc->arena = arena.block;
+	restree.pcdoc->path = path;
+	restree.node = header.root ? arena.nodes + header.root - 1 : NULL;
+	PC_STATS_ALLOC(restree.pcdoc, arena.size);
+	PC_STATS_ALLOC(restree.pcdoc, strlen(arena.strings + header.path) + 1);
+	PC_STATS_PARSED(restree.pcdoc, start, size);
+
+	free(aligned);
+	return restree;
+
+err2:
+	free(arena.block);
+err1:
+	free(aligned);
+err0:
+	return restree;
+}
+
+/** Calls the user transport, making sure failures are reported
+ *
+ * The buffer is sent by chunks of BCAST_CHUNK_SIZE bytes at most.
+ */
+static PC_status_t transport(PC_bcast_f bcast, void* buffer, size_t size, void* context)
+{
+	for (size_t offset = 0; offset < size; offset += BCAST_CHUNK_SIZE) {
+		size_t chunk_size = size - offset < BCAST_CHUNK_SIZE ? size - offset : BCAST_CHUNK_SIZE;
+		PC_status_t status = bcast((char*)buffer + offset, chunk_size, context);
+		if (status) return PC_make_err(status, "broadcast of a serialized document (%zu bytes) failed\n", size);
+	}
+	return PC_OK;
+}
+
+/** Receives a serialized document chunk by chunk in a scratch buffer, to take
+ * part in the broadcast without holding the document
+ */
+static PC_status_t discard(PC_bcast_f bcast, uint64_t size, void* context)
+{
+	char scratch[BCAST_CHUNK_SIZE];
+	for (uint64_t offset = 0; offset < size; offset += BCAST_CHUNK_SIZE) {
+		PC_status_t status = bcast(scratch, size - offset < BCAST_CHUNK_SIZE ? (size_t)(size - offset) : BCAST_CHUNK_SIZE, context);
+		if (status) return PC_make_err(status, "broadcast of a serialized document (%llu bytes) failed\n", (unsigned long long)size);
+	}
+	return PC_OK;
+}
+
+PC_tree_t PC_broadcast(PC_tree_t tree, int root, PC_bcast_f bcast, void* context)
+{
+	PC_tree_t restree = {PC_OK, NULL, NULL};
+	void* buffer = NULL;
+	size_t size = 0;
+	if (root) {
+		restree = tree;
+		if (!PC_status(restree)) restree.status = PC_serialize(tree, &buffer, &size);
+	}
+
+	// the root always sends the size, 0 when it has no document, so that the other processes never wait for it forever
+	uint64_t size64 = size;
+	PC_status_t sent = transport(bcast, &size64, sizeof(size64), context);
+	if (sent) restree.status = sent;
+	PC_handle_tree(err1);
+	if (!root) {
+		if (!size64) {
+			PC_handle_err_tree(PC_make_err(PC_INVALID_PARAMETER, "no document to broadcast, it is in error on the root process\n"), err0);
+		}
+		// a process that can not allocate the document still receives it, then fails
+		if (size64 <= SIZE_MAX) buffer = malloc(size64);
+		if (!buffer) {
+			PC_handle_err_tree(discard(bcast, size64, context), err0);
+			PC_handle_err_tree(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory to receive a document of %llu bytes\n", (unsigned long long)size64), err0);
+		}
+		size = size64;
+	}
+	PC_handle_err_tree(transport(bcast, buffer, size, context), err1);
+
+	if (!root) restree = PC_deserialize(buffer, size);
+	free(buffer);
+	return restree;
+
+err1:
+	free(buffer);
+err0:
+	return restree;
+}
@@ -0,0 +1,93 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "paraconf.h"
+
+#include "keyindex.h"
+#include "scalar.h"
+#include "stats.h"
+#include "status.h"
+#include "ypath.h"
+
+PC_status_t PC_stats(const PC_tree_t tree, PC_stats_t* stats)
+{
+	PC_status_t status = PC_OK;
+	PC_handle_tree_err(tree, err0);
+
+	PC_document_t* doc = tree.pcdoc;
+	memset(stats, 0, sizeof(PC_stats_t));
+
+#ifdef PARACONF_ENABLE_STATS
+	stats->enabled = 1;
+	stats->parse_time = __atomic_load_n(&doc->counters.parse_time, __ATOMIC_RELAXED) * 1e-9;
+	stats->bytes_read = __atomic_load_n(&doc->counters.bytes_read, __ATOMIC_RELAXED);
+	stats->nb_lookups = __atomic_load_n(&doc->counters.nb_lookups, __ATOMIC_RELAXED);
+	stats->nb_key_compares = __atomic_load_n(&doc->counters.nb_key_compares, __ATOMIC_RELAXED);
+	stats->nb_allocs = __atomic_load_n(&doc->counters.nb_allocs, __ATOMIC_RELAXED);
+	stats->alloc_bytes = __atomic_load_n(&doc->counters.alloc_bytes, __ATOMIC_RELAXED);
+	stats->nb_errors = __atomic_load_n(&doc->counters.nb_errors, __ATOMIC_RELAXED);
+#endif
+
+	// the memory is estimated from the structure of the document, whether it is frozen or not
+	const yaml_document_t* document = &doc->document;
+	stats->nb_nodes = document->nodes.top - document->nodes.start;
+	stats->memory = sizeof(PC_document_t) + (document->nodes.end - document->nodes.start) * sizeof(yaml_node_t);
+	for (const yaml_node_t* node = document->nodes.start; node != document->nodes.top; ++node) {
+		if (node->tag) stats->memory += strlen((const char*)node->tag) + 1;
+		switch (node->type) {
+		case YAML_SCALAR_NODE:
+			++stats->nb_scalars;
+			stats->memory += node->data.scalar.length + 1;
+			break;
+		case YAML_SEQUENCE_NODE:
+			stats->memory += (node->data.sequence.items.end - node->data.sequence.items.start) * sizeof(yaml_node_item_t);
+			break;
+		case YAML_MAPPING_NODE:
+			stats->memory += (node->data.mapping.pairs.end - node->data.mapping.pairs.start) * sizeof(yaml_node_pair_t);
+			break;
+		default:
+			break;
+		}
+	}
+	stats->memory += strlen(doc->path) + 1;
+	stats->memory += pc_keyindex_memory(doc);
+	if (__atomic_load_n(&doc->scalars, __ATOMIC_ACQUIRE)) stats->memory += sizeof(pc_scalars_t) + stats->nb_nodes * sizeof(pc_scalar_t);
+
+	return status;
+
+err0:
+	return status;
+}
+
+PC_status_t PC_stats_print(const PC_tree_t tree, FILE* file)
+{
+	PC_status_t status = PC_OK;
+
+	PC_stats_t stats;
+	PC_handle_err(PC_stats(tree, &stats), err0);
+
+	fprintf(file, "paraconf statistics for `%s':\n", PC_path(tree));
+	fprintf(file, "  nodes:           %zu (%zu scalars)\n", stats.nb_nodes, stats.nb_scalars);
+	fprintf(file, "  memory:          ~%zu bytes\n", stats.memory);
+	if (!stats.enabled) {
+		fprintf(file, "  (event counters disabled, build paraconf with PARACONF_ENABLE_STATS to enable them)\n");
+		return status;
+	}
+	fprintf(file, "  parse time:      %.6f s\n", stats.parse_time);
+	fprintf(file, "  bytes read:      %zu\n", stats.bytes_read);
+	fprintf(file, "  lookups:         %lu\n", stats.nb_lookups);
+	fprintf(file, "  key comparisons: %lu\n", stats.nb_key_compares);
+	fprintf(file, "  allocations:     %lu (%zu bytes)\n", stats.nb_allocs, stats.alloc_bytes);
+	fprintf(file, "  errors:          %lu\n", stats.nb_errors);
+
+	return status;
+
+err0:
+	return status;
+}
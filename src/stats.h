@@ -0,0 +1,101 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef STATS_H__
+#define STATS_H__
+
+#include <stddef.h>
+
+#ifdef PARACONF_ENABLE_STATS
+
+#include <time.h>
+
+/** The event counters of a document
+ *
+ * Documents may be read concurrently, the counters are updated atomically.
+ */
+typedef struct pc_counters_s {
+	/// wall time spent parsing the document, in nanoseconds
+	unsigned long parse_time;
+
+	/// number of bytes of input parsed
+	unsigned long bytes_read;
+
+	/// number of steps resolved by lookups
+	unsigned long nb_lookups;
+
+	/// number of keys compared during lookups in mappings
+	unsigned long nb_key_compares;
+
+	/// number of allocations made by paraconf for the document
+	unsigned long nb_allocs;
+
+	/// number of bytes allocated by paraconf for the document
+	unsigned long alloc_bytes;
+
+	/// number of errors raised on the document
+	unsigned long nb_errors;
+
+} pc_counters_t;
+
+/** Adds a value to a counter of a document
+ */
+#define PC_STATS_ADD(doc, counter, value) __atomic_fetch_add(&(doc)->counters.counter, (value), __ATOMIC_RELAXED)
+
+/** Sets a counter of a document
+ */
+#define PC_STATS_SET(doc, counter, value) __atomic_store_n(&(doc)->counters.counter, (value), __ATOMIC_RELAXED)
+
+/** Records an allocation made for a document
+ */
+#define PC_STATS_ALLOC(doc, size)                                                                                                                    \
+	do {                                                                                                                                             \
+		PC_STATS_ADD(doc, nb_allocs, 1);                                                                                                             \
+		PC_STATS_ADD(doc, alloc_bytes, (size));                                                                                                      \
+	} while (0)
+
+/** Records the error of a function called on a tree, if the tree was not already in error
+ */
+#define PC_STATS_ERROR(tree, error)                                                                                                                  \
+	do {                                                                                                                                             \
+		if ((error) && !(tree).status && (tree).pcdoc) PC_STATS_ADD((tree).pcdoc, nb_errors, 1);                                                    \
+	} while (0)
+
+/** Declares a timestamp to measure a duration with PC_STATS_ELAPSED
+ */
+#define PC_STATS_START(start)                                                                                                                        \
+	struct timespec start;                                                                                                                           \
+	clock_gettime(CLOCK_MONOTONIC, &start)
+
+/** Returns the nanoseconds elapsed since a timestamp declared with PC_STATS_START
+ */
+static inline unsigned long pc_stats_elapsed(const struct timespec* start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1000000000L + (now.tv_nsec - start->tv_nsec);
+}
+
+/** Records the parse time and input size of a document
+ */
+#define PC_STATS_PARSED(doc, start, size)                                                                                                            \
+	do {                                                                                                                                             \
+		PC_STATS_SET(doc, parse_time, pc_stats_elapsed(&start));                                                                                      \
+		PC_STATS_SET(doc, bytes_read, (size));                                                                                                       \
+	} while (0)
+
+#else // PARACONF_ENABLE_STATS
+
+#define PC_STATS_ADD(doc, counter, value) ((void)0)
+#define PC_STATS_SET(doc, counter, value) ((void)0)
+#define PC_STATS_ALLOC(doc, size) ((void)0)
+#define PC_STATS_ERROR(tree, error) ((void)0)
+#define PC_STATS_START(start) ((void)0)
+#define PC_STATS_PARSED(doc, start, size) ((void)0)
+
+#endif // PARACONF_ENABLE_STATS
+
+#endif // STATS_H__
@@ -16,17 +16,70 @@
 
 // file private stuff
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define PC_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define PC_THREAD_LOCAL __thread
+#endif
+
+/// the maximum number of arguments of a message whose formatting can be delayed
+#define PC_ERR_MAX_ARGS 8
+
+/** An argument of a message whose formatting is delayed
+ */
+typedef struct errarg_s {
+	/// the conversion: 'd', 'c', 'l' for %ld, 'u' for %lu, 'z' for %zu or 's' for strings
+	char conversion;
+
+	/// the value of integer and character arguments
+	long int_value;
+
+	/// the value of unsigned integer arguments
+	unsigned long uint_value;
+
+	/// the value of size arguments
+	size_t size_value;
+
+	/// the offset of string arguments in the context strings
+	size_t str_offset;
+
+	/// the length of string arguments
+	size_t str_len;
+
+} errarg_t;
+
 typedef struct errctx_s {
 	PC_errhandler_t handler;
 
+	/// the formatted message of the last error, outdated if format is set
 	char* buffer;
 
+	/// the allocated size of buffer
+	size_t buffer_size;
+
+	/// the format of the last error if it has not been formatted yet, NULL otherwise
+	const char* format;
+
+	/// the arguments of the last error if it has not been formatted yet
+	errarg_t args[PC_ERR_MAX_ARGS];
+
+	/// the copies of the string arguments of the last error, reused from one error to the next
+	char* strings;
+
+	/// the allocated size of strings
+	size_t strings_size;
+
 } errctx_t;
 
 static pthread_key_t context_key;
 
 static pthread_once_t context_key_once = PTHREAD_ONCE_INIT;
 
+#ifdef PC_THREAD_LOCAL
+/// the context of the current thread, also registered in context_key for its destruction
+static PC_THREAD_LOCAL errctx_t* tls_context = NULL;
+#endif
+
 static void assert_status(PC_status_t status, const char* message, void* context)
 {
 	(void)context; // prevent unused warning
@@ -41,7 +94,13 @@ static void assert_status(PC_status_t status, const char* message, void* context
  */
 static void context_destroy(void* context)
 {
-	free(context);
+	errctx_t* ctx = context;
+	free(ctx->buffer);
+	free(ctx->strings);
+	free(ctx);
+#ifdef PC_THREAD_LOCAL
+	tls_context = NULL;
+#endif
 }
 
 static void context_init()
@@ -49,21 +108,182 @@ static void context_init()
 	pthread_key_create(&context_key, context_destroy);
 }
 
-static errctx_t* get_context()
+static errctx_t* get_context_slow()
 {
 	pthread_once(&context_key_once, &context_init);
 
 	errctx_t* context = pthread_getspecific(context_key);
 	if (!context) {
-		context = malloc(sizeof(errctx_t));
-		context->buffer = NULL;
+		context = calloc(1, sizeof(errctx_t));
 		context->handler = PC_ASSERT_HANDLER;
 		pthread_setspecific(context_key, context);
 	}
+#ifdef PC_THREAD_LOCAL
+	tls_context = context;
+#endif
 
 	return context;
 }
 
+static inline errctx_t* get_context()
+{
+#ifdef PC_THREAD_LOCAL
+	if (tls_context) return tls_context;
+#endif
+	return get_context_slow();
+}
+
+/** Ensures a buffer of the context is large enough
+ *
+ * \param buffer the buffer to grow
+ * \param buffer_size the allocated size of the buffer
+ * \param size the required size
+ * \return whether the buffer is large enough
+ */
+static int ensure_size(char** buffer, size_t* buffer_size, size_t size)
+{
+	if (size <= *buffer_size) return 1;
+	if (size < 2 * *buffer_size) size = 2 * *buffer_size;
+	char* new_buffer = realloc(*buffer, size);
+	if (!new_buffer) return 0;
+	*buffer = new_buffer;
+	*buffer_size = size;
+	return 1;
+}
+
+/** Records the arguments of a message so that it can be formatted later
+ *
+ * Only the conversions used by the library are supported: %d, %c, %ld, %lu,
+ * %zu, %s and %.*s. String arguments are copied as they might not outlive the
+ * call.
+ *
+ * \param ctx the context where to record the message
+ * \param message the message format
+ * \param ap the message arguments
+ * \return whether the message could be recorded
+ */
+static int record_err(errctx_t* ctx, const char* message, va_list ap)
+{
+	ctx->format = NULL; // the arguments of the previous message are overwritten
+	size_t strings_len = 0;
+	int nb_args = 0;
+	for (const char* fmt = message; *fmt; ++fmt) {
+		if (*fmt != '%') continue;
+		++fmt;
+		if (*fmt == '%') continue;
+		if (nb_args >= PC_ERR_MAX_ARGS) return 0;
+		errarg_t* arg = &ctx->args[nb_args++];
+
+		int precision = -1;
+		if (fmt[0] == '.' && fmt[1] == '*') {
+			precision = va_arg(ap, int);
+			fmt += 2;
+			if (*fmt != 's') return 0;
+		}
+		switch (*fmt) {
+		case 'd':
+			arg->conversion = 'd';
+			arg->int_value = va_arg(ap, int);
+			break;
+		case 'c':
+			arg->conversion = 'c';
+			arg->int_value = va_arg(ap, int);
+			break;
+		case 'l':
+			++fmt;
+			if (*fmt == 'd') {
+				arg->conversion = 'l';
+				arg->int_value = va_arg(ap, long);
+			} else if (*fmt == 'u') {
+				arg->conversion = 'u';
+				arg->uint_value = va_arg(ap, unsigned long);
+			} else {
+				return 0;
+			}
+			break;
+		case 'z':
+			++fmt;
+			if (*fmt != 'u') return 0;
+			arg->conversion = 'z';
+			arg->size_value = va_arg(ap, size_t);
+			break;
+		case 's': {
+			const char* value = va_arg(ap, const char*);
+			if (!value) value = "(null)";
+			size_t len;
+			if (precision >= 0) {
+				const char* end = memchr(value, '\0', precision);
+				len = end ? (size_t)(end - value) : (size_t)precision;
+			} else {
+				len = strlen(value);
+			}
+			if (!ensure_size(&ctx->strings, &ctx->strings_size, strings_len + len)) return 0;
+			if (len) memcpy(ctx->strings + strings_len, value, len);
+			arg->conversion = 's';
+			arg->str_offset = strings_len;
+			arg->str_len = len;
+			strings_len += len;
+		} break;
+		default:
+			return 0;
+		}
+	}
+	ctx->format = message;
+	return 1;
+}
+
+/** Formats the message of the last error if it was recorded by record_err
+ *
+ * \param ctx the context holding the message
+ */
+static void format_err(errctx_t* ctx)
+{
+	if (!ctx->format) return;
+	if (!ensure_size(&ctx->buffer, &ctx->buffer_size, 1)) return;
+
+	size_t len = 0;
+	int arg_idx = 0;
+	for (const char* fmt = ctx->format; *fmt; ++fmt) {
+		char number[32];
+		const char* piece = fmt;
+		size_t piece_len = 1;
+		if (*fmt == '%') {
+			++fmt;
+			if (*fmt != '%') {
+				const errarg_t* arg = &ctx->args[arg_idx++];
+				while (*fmt != 'd' && *fmt != 'c' && *fmt != 's' && *fmt != 'u')
+					++fmt;
+				piece = number;
+				switch (arg->conversion) {
+				case 'd':
+				case 'l':
+					piece_len = snprintf(number, sizeof(number), "%ld", arg->int_value);
+					break;
+				case 'c':
+					number[0] = (char)arg->int_value;
+					break;
+				case 'u':
+					piece_len = snprintf(number, sizeof(number), "%lu", arg->uint_value);
+					break;
+				case 'z':
+					piece_len = snprintf(number, sizeof(number), "%zu", arg->size_value);
+					break;
+				default: // 's'
+					piece = ctx->strings + arg->str_offset;
+					piece_len = arg->str_len;
+				}
+			} else {
+				piece = fmt;
+			}
+		}
+		if (!ensure_size(&ctx->buffer, &ctx->buffer_size, len + piece_len + 1)) break; // keep the message truncated
+		memcpy(ctx->buffer + len, piece, piece_len);
+		len += piece_len;
+	}
+	ctx->buffer[len] = '\0';
+	ctx->format = NULL;
+}
+
 // library private stuff
 
 PC_status_t PC_make_err(PC_status_t status, const char* message, ...)
@@ -72,15 +292,25 @@ PC_status_t PC_make_err(PC_status_t status, const char* message, ...)
 
 	errctx_t* ctx = get_context();
 
+	// when nobody is notified, the message is only formatted if PC_errmsg is called
+	if (!ctx->handler.func) {
+		va_start(ap, message);
+		int recorded = record_err(ctx, message, ap);
+		va_end(ap);
+		if (recorded) return status;
+	}
+
 	char* oldbuf = ctx->buffer; // might be used as one of the va_args
 	va_start(ap, message);
 	int buffer_size = vsnprintf(NULL, 0, message, ap) + 1;
 	va_end(ap);
 	ctx->buffer = malloc(buffer_size);
+	ctx->buffer_size = ctx->buffer ? buffer_size : 0;
 	va_start(ap, message);
-	vsnprintf(ctx->buffer, buffer_size, message, ap);
+	if (ctx->buffer) vsnprintf(ctx->buffer, buffer_size, message, ap);
 	va_end(ap);
 	free(oldbuf);
+	ctx->format = NULL;
 	if (ctx->handler.func) ctx->handler.func(status, ctx->buffer, ctx->handler.context);
 	return status;
 }
@@ -93,12 +323,15 @@ const PC_errhandler_t PC_NULL_HANDLER = {NULL, NULL};
 
 PC_errhandler_t PC_errhandler(PC_errhandler_t new_handler)
 {
-	PC_errhandler_t old_handler = get_context()->handler;
-	get_context()->handler = new_handler;
+	errctx_t* ctx = get_context();
+	PC_errhandler_t old_handler = ctx->handler;
+	ctx->handler = new_handler;
 	return old_handler;
 }
 
 char* PC_errmsg()
 {
-	return get_context()->buffer;
+	errctx_t* ctx = get_context();
+	format_err(ctx);
+	return ctx->buffer;
 }
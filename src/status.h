@@ -32,6 +32,15 @@
 		if (status) goto free_stamp;                                                                                                                 \
 	} while (0)
 
+/** Reports an error to the current error handler
+ *
+ * When no handler is installed, the message is only formatted if PC_errmsg is
+ * called, its format must thus outlive the call, e.g. be a string literal.
+ *
+ * \param status the error status
+ * \param message the printf-like format of the error message
+ * \return status
+ */
 PC_status_t PC_make_err(PC_status_t status, const char* message, ...);
 
 #endif // STATUS_H__
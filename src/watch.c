@@ -0,0 +1,372 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include "paraconf.h"
+
+#include "keyindex.h"
+#include "status.h"
+#include "ypath.h"
+
+#define ERRBUF_SIZE 512
+
+/// period of the checks of the file when it can not be watched by inotify, in milliseconds
+#define PC_WATCH_POLL_MS 1000
+
+/* The published document is replaced RCU-style: a reader takes a reference on
+ * the document currently published, a reload publishes a new document and then
+ * drops the reference of the publication on the old one, which is freed with
+ * its last reference.
+ *
+ * Taking a reference is not atomic with reading the published document, a
+ * reload could drop the old document in between. Readers thus announce
+ * themselves in a counter of the current epoch for the short time between
+ * both. A reload increments the epoch after publishing and waits for the
+ * readers of the previous one before dropping the old document.
+ */
+
+struct PC_watch_s {
+	/// the path of the watched file
+	char* path;
+	/// the function called after each reload, NULL if none
+	PC_watch_f on_change;
+	/// the context of on_change
+	void* context;
+	/// the document currently published
+	PC_document_t* current;
+	/// the publication epoch, incremented by each reload
+	unsigned long epoch;
+	/// the number of readers taking a reference, by parity of the epoch they started in
+	unsigned long readers[2];
+	/// serializes the reloads
+	pthread_mutex_t reload_mutex;
+	/// the thread watching the file
+	pthread_t thread;
+	/// written to stop the watching thread
+	int stop_pipe[2];
+	/// the inotify instance watching the directory of the file, -1 if polling
+	int notify_fd;
+	/// the status of the file last time it was checked, when polling
+	struct stat last_stat;
+};
+
+/** Drops a reference on a published document, freeing it with the last one
+ *
+ * \param doc the document
+ */
+static void doc_release(PC_document_t* doc)
+{
+	PC_tree_t tree = {PC_OK, doc, NULL};
+	PC_tree_release(&tree);
+}
+
+/** Checks whether two nodes have the same content
+ *
+ * \param doc1 the document of the first node
+ * \param node1 the first node
+ * \param doc2 the document of the second node
+ * \param node2 the second node
+ * \return whether both nodes have the same type, tag and content
+ */
+static int same_node(yaml_document_t* doc1, const yaml_node_t* node1, yaml_document_t* doc2, const yaml_node_t* node2)
+{
+	if (node1->type != node2->type) return 0;
+	if (!node1->tag != !node2->tag || (node1->tag && strcmp((const char*)node1->tag, (const char*)node2->tag))) return 0;
+	switch (node1->type) {
+	case YAML_SCALAR_NODE:
+		return node1->data.scalar.length == node2->data.scalar.length
+		    && !memcmp(node1->data.scalar.value, node2->data.scalar.value, node1->data.scalar.length);
+	case YAML_SEQUENCE_NODE: {
+		long len = node1->data.sequence.items.top - node1->data.sequence.items.start;
+		if (len != node2->data.sequence.items.top - node2->data.sequence.items.start) return 0;
+		for (long idx = 0; idx < len; ++idx) {
+			const yaml_node_t* item1 = yaml_document_get_node(doc1, node1->data.sequence.items.start[idx]);
+			const yaml_node_t* item2 = yaml_document_get_node(doc2, node2->data.sequence.items.start[idx]);
+			if (!same_node(doc1, item1, doc2, item2)) return 0;
+		}
+		return 1;
+	}
+	case YAML_MAPPING_NODE: {
+		long len = node1->data.mapping.pairs.top - node1->data.mapping.pairs.start;
+		if (len != node2->data.mapping.pairs.top - node2->data.mapping.pairs.start) return 0;
+		for (long idx = 0; idx < len; ++idx) {
+			const yaml_node_pair_t* pair1 = node1->data.mapping.pairs.start + idx;
+			const yaml_node_pair_t* pair2 = node2->data.mapping.pairs.start + idx;
+			if (!same_node(doc1, yaml_document_get_node(doc1, pair1->key), doc2, yaml_document_get_node(doc2, pair2->key))) return 0;
+			if (!same_node(doc1, yaml_document_get_node(doc1, pair1->value), doc2, yaml_document_get_node(doc2, pair2->value))) return 0;
+		}
+		return 1;
+	}
+	default:
+		return 1;
+	}
+}
+
+/** Lists the top-level keys of a document missing or different in another one
+ *
+ * \param doc the document whose keys to list
+ * \param other the document to compare with
+ * \param compare_values whether to list the keys whose value differs in other, or only the missing ones
+ * \param[in,out] keys where to append the keys
+ * \param[in,out] nb_keys the number of keys in keys
+ */
+static void diff_keys(PC_document_t* doc, PC_document_t* other, int compare_values, const char** keys, int* nb_keys)
+{
+	yaml_node_t* root = yaml_document_get_root_node(&doc->document);
+	yaml_node_t* other_root = yaml_document_get_root_node(&other->document);
+	if (!root || root->type != YAML_MAPPING_NODE) return;
+	for (yaml_node_pair_t* pair = root->data.mapping.pairs.start; pair < root->data.mapping.pairs.top; ++pair) {
+		const yaml_node_t* key = yaml_document_get_node(&doc->document, pair->key);
+		if (key->type != YAML_SCALAR_NODE) continue;
+		const char* key_value = (const char*)key->data.scalar.value;
+		size_t key_len = key->data.scalar.length;
+		if (pc_keyindex_find(doc, root, key_value, key_len) != pair) continue; // duplicate key
+		yaml_node_pair_t* other_pair = NULL;
+		if (other_root && other_root->type == YAML_MAPPING_NODE) other_pair = pc_keyindex_find(other, other_root, key_value, key_len);
+		if (other_pair) {
+			if (!compare_values) continue;
+			const yaml_node_t* value = yaml_document_get_node(&doc->document, pair->value);
+			const yaml_node_t* other_value = yaml_document_get_node(&other->document, other_pair->value);
+			if (same_node(&doc->document, value, &other->document, other_value)) continue;
+		}
+		keys[(*nb_keys)++] = key_value;
+	}
+}
+
+PC_status_t PC_watch_reload(PC_watch_t* watch)
+{
+	PC_status_t status = PC_OK;
+
+	// reloads are serialized from the parse on, so that they are published in the order the file was read
+	pthread_mutex_lock(&watch->reload_mutex);
+	PC_tree_t tree = PC_parse_path(watch->path);
+	PC_handle_tree_err(tree, err1);
+	// the reference of the parse is that of the publication
+	PC_handle_err(PC_tree_freeze(&tree), err2);
+
+	PC_document_t* old = __atomic_exchange_n(&watch->current, tree.pcdoc, __ATOMIC_SEQ_CST);
+	unsigned long epoch = __atomic_fetch_add(&watch->epoch, 1, __ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&watch->readers[epoch & 1], __ATOMIC_SEQ_CST)) {
+		sched_yield();
+	}
+
+	if (watch->on_change) {
+		// changed & added keys of the new document, then removed ones
+		yaml_node_t* root = yaml_document_get_root_node(&tree.pcdoc->document);
+		yaml_node_t* old_root = yaml_document_get_root_node(&old->document);
+		size_t max_keys = (root && root->type == YAML_MAPPING_NODE ? root->data.mapping.pairs.top - root->data.mapping.pairs.start : 0)
+		                + (old_root && old_root->type == YAML_MAPPING_NODE ? old_root->data.mapping.pairs.top - old_root->data.mapping.pairs.start : 0);
+		const char** keys = malloc((max_keys ? max_keys : 1) * sizeof(const char*));
+		int nb_keys = 0;
+		if (keys) {
+			diff_keys(tree.pcdoc, old, 1, keys, &nb_keys);
+			diff_keys(old, tree.pcdoc, 0, keys, &nb_keys);
+		}
+		watch->on_change(tree, keys, nb_keys, watch->context);
+		free(keys);
+	}
+	pthread_mutex_unlock(&watch->reload_mutex);
+
+	doc_release(old);
+	return status;
+
+err2:
+	PC_tree_destroy(&tree);
+err1:
+	if (watch->on_change) {
+		PC_tree_t failed = {status, NULL, NULL};
+		watch->on_change(failed, NULL, 0, watch->context);
+	}
+	pthread_mutex_unlock(&watch->reload_mutex);
+	return status;
+}
+
+/** Checks whether the file changed since last checked, when polling
+ *
+ * \param watch the watch of the file
+ * \return whether the file changed
+ */
+static int file_changed(PC_watch_t* watch)
+{
+	struct stat file_stat;
+	if (stat(watch->path, &file_stat)) return 0;
+	int changed = file_stat.st_ino != watch->last_stat.st_ino || file_stat.st_size != watch->last_stat.st_size
+	           || file_stat.st_mtim.tv_sec != watch->last_stat.st_mtim.tv_sec || file_stat.st_mtim.tv_nsec != watch->last_stat.st_mtim.tv_nsec;
+	watch->last_stat = file_stat;
+	return changed;
+}
+
+/** Reloads the watched file each time it changes, until stopped
+ *
+ * \param context the watch
+ * \return NULL
+ */
+static void* watch_thread(void* context)
+{
+	PC_watch_t* watch = context;
+	PC_errhandler(PC_NULL_HANDLER); // errors are reported through the callback
+
+	const char* name = strrchr(watch->path, '/');
+	name = name ? name + 1 : watch->path;
+	for (;;) {
+		struct pollfd fds[2] = {{watch->stop_pipe[0], POLLIN, 0}, {watch->notify_fd, POLLIN, 0}};
+		int ready = poll(fds, watch->notify_fd >= 0 ? 2 : 1, watch->notify_fd >= 0 ? -1 : PC_WATCH_POLL_MS);
+		if (ready < 0 && errno != EINTR) break;
+		if (ready > 0 && fds[0].revents) break; // stopped
+
+		int changed = 0;
+#ifdef __linux__
+		if (watch->notify_fd >= 0) {
+			if (ready <= 0 || !(fds[1].revents & POLLIN)) continue;
+			char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+			ssize_t len = read(watch->notify_fd, buffer, sizeof(buffer));
+			for (ssize_t offset = 0; offset < len;) {
+				const struct inotify_event* event = (const struct inotify_event*)(buffer + offset);
+				if (event->len && !strcmp(event->name, name)) changed = 1;
+				offset += sizeof(struct inotify_event) + event->len;
+			}
+		} else
+#endif
+		{
+			changed = file_changed(watch);
+		}
+		if (changed) PC_watch_reload(watch);
+	}
+	return NULL;
+}
+
+/** Starts watching the directory of a file with inotify
+ *
+ * \param watch the watch of the file
+ * \return the inotify instance, -1 if unavailable
+ */
+static int notify_start(PC_watch_t* watch)
+{
+#ifdef __linux__
+	int notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notify_fd < 0) return -1;
+	// the directory is watched rather than the file, as editors replace files by renaming others
+	const char* name = strrchr(watch->path, '/');
+	char* dir = name ? strndup(watch->path, name == watch->path ? 1 : name - watch->path) : strdup(".");
+	if (!dir || inotify_add_watch(notify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		close(notify_fd);
+		notify_fd = -1;
+	}
+	free(dir);
+	return notify_fd;
+#else
+	(void)watch;
+	return -1;
+#endif
+}
+
+PC_status_t PC_watch_open(const char* path, PC_watch_f on_change, void* context, PC_watch_t** watch)
+{
+	PC_status_t status = PC_OK;
+
+	*watch = calloc(1, sizeof(PC_watch_t));
+	if (!*watch) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
+	}
+	(*watch)->path = strdup(path);
+	(*watch)->on_change = on_change;
+	(*watch)->context = context;
+	if (!(*watch)->path) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err1);
+	}
+	stat(path, &(*watch)->last_stat);
+
+	PC_tree_t tree = PC_parse_path(path);
+	PC_handle_tree_err(tree, err1);
+	(*watch)->current = tree.pcdoc;
+	// the reference of the parse is that of the publication
+	PC_handle_err(PC_tree_freeze(&tree), err2);
+
+	if (pipe((*watch)->stop_pipe)) {
+		char errbuf[ERRBUF_SIZE];
+		strerror_r(errno, errbuf, ERRBUF_SIZE);
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "%s", errbuf), err2);
+	}
+	(*watch)->notify_fd = notify_start(*watch);
+	pthread_mutex_init(&(*watch)->reload_mutex, NULL);
+	if (pthread_create(&(*watch)->thread, NULL, watch_thread, *watch)) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to start the thread watching `%s'\n", path), err3);
+	}
+
+	return status;
+
+err3:
+	pthread_mutex_destroy(&(*watch)->reload_mutex);
+	if ((*watch)->notify_fd >= 0) close((*watch)->notify_fd);
+	close((*watch)->stop_pipe[0]);
+	close((*watch)->stop_pipe[1]);
+err2:
+	doc_release((*watch)->current);
+err1:
+	free((*watch)->path);
+	free(*watch);
+	*watch = NULL;
+err0:
+	return status;
+}
+
+PC_tree_t PC_watch_acquire(PC_watch_t* watch)
+{
+	// announce the reader in its epoch, retry if a reload started meanwhile
+	unsigned long epoch;
+	for (;;) {
+		epoch = __atomic_load_n(&watch->epoch, __ATOMIC_SEQ_CST);
+		__atomic_fetch_add(&watch->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&watch->epoch, __ATOMIC_SEQ_CST) == epoch) break;
+		__atomic_fetch_sub(&watch->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+	}
+	PC_document_t* doc = __atomic_load_n(&watch->current, __ATOMIC_SEQ_CST);
+	__atomic_fetch_add(&doc->refs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_sub(&watch->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+
+	PC_tree_t restree = {PC_OK, doc, yaml_document_get_root_node(&doc->document)};
+	return restree;
+}
+
+PC_status_t PC_watch_release(PC_tree_t* tree)
+{
+	return PC_tree_release(tree);
+}
+
+PC_status_t PC_watch_close(PC_watch_t* watch)
+{
+	PC_status_t status = PC_OK;
+	if (!watch) return status;
+
+	char stop = 1;
+	while (write(watch->stop_pipe[1], &stop, 1) < 0 && errno == EINTR)
+		;
+	pthread_join(watch->thread, NULL);
+	pthread_mutex_destroy(&watch->reload_mutex);
+	if (watch->notify_fd >= 0) close(watch->notify_fd);
+	close(watch->stop_pipe[0]);
+	close(watch->stop_pipe[1]);
+
+	// the snapshots still acquired remain valid until released
+	doc_release(watch->current);
+	free(watch->path);
+	free(watch);
+	return status;
+}
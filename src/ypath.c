@@ -10,43 +10,149 @@
 
 #include "paraconf.h"
 
+#include "keyindex.h"
 #include "status.h"
 #include "tools.h"
 
 #include "ypath.h"
 
+/// maximum number of argument slots in a compiled ypath expression
+#define PC_PATH_MAX_SLOTS 16
+
 static const char* nodetype[4] = {"none", "scalar", "sequence", "mapping"};
 
-static PC_tree_t get_seq_idx(const PC_tree_t tree, const char** req_index, const char* full_index)
+/** The kind of a single step of a ypath expression
+ */
+typedef enum op_kind_e {
+	/// `[idx]': access to a sequence element
+	OP_SEQ_IDX,
+	/// `.key': access to a mapping value by key
+	OP_MAP_KEY,
+	/// `{idx}': access to a mapping key by index
+	OP_MAP_IDX_KEY,
+	/// `<idx>': access to a mapping value by index
+	OP_MAP_IDX_VAL
+} op_kind_t;
+
+/** A single step of a ypath expression
+ */
+typedef struct op_s {
+	/// the kind of step
+	op_kind_t kind;
+
+	/// the argument slot providing the index or key, -1 for a literal
+	int slot;
+
+	/// the literal index for OP_SEQ_IDX, OP_MAP_IDX_KEY & OP_MAP_IDX_VAL
+	long idx;
+
+	/// the literal key for OP_MAP_KEY (not null-terminated)
+	const char* key;
+
+	/// the length of key
+	size_t key_len;
+
+	/// the length of the expression up to this step, as reported in error messages
+	int end;
+
+} op_t;
+
+/** The type of an argument slot in a compiled ypath expression
+ */
+typedef enum slot_type_e {
+	SLOT_UNUSED = 0,
+	/// an int index
+	SLOT_INDEX,
+	/// a null-terminated key string
+	SLOT_KEY
+} slot_type_t;
+
+/** The value of an argument slot
+ */
+typedef union slot_value_u {
+	long idx;
+	const char* key;
+} slot_value_t;
+
+struct PC_path_s {
+	/// the ypath expression this was compiled from, referenced by the ops
+	char* source;
+
+	/// the type of each argument slot
+	slot_type_t slots[PC_PATH_MAX_SLOTS];
+
+	/// the number of argument slots
+	int nb_slots;
+
+	/// the number of steps
+	int nb_ops;
+
+	/// the steps
+	op_t ops[];
+};
+
+/** Reads an integer or, if allowed, an argument slot `$N'
+ */
+static PC_status_t parse_int(const char** req_index, const char* full_index, int allow_slots, const char* what, op_t* op)
 {
-	PC_tree_t restree = tree;
-	PC_handle_tree(err0);
+	PC_status_t status = PC_OK;
 
 	const char* index = *req_index;
+	char* post_index;
 
-	// read '['
-	if (*index != '[') {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected `[` at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
-			err0
-		);
+	if (allow_slots && *index == '$') {
+		long slot = strtol(index + 1, &post_index, 10);
+		if (post_index == index + 1 || slot < 0 || slot >= PC_PATH_MAX_SLOTS) {
+			PC_handle_err(
+				PC_make_err(
+					PC_INVALID_PARAMETER,
+					"Expected argument slot $0 to $%d at char #%ld of `%s'\n",
+					PC_PATH_MAX_SLOTS - 1,
+					(long int)(index - full_index),
+					full_index
+				),
+				err0
+			);
+		}
+		op->slot = slot;
+	} else {
+		op->idx = strtol(index, &post_index, 0);
+		if (post_index == index) {
+			PC_handle_err(
+				PC_make_err(
+					PC_INVALID_PARAMETER,
+					"Expected %s at char #%ld of `%s', but found `%c'\n",
+					what,
+					(long int)(index - full_index),
+					full_index,
+					*index
+				),
+				err0
+			);
+		}
 	}
-	++index;
 
-	// read int
-	char* post_index;
-	long seq_idx = strtol(index, &post_index, 0);
-	if (post_index == index) {
-		PC_handle_err_tree(
+	*req_index = post_index;
+	return status;
+
+err0:
+	return status;
+}
+
+/** Reads an expected character
+ */
+static PC_status_t parse_char(const char** req_index, const char* full_index, char expected)
+{
+	PC_status_t status = PC_OK;
+
+	const char* index = *req_index;
+
+	if (*index != expected) {
+		PC_handle_err(
 			PC_make_err(
 				PC_INVALID_PARAMETER,
-				"Expected integer at char #%ld of `%s', but found `%c'\n",
+				"Expected `%c' at char #%ld of `%s', but found `%c'\n",
+				expected,
 				(long int)(index - full_index),
 				full_index,
 				*index
@@ -54,14 +160,83 @@ static PC_tree_t get_seq_idx(const PC_tree_t tree, const char** req_index, const
 			err0
 		);
 	}
-	index = post_index;
 
-	// read ']'
-	if (*index != ']') {
-		PC_handle_err_tree(
+	*req_index = index + 1;
+	return status;
+
+err0:
+	return status;
+}
+
+/** Reads a single step of a ypath expression
+ *
+ * \param[in,out] req_index the position in the expression, moved after the step
+ * \param[in] full_index the whole expression, used in error messages
+ * \param[in] allow_slots whether `$N' argument slots are accepted
+ * \param[out] op the step read
+ * \return the status of the execution
+ */
+static PC_status_t parse_op(const char** req_index, const char* full_index, int allow_slots, op_t* op)
+{
+	PC_status_t status = PC_OK;
+
+	const char* index = *req_index;
+	op->slot = -1;
+
+	switch (*index) {
+	case '[':
+		op->kind = OP_SEQ_IDX;
+		++index;
+		PC_handle_err(parse_int(&index, full_index, allow_slots, "integer", op), err0);
+		PC_handle_err(parse_char(&index, full_index, ']'), err0);
+		op->end = index - full_index;
+		break;
+	case '.': {
+		op->kind = OP_MAP_KEY;
+		++index;
+		const char* key = index;
+		size_t key_len = 0;
+		while (key[key_len] && key[key_len] != '.' && key[key_len] != '[' && key[key_len] != '{' && key[key_len] != '<')
+			++key_len;
+		index += key_len;
+		if (allow_slots && key_len > 1 && key[0] == '$' && strspn(key + 1, "0123456789") == key_len - 1) {
+			op->slot = strtol(key + 1, NULL, 10);
+			if (op->slot >= PC_PATH_MAX_SLOTS) {
+				PC_handle_err(
+					PC_make_err(
+						PC_INVALID_PARAMETER,
+						"Expected argument slot $0 to $%d at char #%ld of `%s'\n",
+						PC_PATH_MAX_SLOTS - 1,
+						(long int)(key - full_index),
+						full_index
+					),
+					err0
+				);
+			}
+		}
+		op->key = key;
+		op->key_len = key_len;
+		op->end = index - full_index;
+	} break;
+	case '{':
+		op->kind = OP_MAP_IDX_KEY;
+		++index;
+		PC_handle_err(parse_int(&index, full_index, allow_slots, "an integer", op), err0);
+		op->end = index - full_index;
+		PC_handle_err(parse_char(&index, full_index, '}'), err0);
+		break;
+	case '<':
+		op->kind = OP_MAP_IDX_VAL;
+		++index;
+		PC_handle_err(parse_int(&index, full_index, allow_slots, "an integer", op), err0);
+		op->end = index - full_index;
+		PC_handle_err(parse_char(&index, full_index, '>'), err0);
+		break;
+	default:
+		PC_handle_err(
 			PC_make_err(
 				PC_INVALID_PARAMETER,
-				"Expected `]` at char #%ld of `%s', but found `%c'\n",
+				"Expected `[', `.', `{' or `<' at char #%ld of `%s', but found `%c'\n",
 				(long int)(index - full_index),
 				full_index,
 				*index
@@ -69,336 +244,517 @@ static PC_tree_t get_seq_idx(const PC_tree_t tree, const char** req_index, const
 			err0
 		);
 	}
-	++index;
 
-	// check type
-	if (tree.node->type != YAML_SEQUENCE_NODE) {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_NODE_TYPE,
-				"Expected a sequence, found a %s (request was: $tree%.*s)\n",
-				nodetype[tree.node->type],
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
-	}
+	*req_index = index;
+	return status;
 
-	// handle index
-	if (seq_idx < 0 || seq_idx >= (tree.node->data.sequence.items.top - tree.node->data.sequence.items.start)) {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_NODE_NOT_FOUND,
-				"Index %ld out of range [0...%ld) in sequence (request was: $tree%.*s)\n",
-				seq_idx,
-				(long)(tree.node->data.sequence.items.top - tree.node->data.sequence.items.start),
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
+err0:
+	return status;
+}
+
+/** Applies a single step of a ypath expression to a tree
+ *
+ * \param tree the tree to walk from
+ * \param op the step to apply
+ * \param full_index the whole expression, used in error messages
+ * \param slots the values of the argument slots
+ * \return the subtree reached
+ */
+static PC_tree_t apply_op(const PC_tree_t tree, const op_t* op, const char* full_index, const slot_value_t* slots)
+{
+	PC_tree_t restree = tree;
+	PC_handle_tree(err0);
+	PC_STATS_ADD(tree.pcdoc, nb_lookups, 1);
+
+	switch (op->kind) {
+	case OP_SEQ_IDX: {
+		long seq_idx = op->slot < 0 ? op->idx : slots[op->slot].idx;
+
+		// check type
+		if (tree.node->type != YAML_SEQUENCE_NODE) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_INVALID_NODE_TYPE,
+					"Expected a sequence, found a %s (request was: $tree%.*s)\n",
+					nodetype[tree.node->type],
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+
+		// handle index
+		if (seq_idx < 0 || seq_idx >= (tree.node->data.sequence.items.top - tree.node->data.sequence.items.start)) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_NODE_NOT_FOUND,
+					"Index %ld out of range [0...%ld) in sequence (request was: $tree%.*s)\n",
+					seq_idx,
+					(long)(tree.node->data.sequence.items.top - tree.node->data.sequence.items.start),
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+		restree.node = yaml_document_get_node(&tree.pcdoc->document, *(tree.node->data.sequence.items.start + seq_idx));
+	} break;
+	case OP_MAP_KEY: {
+		const char* key = op->key;
+		size_t key_len = op->key_len;
+		if (op->slot >= 0) {
+			key = slots[op->slot].key;
+			key_len = strlen(key);
+		}
+
+		// check type
+		if (tree.node->type != YAML_MAPPING_NODE) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_INVALID_NODE_TYPE,
+					"Expected a mapping, found a %s (request was: $tree%.*s)\n",
+					nodetype[tree.node->type],
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+
+		// handle key
+		yaml_node_pair_t* pair = pc_keyindex_find(tree.pcdoc, tree.node, key, key_len);
+		if (!pair) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_NODE_NOT_FOUND,
+					"Key `%.*s' not found in mapping (request was: $tree%.*s)\n",
+					(int)key_len,
+					key,
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+		restree = pc_pair_value(tree, pair);
+		PC_handle_tree(err0);
+	} break;
+	case OP_MAP_IDX_KEY:
+	case OP_MAP_IDX_VAL: {
+		long map_idx = op->slot < 0 ? op->idx : slots[op->slot].idx;
+
+		// check type
+		if (tree.node->type != YAML_MAPPING_NODE) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_INVALID_NODE_TYPE,
+					"Expected a mapping, found a %s (request was: $tree%.*s)\n",
+					nodetype[tree.node->type],
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+
+		// handle index
+		if (map_idx < 0 || map_idx >= (tree.node->data.mapping.pairs.top - tree.node->data.mapping.pairs.start)) {
+			PC_handle_err_tree(
+				PC_make_err(
+					PC_NODE_NOT_FOUND,
+					"Index %ld out of range [0...%ld] in mapping (request was: $tree%.*s)\n",
+					map_idx,
+					(long)(tree.node->data.mapping.pairs.top - tree.node->data.mapping.pairs.start),
+					op->end,
+					full_index
+				),
+				err0
+			);
+		}
+		yaml_node_pair_t* pair = tree.node->data.mapping.pairs.start + map_idx;
+		if (op->kind == OP_MAP_IDX_KEY) {
+			restree.node = yaml_document_get_node(&tree.pcdoc->document, pair->key);
+		} else {
+			restree = pc_pair_value(tree, pair);
+			PC_handle_tree(err0);
+		}
+	} break;
 	}
-	restree.node = yaml_document_get_node(&tree.pcdoc->document, *(tree.node->data.sequence.items.start + seq_idx));
-	assert(tree.node);
+	assert(restree.node);
 
-	*req_index = index;
 	return restree;
 
 err0:
+	PC_STATS_ERROR(tree, restree.status);
 	return restree;
 }
 
-static PC_tree_t get_map_key_val(const PC_tree_t tree, const char** req_index, const char* full_index)
+/** Applies a single step of a ypath expression without argument slots to a tree, without reporting errors
+ *
+ * \param[in,out] tree the node to walk from, replaced by the node reached
+ * \param op the step to apply
+ * \return whether a node was reached, the tree status is set if it could not be materialized
+ */
+static int find_op(PC_tree_t* tree, const op_t* op)
+{
+	const yaml_node_t* node = tree->node;
+	PC_STATS_ADD(tree->pcdoc, nb_lookups, 1);
+	switch (op->kind) {
+	case OP_SEQ_IDX:
+		if (node->type != YAML_SEQUENCE_NODE) return 0;
+		if (op->idx < 0 || op->idx >= (node->data.sequence.items.top - node->data.sequence.items.start)) return 0;
+		tree->node = yaml_document_get_node(&tree->pcdoc->document, node->data.sequence.items.start[op->idx]);
+		return 1;
+	case OP_MAP_KEY: {
+		if (node->type != YAML_MAPPING_NODE) return 0;
+		yaml_node_pair_t* pair = pc_keyindex_find(tree->pcdoc, tree->node, op->key, op->key_len);
+		if (!pair) return 0;
+		*tree = pc_pair_value(*tree, pair);
+		return 1;
+	}
+	case OP_MAP_IDX_KEY:
+	case OP_MAP_IDX_VAL: {
+		if (node->type != YAML_MAPPING_NODE) return 0;
+		if (op->idx < 0 || op->idx >= (node->data.mapping.pairs.top - node->data.mapping.pairs.start)) return 0;
+		yaml_node_pair_t* pair = node->data.mapping.pairs.start + op->idx;
+		if (op->kind == OP_MAP_IDX_KEY) {
+			tree->node = yaml_document_get_node(&tree->pcdoc->document, pair->key);
+		} else {
+			*tree = pc_pair_value(*tree, pair);
+		}
+		return 1;
+	}
+	}
+	return 0;
+}
+
+PC_tree_t pc_sget_quiet(const PC_tree_t tree, const char* index)
 {
 	PC_tree_t restree = tree;
 	PC_handle_tree(err0);
 
-	const char* index = *req_index;
+	const char* full_index = index;
 
-	// read '.'
-	if (*index != '.') {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected `.' at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
-			err0
-		);
+	while (*index) {
+		op_t op;
+		PC_handle_err_tree(parse_op(&index, full_index, 0, &op), err0);
+		if (!restree.node || !find_op(&restree, &op)) {
+			restree.status = PC_NODE_NOT_FOUND;
+			break;
+		}
+		PC_handle_tree(err0);
 	}
-	++index;
 
-	// read key
-	const char* key = index;
-	size_t key_len = 0;
-	while (key[key_len] && key[key_len] != '.' && key[key_len] != '[' && key[key_len] != '{' && key[key_len] != '<')
-		++key_len;
-	index += key_len;
+	return restree;
+
+err0:
+	return restree;
+}
+
+PC_tree_t PC_sget(const PC_tree_t tree, const char* index)
+{
+	PC_tree_t restree = tree;
+	PC_handle_tree(err0);
 
 	// check type
-	if (tree.node->type != YAML_MAPPING_NODE) {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_NODE_TYPE,
-				"Expected a mapping, found a %s (request was: $tree%.*s)\n",
-				nodetype[tree.node->type],
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
+	if (*index && !tree.node) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a node, found an empty tree\n"), err0);
 	}
 
-	// handle key
-	yaml_node_pair_t* pair;
-	for (pair = tree.node->data.mapping.pairs.start; pair != tree.node->data.mapping.pairs.top; ++pair) {
-		// get the key string
-		char* found_key;
-		PC_handle_err_tree(PC_string(subtree(tree, pair->key), &found_key), err0);
-
-		// check if we found the key, in that case, leave
-		int cmp = strlzcmp(key, found_key, key_len);
-		free(found_key);
-		if (!cmp) break;
-	}
-	if (pair == tree.node->data.mapping.pairs.top) {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_NODE_NOT_FOUND,
-				"Key `%.*s' not found in mapping (request was: $tree%.*s)\n",
-				key_len,
-				key,
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
+	const char* full_index = index;
+
+	while (*index) {
+		op_t op;
+		PC_handle_err_tree(parse_op(&index, full_index, 0, &op), err0);
+		restree = apply_op(restree, &op, full_index, NULL);
+		PC_handle_tree(err0);
 	}
-	restree.node = yaml_document_get_node(&tree.pcdoc->document, pair->value);
-	assert(tree.node);
 
-	*req_index = index;
 	return restree;
 
 err0:
 	return restree;
 }
 
-static PC_status_t get_map_idx_pair(const PC_tree_t tree, const char** req_index, const char* full_index, yaml_node_pair_t** pair)
+PC_status_t PC_path_compile(const char* ypath, PC_path_t** path)
 {
 	PC_status_t status = PC_OK;
-	PC_handle_tree_err(tree, err0);
 
-	const char* index = *req_index;
-
-	// read int
-	char* post_index;
-	long map_idx = strtol(index, &post_index, 0);
-	if (post_index == index) {
-		PC_handle_err(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected an integer at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
-			err0
-		);
+	// a step is at least 1 character long
+	size_t ypath_len = strlen(ypath);
+	size_t max_ops = ypath_len + 1;
+	PC_path_t* result = malloc(sizeof(PC_path_t) + max_ops * sizeof(op_t) + ypath_len + 1);
+	if (!result) {
+		PC_handle_err(PC_make_err(PC_SYSTEM_ERROR, "unable to allocate memory"), err0);
 	}
-	index = post_index;
-
-	// check type
-	if (tree.node->type != YAML_MAPPING_NODE) {
-		PC_handle_err(
-			PC_make_err(
-				PC_INVALID_NODE_TYPE,
-				"Expected a mapping, found a %s (request was: $tree%.*s)\n",
-				nodetype[tree.node->type],
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
+	result->source = (char*)(result->ops + max_ops);
+	memcpy(result->source, ypath, ypath_len + 1);
+	memset(result->slots, 0, sizeof(result->slots));
+	result->nb_slots = 0;
+	result->nb_ops = 0;
+
+	const char* index = result->source;
+	while (*index) {
+		op_t* op = &result->ops[result->nb_ops++];
+		PC_handle_err(parse_op(&index, result->source, 1, op), err1);
+		if (op->slot < 0) continue;
+
+		slot_type_t type = op->kind == OP_MAP_KEY ? SLOT_KEY : SLOT_INDEX;
+		if (result->slots[op->slot] != SLOT_UNUSED && result->slots[op->slot] != type) {
+			PC_handle_err(
+				PC_make_err(PC_INVALID_PARAMETER, "Argument slot $%d used both as an index and as a key in `%s'\n", op->slot, ypath),
+				err1
+			);
+		}
+		result->slots[op->slot] = type;
+		if (op->slot >= result->nb_slots) result->nb_slots = op->slot + 1;
 	}
 
-	// handle index
-	if (map_idx < 0 || map_idx >= (tree.node->data.mapping.pairs.top - tree.node->data.mapping.pairs.start)) {
-		PC_handle_err(
-			PC_make_err(
-				PC_NODE_NOT_FOUND,
-				"Index %ld out of range [0...%ld] in mapping (request was: $tree%.*s)\n",
-				map_idx,
-				(long)(tree.node->data.mapping.pairs.top - tree.node->data.mapping.pairs.start),
-				(int)(index - full_index),
-				full_index
-			),
-			err0
-		);
+	for (int slot = 0; slot < result->nb_slots; ++slot) {
+		if (result->slots[slot] == SLOT_UNUSED) {
+			PC_handle_err(PC_make_err(PC_INVALID_PARAMETER, "Argument slot $%d is not used in `%s'\n", slot, ypath), err1);
+		}
 	}
-	*pair = tree.node->data.mapping.pairs.start + map_idx;
-	assert(*pair);
 
-	*req_index = index;
+	*path = result;
 	return status;
 
+err1:
+	free(result);
 err0:
 	return status;
 }
 
-static PC_tree_t get_map_idx_key(const PC_tree_t tree, const char** req_index, const char* full_index)
+PC_status_t PC_path_destroy(PC_path_t* path)
+{
+	free(path);
+	return PC_OK;
+}
+
+/** Evaluates a compiled ypath expression once its argument slots are known
+ */
+static PC_tree_t path_eval(const PC_tree_t tree, const PC_path_t* path, const slot_value_t* slots)
 {
 	PC_tree_t restree = tree;
 	PC_handle_tree(err0);
 
-	const char* index = *req_index;
+	// check type
+	if (path->nb_ops && !tree.node) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a node, found an empty tree\n"), err0);
+	}
 
-	// read '{'
-	if (*index != '{') {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected `{' at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
-			err0
-		);
+	for (int op_idx = 0; op_idx < path->nb_ops; ++op_idx) {
+		restree = apply_op(restree, &path->ops[op_idx], path->source, slots);
+		PC_handle_tree(err0);
 	}
-	++index;
 
-	// get pair
-	yaml_node_pair_t* pair = NULL;
-	PC_handle_err_tree(get_map_idx_pair(tree, &index, full_index, &pair), err0);
+	return restree;
 
-	// read '}'
-	if (*index != '}') {
-		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected `}' at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
-			err0
-		);
+err0:
+	return restree;
+}
+
+int pc_path_length(const PC_path_t* path)
+{
+	return path->nb_ops;
+}
+
+int pc_path_nb_slots(const PC_path_t* path)
+{
+	return path->nb_slots;
+}
+
+/** Compares two steps of compiled ypath expressions without argument slots
+ */
+static int op_compare(const op_t* op1, const op_t* op2)
+{
+	if (op1->kind != op2->kind) return op1->kind < op2->kind ? -1 : 1;
+	if (op1->kind != OP_MAP_KEY) return op1->idx < op2->idx ? -1 : op1->idx > op2->idx;
+	int result = memcmp(op1->key, op2->key, op1->key_len < op2->key_len ? op1->key_len : op2->key_len);
+	if (result) return result;
+	return op1->key_len < op2->key_len ? -1 : op1->key_len > op2->key_len;
+}
+
+int pc_path_compare(const PC_path_t* path1, const PC_path_t* path2, int* common)
+{
+	int op_idx = 0;
+	while (op_idx < path1->nb_ops && op_idx < path2->nb_ops) {
+		int result = op_compare(&path1->ops[op_idx], &path2->ops[op_idx]);
+		if (result) {
+			if (common) *common = op_idx;
+			return result;
+		}
+		++op_idx;
 	}
-	++index;
+	if (common) *common = op_idx;
+	return path1->nb_ops < path2->nb_ops ? -1 : path1->nb_ops > path2->nb_ops;
+}
 
-	// handle pair
-	restree.node = yaml_document_get_node(&tree.pcdoc->document, pair->key);
-	assert(tree.node);
+PC_tree_t pc_path_step(const PC_tree_t tree, const PC_path_t* path, int op_idx)
+{
+	PC_tree_t restree = tree;
+	PC_handle_tree(err0);
 
-	*req_index = index;
-	return restree;
+	// check type
+	if (!tree.node) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a node, found an empty tree\n"), err0);
+	}
+
+	return apply_op(tree, &path->ops[op_idx], path->source, NULL);
 
 err0:
 	return restree;
 }
 
-static PC_tree_t get_map_idx_val(const PC_tree_t tree, const char** req_index, const char* full_index)
+PC_tree_t PC_cget(const PC_tree_t tree, const PC_path_t* path, ...)
+{
+	va_list ap;
+	va_start(ap, path);
+	PC_tree_t res = PC_cvget(tree, path, ap);
+	va_end(ap);
+	return res;
+}
+
+PC_tree_t PC_cvget(const PC_tree_t tree, const PC_path_t* path, va_list va)
+{
+	slot_value_t slots[PC_PATH_MAX_SLOTS];
+	for (int slot = 0; slot < path->nb_slots; ++slot) {
+		if (path->slots[slot] == SLOT_KEY) {
+			slots[slot].key = va_arg(va, const char*);
+		} else {
+			slots[slot].idx = va_arg(va, int);
+		}
+	}
+	return path_eval(tree, path, slots);
+}
+
+PC_tree_t PC_cget_idx(const PC_tree_t tree, const PC_path_t* path, const int* indices)
 {
 	PC_tree_t restree = tree;
 	PC_handle_tree(err0);
 
-	const char* index = *req_index;
+	slot_value_t slots[PC_PATH_MAX_SLOTS];
+	for (int slot = 0; slot < path->nb_slots; ++slot) {
+		if (path->slots[slot] == SLOT_KEY) {
+			PC_handle_err_tree(
+				PC_make_err(PC_INVALID_PARAMETER, "Argument slot $%d of `%s' is a key, only indices can be provided\n", slot, path->source),
+				err0
+			);
+		}
+		slots[slot].idx = indices[slot];
+	}
+	return path_eval(tree, path, slots);
+
+err0:
+	return restree;
+}
 
-	// read '<'
-	if (*index != '<') {
+PC_tree_t PC_cget_args(const PC_tree_t tree, const PC_path_t* path, int nb_indices, const int* indices, int nb_keys, const char* const* keys)
+{
+	PC_tree_t restree = tree;
+	PC_handle_tree(err0);
+
+	slot_value_t slots[PC_PATH_MAX_SLOTS];
+	int nb_index_slots = 0, nb_key_slots = 0;
+	for (int slot = 0; slot < path->nb_slots; ++slot) {
+		if (path->slots[slot] == SLOT_KEY) {
+			if (nb_key_slots < nb_keys) slots[slot].key = keys[nb_key_slots];
+			++nb_key_slots;
+		} else {
+			if (nb_index_slots < nb_indices) slots[slot].idx = indices[nb_index_slots];
+			++nb_index_slots;
+		}
+	}
+	if (nb_index_slots != nb_indices || nb_key_slots != nb_keys) {
 		PC_handle_err_tree(
 			PC_make_err(
 				PC_INVALID_PARAMETER,
-				"Expected `<' at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
+				"Expected %d indices and %d keys for the argument slots of `%s', got %d indices and %d keys\n",
+				nb_index_slots,
+				nb_key_slots,
+				path->source,
+				nb_indices,
+				nb_keys
 			),
 			err0
 		);
 	}
-	++index;
+	return path_eval(tree, path, slots);
 
-	// get pair
-	yaml_node_pair_t* pair = NULL;
-	PC_handle_err_tree(get_map_idx_pair(tree, &index, full_index, &pair), err0);
+err0:
+	return restree;
+}
+
+PC_tree_t PC_key_opt(const PC_tree_t tree, const char* key, size_t key_len)
+{
+	PC_tree_t restree = tree;
+	PC_handle_tree(err0);
+	PC_STATS_ADD(tree.pcdoc, nb_lookups, 1);
 
-	// read '>'
-	if (*index != '>') {
+	// check type
+	if (!tree.node) {
+		PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a node, found an empty tree\n"), err0);
+	}
+
+	if (tree.node->type != YAML_MAPPING_NODE) {
 		PC_handle_err_tree(
-			PC_make_err(
-				PC_INVALID_PARAMETER,
-				"Expected `>' at char #%ld of `%s', but found `%c'\n",
-				(long int)(index - full_index),
-				full_index,
-				*index
-			),
+			PC_make_err(PC_INVALID_NODE_TYPE, "Expected a mapping, found a %s (request was: key `%.*s')\n", nodetype[tree.node->type], (int)key_len, key),
 			err0
 		);
 	}
-	++index;
 
-	// handle pair
-	restree.node = yaml_document_get_node(&tree.pcdoc->document, pair->value);
-	assert(tree.node);
+	yaml_node_pair_t* pair = pc_keyindex_find(tree.pcdoc, tree.node, key, key_len);
+	if (pair) {
+		restree = pc_pair_value(tree, pair);
+	} else {
+		restree.node = NULL;
+	}
 
-	*req_index = index;
+err0:
+	PC_STATS_ERROR(tree, restree.status);
 	return restree;
+}
+
+PC_tree_t PC_key(const PC_tree_t tree, const char* key, size_t key_len)
+{
+	PC_tree_t restree = PC_key_opt(tree, key, key_len);
+	PC_handle_tree(err0);
+
+	if (!restree.node) {
+		PC_STATS_ADD(tree.pcdoc, nb_errors, 1); // errors of PC_key_opt are already counted
+		PC_handle_err_tree(PC_make_err(PC_NODE_NOT_FOUND, "Key `%.*s' not found in mapping\n", (int)key_len, key), err0);
+	}
 
 err0:
 	return restree;
 }
 
-PC_tree_t PC_sget(const PC_tree_t tree, const char* index)
+PC_tree_t PC_at(const PC_tree_t tree, int index)
 {
 	PC_tree_t restree = tree;
 	PC_handle_tree(err0);
+	PC_STATS_ADD(tree.pcdoc, nb_lookups, 1);
 
 	// check type
-	if (*index && !tree.node) {
+	if (!tree.node) {
 		PC_handle_err_tree(PC_make_err(PC_INVALID_NODE_TYPE, "Expected a node, found an empty tree\n"), err0);
 	}
 
-	const char* full_index = index;
-
-	while (!PC_status(restree)) {
-		switch (*index) {
-		case '[':
-			restree = get_seq_idx(restree, &index, full_index);
-			break;
-		case '.':
-			restree = get_map_key_val(restree, &index, full_index);
-			break;
-		case '{':
-			restree = get_map_idx_key(restree, &index, full_index);
-			break;
-		case '<':
-			restree = get_map_idx_val(restree, &index, full_index);
-			break;
-		case 0:
-			assert(restree.node);
-			goto brake_out_of_while;
-		default:
-			PC_handle_err_tree(
-				PC_make_err(
-					PC_INVALID_PARAMETER,
-					"Expected `[', `.', `{' or `<' at char #%ld of `%s', but found `%c'\n",
-					(long int)(index - full_index),
-					full_index,
-					*index
-				),
-				err0
-			);
-		}
+	if (tree.node->type != YAML_SEQUENCE_NODE) {
+		PC_handle_err_tree(
+			PC_make_err(PC_INVALID_NODE_TYPE, "Expected a sequence, found a %s (request was: index %d)\n", nodetype[tree.node->type], index),
+			err0
+		);
 	}
-brake_out_of_while:
 
-	return restree;
+	long len = tree.node->data.sequence.items.top - tree.node->data.sequence.items.start;
+	if (index < 0 || index >= len) {
+		PC_handle_err_tree(PC_make_err(PC_NODE_NOT_FOUND, "Index %d out of range [0...%ld) in sequence\n", index, len), err0);
+	}
+	restree.node = yaml_document_get_node(&tree.pcdoc->document, tree.node->data.sequence.items.start[index]);
 
 err0:
+	PC_STATS_ERROR(tree, restree.status);
 	return restree;
 }
@@ -9,13 +9,125 @@
 
 #include "paraconf.h"
 
+#include "stats.h"
+
+typedef struct pc_keyindex_s pc_keyindex_t;
+
+typedef struct pc_scalars_s pc_scalars_t;
+
+typedef struct pc_lazy_s pc_lazy_t;
+
+typedef struct pc_overlay_s pc_overlay_t;
+
 struct PC_document_s {
 	/// The underlying YAML document
 	yaml_document_t document;
 	/// The path to the file from which the document was parsed
 	const char* path;
+	/// The lazily built hash indices of the mapping keys
+	pc_keyindex_t* keyindex;
+	/// The memory block holding the whole document once frozen, NULL before
+	void* arena;
+	/// The pre-converted values of the scalars, NULL until PC_tree_resolve
+	pc_scalars_t* scalars;
+	/// The index of the top-level values still to parse, NULL unless parsed by PC_parse_path_lazy
+	pc_lazy_t* lazy;
+	/// The lazily parsed document owning this one, NULL for a top-level document
+	PC_document_t* parent;
+	/// Where the values of the mappings are found, NULL unless built by PC_overlay
+	pc_overlay_t* overlay;
+	/// The number of references held on the document, see PC_tree_retain
+	unsigned long refs;
+#ifdef PARACONF_ENABLE_STATS
+	/// The instrumentation counters
+	pc_counters_t counters;
+#endif
 };
 
 PC_tree_t PARACONF_EXPORT PC_sget(PC_tree_t tree, const char* index);
 
+/** Returns the value of a pair of the root mapping of a lazily parsed
+ * document, parsing it on first access
+ *
+ * \param map the mapping containing the pair
+ * \param pair the pair whose value to return
+ * \return the value, or a tree in error if its source could not be parsed
+ */
+PC_tree_t pc_lazy_value(PC_tree_t map, const yaml_node_pair_t* pair);
+
+/** Returns the value of a pair of a mapping of an overlay document, from the
+ * layer it comes from
+ *
+ * \param map the mapping containing the pair
+ * \param pair the pair whose value to return
+ * \return the value
+ */
+PC_tree_t pc_overlay_value(PC_tree_t map, const yaml_node_pair_t* pair);
+
+/** Loads a document held in memory with the first parser backend supporting
+ * it
+ *
+ * The PARACONF_PARSER environment variable restricts the backends tried to the
+ * one it names, "libyaml" disables them all. The backends do not set the marks
+ * of the nodes.
+ *
+ * \param data the document to load
+ * \param size the size of the document in bytes
+ * \param[out] document the document loaded
+ * \return whether a backend loaded the document, if not, libyaml has to
+ */
+int pc_backend_load(const unsigned char* data, size_t size, yaml_document_t* document);
+
+/** Returns the value of a pair of a mapping
+ *
+ * \param map the mapping containing the pair
+ * \param pair the pair whose value to return
+ * \return the value, or a tree in error if it could not be materialized
+ */
+static inline PC_tree_t pc_pair_value(PC_tree_t map, const yaml_node_pair_t* pair)
+{
+	if (map.pcdoc->lazy) return pc_lazy_value(map, pair);
+	if (map.pcdoc->overlay) return pc_overlay_value(map, pair);
+	map.node = yaml_document_get_node(&map.pcdoc->document, pair->value);
+	return map;
+}
+
+/** Looks for a node given a ypath index without reporting it missing
+ *
+ * Only syntax errors in the index are reported through the error handler, a
+ * missing node only sets the returned tree status.
+ *
+ * \param tree the tree to walk from
+ * \param index the ypath index, without argument slots
+ * \return the node found or a tree with the PC_NODE_NOT_FOUND status if there is none
+ */
+PC_tree_t pc_sget_quiet(PC_tree_t tree, const char* index);
+
+/** Returns the number of steps of a compiled ypath expression
+ */
+int pc_path_length(const PC_path_t* path);
+
+/** Returns the number of argument slots of a compiled ypath expression
+ */
+int pc_path_nb_slots(const PC_path_t* path);
+
+/** Compares two compiled ypath expressions without argument slots, step by step
+ *
+ * \param path1 the first expression
+ * \param path2 the second expression
+ * \param[out] common the number of leading steps both have in common, can be NULL
+ * \return a negative, zero or positive value if path1 is respectively before,
+ *         equal to or after path2
+ */
+int pc_path_compare(const PC_path_t* path1, const PC_path_t* path2, int* common);
+
+/** Applies a single step of a compiled ypath expression without argument slots
+ *
+ * \param tree the tree to walk from
+ * \param path the expression
+ * \param op_idx the index of the step to apply
+ * \return the subtree reached
+ */
+PC_tree_t pc_path_step(PC_tree_t tree, const PC_path_t* path, int op_idx);
+
 #endif // YPATH_H__
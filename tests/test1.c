@@ -43,6 +43,18 @@ int main(int argc, char* argv[])
 	PC_string(PC_get(conf, ".a_string"), &a_string);
 	TST_EXPECT(!strcmp("this is a string", a_string));
 	free(a_string);
+	const char* a_string_view;
+	int a_string_len;
+	PC_string_view(PC_get(conf, ".a_string"), &a_string_view, &a_string_len);
+	TST_EXPECT(a_string_len == 16 && !strcmp("this is a string", a_string_view));
+	char a_string_buf[17];
+	PC_string_copy(PC_get(conf, ".a_string"), a_string_buf, sizeof(a_string_buf), NULL);
+	TST_EXPECT(!strcmp("this is a string", a_string_buf));
+	PC_errhandler_t view_handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_string_copy(PC_get(conf, ".a_string"), a_string_buf, 16, &a_string_len) == PC_INVALID_PARAMETER);
+	TST_EXPECT(a_string_len == 16);
+	TST_EXPECT(PC_string_view(PC_get(conf, ".a_list"), &a_string_view, NULL) == PC_INVALID_NODE_TYPE);
+	PC_errhandler(view_handler);
 	int a_list_len;
 	PC_len(PC_get(conf, ".a_list"), &a_list_len);
 	TST_EXPECT(a_list_len == 2);
@@ -62,10 +74,73 @@ int main(int argc, char* argv[])
 	long another_list_1;
 	PC_int(PC_get(conf, ".another_list[1]"), &another_list_1);
 	TST_EXPECT(another_list_1 == 31);
+	long another_list[2];
+	PC_int_array(PC_get(conf, ".another_list"), another_list, 2);
+	TST_EXPECT(another_list[0] == 30 && another_list[1] == 31);
+	double a_list_d[2];
+	PC_double_array(PC_get(conf, ".a_list"), a_list_d, 2);
+	TST_EXPECT(a_list_d[0] == 10. && a_list_d[1] == 11.);
+	PC_tree_t bools = PC_parse_string("[yes, No, TRUE]");
+	int bool_values[3];
+	PC_bool_array(bools, bool_values, 3);
+	TST_EXPECT(bool_values[0] == 1 && bool_values[1] == 0 && bool_values[2] == 1);
+	PC_tree_destroy(&bools);
+	PC_errhandler_t array_handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_int_array(PC_get(conf, ".a_list"), another_list, 1) == PC_INVALID_PARAMETER);
+	TST_EXPECT(PC_int_array(PC_get(conf, ".a_map"), another_list, 2) == PC_INVALID_NODE_TYPE);
+	PC_tree_t invalid = PC_parse_string("[1, x, [2], 3.5, 4, y, z, w]");
+	long invalid_values[8];
+	TST_EXPECT(PC_int_array(invalid, invalid_values, 8) == PC_INVALID_PARAMETER);
+	TST_EXPECT(invalid_values[0] == 1 && invalid_values[4] == 4);
+	TST_EXPECT(strstr(PC_errmsg(), "found 6 invalid items out of 8") && strstr(PC_errmsg(), "[2]: sequence"));
+	TST_EXPECT(strstr(PC_errmsg(), "[1]: `x'") && !strstr(PC_errmsg(), "[6]") && strstr(PC_errmsg(), "..."));
+	PC_tree_destroy(&invalid);
+	PC_errhandler(array_handler);
 	long another_map_second;
 	PC_int(PC_get(conf, ".another_map.second"), &another_map_second);
 	TST_EXPECT(another_map_second == 41);
 
+	PC_path_t* a_list_idx;
+	PC_path_compile(".a_list[$0]", &a_list_idx);
+	long a_list_1;
+	PC_int(PC_cget(conf, a_list_idx, 1), &a_list_1);
+	TST_EXPECT(a_list_1 == 11);
+	int indices[] = {0};
+	PC_int(PC_cget_idx(conf, a_list_idx, indices), &a_list_0);
+	TST_EXPECT(a_list_0 == 10);
+	PC_path_destroy(a_list_idx);
+	PC_path_t* map_key_val;
+	PC_path_compile(".$0.$1", &map_key_val);
+	PC_int(PC_cget(conf, map_key_val, "another_map", "second"), &another_map_second);
+	TST_EXPECT(another_map_second == 41);
+	PC_path_destroy(map_key_val);
+	PC_path_t* key_idx;
+	PC_path_compile(".$0[$1]", &key_idx);
+	const char* keys[] = {"another_list"};
+	indices[0] = 1;
+	PC_int(PC_cget_args(conf, key_idx, 1, indices, 1, keys), &another_list_1);
+	TST_EXPECT(another_list_1 == 31);
+	PC_path_t* map_idx;
+	PC_path_compile(".a_map<$0>", &map_idx);
+	long a_map_1_v;
+	PC_int(PC_cget(conf, map_idx, 1), &a_map_1_v);
+	TST_EXPECT(a_map_1_v == 21);
+	PC_path_destroy(map_idx);
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_path_t* bad_path = NULL;
+	TST_EXPECT(PC_path_compile(".a_map<$1>", &bad_path) == PC_INVALID_PARAMETER);
+	TST_EXPECT(PC_path_compile(".$0[$0]", &bad_path) == PC_INVALID_PARAMETER);
+	TST_EXPECT(PC_path_compile(".a_list[$16]", &bad_path) == PC_INVALID_PARAMETER);
+	TST_EXPECT(!bad_path);
+	PC_path_compile(".a_list[$0]", &a_list_idx);
+	TST_EXPECT(PC_status(PC_cget(conf, a_list_idx, 2)) == PC_NODE_NOT_FOUND);
+	PC_path_destroy(a_list_idx);
+	TST_EXPECT(PC_status(PC_cget_args(conf, key_idx, 0, NULL, 1, keys)) == PC_INVALID_PARAMETER);
+	TST_EXPECT(PC_status(PC_cget_args(conf, key_idx, 1, indices, 0, NULL)) == PC_INVALID_PARAMETER);
+	TST_EXPECT(PC_status(PC_cget_args(conf, key_idx, 2, (int[]){1, 1}, 1, keys)) == PC_INVALID_PARAMETER);
+	PC_path_destroy(key_idx);
+	PC_errhandler(handler);
+
 	int a_true;
 	PC_bool(PC_get(conf, ".a_true"), &a_true);
 	TST_EXPECT(a_true == 1);
@@ -103,5 +178,7 @@ int main(int argc, char* argv[])
 	PC_bool(PC_get(conf, ".a_NO"), &a_NO);
 	TST_EXPECT(a_NO == 0);
 
+	PC_tree_destroy(&conf);
+
 	return 0;
 }
@@ -0,0 +1,44 @@
+! Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+!               root of the project or at https://github.com/pdidev/paraconf
+!
+! SPDX-License-Identifier: MIT
+
+! Checks the Fortran reader generated from test9_schema.yml
+program test10
+
+  use paraconf
+  use test10_config
+
+  implicit none
+
+  type(PC_tree_t) :: conf, mesh
+  type(test10_config_t) :: config
+  integer :: status
+  character(len=4096) :: infile
+
+  if (command_argument_count() /= 1) then
+    print *, "Error: expected 1 argument!"
+    error stop
+  endif
+  call get_command_argument(1, infile)
+
+  call PC_parse_path(infile, conf)
+  call test10_config_read(conf, config, status)
+  if (status /= PC_OK) stop 1
+  if (config%mesh%nx /= 64 .or. config%mesh%ny /= 16) stop 2
+  if (size(config%mesh%origin) /= 2) stop 3
+  if (config%mesh%origin(1) /= 0.5d0 .or. config%mesh%origin(2) /= -1d0) stop 4
+  if (config%solver%name /= "gmres") stop 5
+  if (config%solver%dt /= 1d-3 .or. .not. config%solver%preconditioned) stop 6
+  if (allocated(config%output)) stop 7
+  if (size(config%flags) /= 2) stop 8
+  if (.not. config%flags(1) .or. config%flags(2)) stop 9
+
+  ! the mesh mapping is not a valid configuration on its own
+  call PC_errhandler(PC_NULL_HANDLER)
+  mesh = PC_get(conf, ".mesh")
+  call test10_config_read(mesh, config, status)
+  if (status /= PC_NODE_NOT_FOUND) stop 10
+  call PC_tree_destroy(conf)
+
+end program test10
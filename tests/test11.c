@@ -0,0 +1,85 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks the sequence and mapping iterators
+ */
+int main()
+{
+	PC_tree_t conf = PC_parse_string("{seq: [10, 11, 12], map: {a: 1, b: 2}, empty: [], scalar: 3}");
+
+	// sequence items come in order
+	PC_seq_iter_t seq;
+	TST_EXPECT(!PC_seq_begin(PC_get(conf, ".seq"), &seq));
+	long expected = 10;
+	while (PC_seq_next(&seq)) {
+		long value;
+		TST_EXPECT(!PC_int(PC_seq_value(&seq), &value));
+		TST_EXPECT(value == expected);
+		++expected;
+	}
+	TST_EXPECT(expected == 13);
+	TST_EXPECT(!PC_seq_next(&seq)); // stays at the end
+
+	// mapping pairs come in document order
+	PC_map_iter_t map;
+	TST_EXPECT(!PC_map_begin(PC_get(conf, ".map"), &map));
+	const char* keys[] = {"a", "b"};
+	int nb_pairs = 0;
+	while (PC_map_next(&map)) {
+		char* key;
+		long value;
+		TST_EXPECT(!PC_string(PC_map_key(&map), &key));
+		TST_EXPECT(!strcmp(key, keys[nb_pairs]));
+		free(key);
+		TST_EXPECT(!PC_int(PC_map_value(&map), &value));
+		TST_EXPECT(value == nb_pairs + 1);
+		++nb_pairs;
+	}
+	TST_EXPECT(nb_pairs == 2);
+	TST_EXPECT(!PC_map_next(&map));
+
+	// an empty sequence is a valid empty iteration
+	TST_EXPECT(!PC_seq_begin(PC_get(conf, ".empty"), &seq));
+	TST_EXPECT(!PC_seq_next(&seq));
+
+	// invalid nodes report an error and iterate over nothing
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_seq_begin(PC_get(conf, ".scalar"), &seq) == PC_INVALID_NODE_TYPE);
+	TST_EXPECT(!PC_seq_next(&seq));
+	TST_EXPECT(PC_map_begin(PC_get(conf, ".seq"), &map) == PC_INVALID_NODE_TYPE);
+	TST_EXPECT(!PC_map_next(&map));
+	TST_EXPECT(PC_seq_begin(PC_get(conf, ".missing"), &seq) == PC_NODE_NOT_FOUND);
+	TST_EXPECT(!PC_seq_next(&seq));
+	PC_errhandler(handler);
+
+	// iterators work on frozen documents
+	TST_EXPECT(!PC_tree_freeze(&conf));
+	TST_EXPECT(!PC_map_begin(conf, &map));
+	nb_pairs = 0;
+	while (PC_map_next(&map)) {
+		++nb_pairs;
+	}
+	TST_EXPECT(nb_pairs == 4);
+
+	PC_tree_destroy(&conf);
+	return 0;
+}
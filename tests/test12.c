@@ -0,0 +1,90 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Keeps a copy of the messages it is notified of
+ */
+void tst_capture(PC_status_t status, const char* message, void* context)
+{
+	(void)status;
+	char** captured = context;
+	free(*captured);
+	*captured = strdup(message);
+}
+
+/* Triggers an error through a path that is freed before the message is read
+ */
+PC_status_t tst_fail(PC_tree_t conf, const char* request)
+{
+	char* path = strdup(request);
+	PC_tree_t result = PC_get(conf, path);
+	memset(path, 'X', strlen(path));
+	free(path);
+	return PC_status(result);
+}
+
+void* tst_thread(void* conf)
+{
+	PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(tst_fail(*(PC_tree_t*)conf, ".thread") == PC_NODE_NOT_FOUND);
+	TST_EXPECT(strstr(PC_errmsg(), "`thread'") != NULL);
+	return NULL;
+}
+
+/* Checks the messages formatted when PC_errmsg is called match those given to handlers
+ */
+int main()
+{
+	const char* requests[] = {".missing", ".seq[7]", ".seq.key", ".map[0]", ".map!", ".seq[$3]", ".map{2}"};
+	enum { NB_REQUESTS = sizeof(requests) / sizeof(requests[0]) };
+
+	PC_tree_t conf = PC_parse_string("{seq: [1, 2], map: {a: 1}}");
+	char* captured = NULL;
+	PC_errhandler_t handler = PC_errhandler((PC_errhandler_t){tst_capture, &captured});
+	for (int ii = 0; ii < NB_REQUESTS; ++ii) {
+		PC_errhandler((PC_errhandler_t){tst_capture, &captured});
+		PC_status_t eager_status = tst_fail(conf, requests[ii]);
+		TST_EXPECT(eager_status != PC_OK);
+		TST_EXPECT(captured && !strcmp(captured, PC_errmsg()));
+
+		PC_errhandler(PC_NULL_HANDLER);
+		TST_EXPECT(tst_fail(conf, requests[ii]) == eager_status);
+		TST_EXPECT(!strcmp(captured, PC_errmsg()));
+		TST_EXPECT(!strcmp(captured, PC_errmsg())); // formatted once
+	}
+
+	// a new error replaces a message that was never read
+	PC_int(PC_get(conf, ".seq"), &(long){0});
+	TST_EXPECT(tst_fail(conf, ".other") == PC_NODE_NOT_FOUND);
+	TST_EXPECT(strstr(PC_errmsg(), "`other'") != NULL);
+
+	// each thread has its own message
+	pthread_t thread;
+	TST_EXPECT(!pthread_create(&thread, NULL, tst_thread, &conf));
+	TST_EXPECT(!pthread_join(thread, NULL));
+	TST_EXPECT(strstr(PC_errmsg(), "`other'") != NULL);
+
+	PC_errhandler(handler);
+	free(captured);
+	PC_tree_destroy(&conf);
+	return 0;
+}
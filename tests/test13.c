@@ -0,0 +1,88 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Fails on any reported error
+ */
+void tst_no_error(PC_status_t status, const char* message, void* context)
+{
+	(void)context;
+	fprintf(stderr, "Unexpected error %d: %s\n", status, message);
+	exit(1);
+}
+
+/* Checks the probes never report missing nodes
+ */
+int main()
+{
+	PC_tree_t conf = PC_parse_string("{i: 3, d: 1.5, b: yes, s: text, seq: [1, 2], map: {a: 1}, bad: xyz}");
+	PC_errhandler_t handler = PC_errhandler((PC_errhandler_t){tst_no_error, NULL});
+
+	TST_EXPECT(PC_has(conf, ".i"));
+	TST_EXPECT(PC_has(conf, ".seq[1]"));
+	TST_EXPECT(PC_has(conf, ".map{0}") && PC_has(conf, ".map<0>"));
+	TST_EXPECT(PC_has(conf, ""));
+	TST_EXPECT(!PC_has(conf, ".missing"));
+	TST_EXPECT(!PC_has(conf, ".seq[2]") && !PC_has(conf, ".seq[-1]"));
+	TST_EXPECT(!PC_has(conf, ".i.sub") && !PC_has(conf, ".map[0]") && !PC_has(conf, ".seq.a"));
+	TST_EXPECT(!PC_has(PC_key_opt(conf, "none", 4), ".a"));
+
+	TST_EXPECT(PC_type(conf) == PC_NODE_MAPPING);
+	TST_EXPECT(PC_type(PC_key(conf, "seq", 3)) == PC_NODE_SEQUENCE);
+	TST_EXPECT(PC_type(PC_key(conf, "i", 1)) == PC_NODE_SCALAR);
+	TST_EXPECT(PC_type(PC_key_opt(conf, "none", 4)) == PC_NODE_NONE);
+
+	long int_value;
+	TST_EXPECT(!PC_int_or(conf, ".i", 7, &int_value) && int_value == 3);
+	TST_EXPECT(!PC_int_or(conf, ".no_i", 7, &int_value) && int_value == 7);
+	TST_EXPECT(!PC_int_or(conf, ".seq[1]", 7, &int_value) && int_value == 2);
+	TST_EXPECT(!PC_int_or(conf, ".seq[5]", 7, &int_value) && int_value == 7);
+	double double_value;
+	TST_EXPECT(!PC_double_or(conf, ".d", 2.5, &double_value) && double_value == 1.5);
+	TST_EXPECT(!PC_double_or(conf, ".no_d", 2.5, &double_value) && double_value == 2.5);
+	int bool_value;
+	TST_EXPECT(!PC_bool_or(conf, ".b", 0, &bool_value) && bool_value == 1);
+	TST_EXPECT(!PC_bool_or(conf, ".no_b", 0, &bool_value) && bool_value == 0);
+	char* string_value;
+	TST_EXPECT(!PC_string_or(conf, ".s", "default", &string_value) && !strcmp(string_value, "text"));
+	free(string_value);
+	TST_EXPECT(!PC_string_or(conf, ".no_s", "default", &string_value) && !strcmp(string_value, "default"));
+	free(string_value);
+	TST_EXPECT(!PC_string_or(conf, ".no_s", NULL, &string_value) && string_value == NULL);
+
+	// existing but invalid values and invalid indices are still errors
+	PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_int_or(conf, ".bad", 7, &int_value) == PC_INVALID_NODE_TYPE);
+	TST_EXPECT(PC_int_or(conf, ".seq", 7, &int_value) == PC_INVALID_NODE_TYPE);
+	TST_EXPECT(PC_int_or(conf, "i", 7, &int_value) == PC_INVALID_PARAMETER);
+	TST_EXPECT(!PC_has(conf, "[x]"));
+	TST_EXPECT(strstr(PC_errmsg(), "[x]") != NULL);
+
+	// trees in error are passed through
+	PC_tree_t missing = PC_get(conf, ".missing");
+	TST_EXPECT(!PC_has(missing, ""));
+	TST_EXPECT(PC_type(missing) == PC_NODE_NONE);
+	TST_EXPECT(PC_int_or(missing, ".a", 7, &int_value) == PC_NODE_NOT_FOUND);
+	PC_errhandler(handler);
+
+	PC_tree_destroy(&conf);
+	return 0;
+}
@@ -0,0 +1,72 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks the instrumentation counters, whether they are enabled or not
+ */
+int main()
+{
+	const char* yaml = "{a: 1, b: [2, 3], c: {d: x}}";
+	PC_tree_t conf = PC_parse_string(yaml);
+
+	PC_stats_t stats;
+	TST_EXPECT(!PC_stats(conf, &stats));
+	TST_EXPECT(stats.nb_nodes == 11);
+	TST_EXPECT(stats.nb_scalars == 8);
+	TST_EXPECT(stats.memory > strlen(yaml));
+	size_t memory = stats.memory;
+
+	long value;
+	TST_EXPECT(!PC_int(PC_get(conf, ".a"), &value) && value == 1);
+	TST_EXPECT(!PC_int(PC_get(conf, ".b[1]"), &value) && value == 3);
+	TST_EXPECT(!PC_int_or(conf, ".c.missing", 0, &value));
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_get(conf, ".missing");
+	PC_int(PC_get(conf, ".c.d"), &value);
+	PC_errhandler(handler);
+	TST_EXPECT(!PC_tree_resolve(conf));
+
+	TST_EXPECT(!PC_stats(conf, &stats));
+	TST_EXPECT(stats.memory > memory); // the resolved values
+	if (stats.enabled) {
+		TST_EXPECT(stats.bytes_read == strlen(yaml));
+		TST_EXPECT(stats.parse_time > 0);
+		TST_EXPECT(stats.nb_lookups == 8);
+		TST_EXPECT(stats.nb_key_compares >= 4);
+		TST_EXPECT(stats.nb_errors == 2);
+		TST_EXPECT(stats.nb_allocs == 2); // the document & the resolved values
+		TST_EXPECT(stats.alloc_bytes > 0);
+	} else {
+		TST_EXPECT(!stats.parse_time && !stats.bytes_read && !stats.nb_lookups && !stats.nb_errors && !stats.nb_allocs);
+	}
+
+	FILE* devnull = fopen("/dev/null", "w");
+	TST_EXPECT(!PC_stats_print(conf, devnull));
+	fclose(devnull);
+
+	// trees in error are passed through
+	handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_stats(PC_get(conf, ".missing"), &stats) == PC_NODE_NOT_FOUND);
+	PC_errhandler(handler);
+
+	PC_tree_destroy(&conf);
+	return 0;
+}
@@ -0,0 +1,215 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+#define NB_THREADS 4
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Writes a file
+ */
+void tst_write(const char* path, const char* content)
+{
+	FILE* file = fopen(path, "w");
+	TST_EXPECT(file != NULL);
+	TST_EXPECT(fputs(content, file) >= 0);
+	TST_EXPECT(!fclose(file));
+}
+
+/* Checks both trees have the exact same content
+ */
+void tst_same(PC_tree_t expected, PC_tree_t actual)
+{
+	TST_EXPECT(PC_status(expected) == PC_status(actual));
+	if (PC_status(expected)) return;
+	TST_EXPECT(PC_type(expected) == PC_type(actual));
+	switch (PC_type(expected)) {
+	case PC_NODE_SCALAR: {
+		const char *expected_value, *actual_value;
+		int expected_len, actual_len;
+		TST_EXPECT(!PC_string_view(expected, &expected_value, &expected_len));
+		TST_EXPECT(!PC_string_view(actual, &actual_value, &actual_len));
+		TST_EXPECT(expected_len == actual_len && !memcmp(expected_value, actual_value, expected_len));
+	} break;
+	case PC_NODE_SEQUENCE: {
+		PC_seq_iter_t expected_iter, actual_iter;
+		TST_EXPECT(!PC_seq_begin(expected, &expected_iter) && !PC_seq_begin(actual, &actual_iter));
+		while (PC_seq_next(&expected_iter)) {
+			TST_EXPECT(PC_seq_next(&actual_iter));
+			tst_same(PC_seq_value(&expected_iter), PC_seq_value(&actual_iter));
+		}
+		TST_EXPECT(!PC_seq_next(&actual_iter));
+	} break;
+	case PC_NODE_MAPPING: {
+		PC_map_iter_t expected_iter, actual_iter;
+		TST_EXPECT(!PC_map_begin(expected, &expected_iter) && !PC_map_begin(actual, &actual_iter));
+		while (PC_map_next(&expected_iter)) {
+			TST_EXPECT(PC_map_next(&actual_iter));
+			tst_same(PC_map_key(&expected_iter), PC_map_key(&actual_iter));
+			tst_same(PC_map_value(&expected_iter), PC_map_value(&actual_iter));
+		}
+		TST_EXPECT(!PC_map_next(&actual_iter));
+	} break;
+	default:
+		break;
+	}
+}
+
+/* Parses a file both ways, checks the results are the same and returns
+ * whether the file was parsed lazily
+ */
+int tst_lazy(const char* path, const char* content)
+{
+	tst_write(path, content);
+	PC_tree_t eager = PC_parse_path(path);
+	PC_tree_t lazy = PC_parse_path_lazy(path);
+	TST_EXPECT(!PC_status(eager) && !PC_status(lazy));
+	tst_same(eager, lazy);
+
+	// only the root of a lazily parsed document can not be serialized
+	void* buffer;
+	size_t size;
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	int is_lazy = PC_serialize(lazy, &buffer, &size) == PC_INVALID_PARAMETER;
+	PC_errhandler(handler);
+	if (!is_lazy) free(buffer);
+
+	PC_tree_destroy(&lazy);
+	PC_tree_destroy(&eager);
+	return is_lazy;
+}
+
+static PC_tree_t shared;
+
+static void* tst_thread(void* arg)
+{
+	long value = 0;
+	int ok = !PC_int(PC_get(shared, ".b.c[1]"), &value) && value == 3;
+	return ok ? arg : NULL;
+}
+
+/* Checks lazily parsed documents give the same results as eager ones
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test15_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64];
+	sprintf(path, "%s/conf.yml", dir);
+
+	// block mappings with plain keys are parsed lazily, whatever their values
+	TST_EXPECT(tst_lazy(
+		path,
+		"# header comment\n"
+		"---\n"
+		"a: 1\n"
+		"b:\n"
+		"  c: [2, 3, {d: \"x, ]\"}]\n"
+		"  e: 'it''s'\n"
+		"\n"
+		"seq:\n"
+		"- 4\n"
+		"- {f: 5}\n"
+		"text: |\n"
+		"  multi\n"
+		"   line\n"
+		"folded: >-\n"
+		"  a\n"
+		"  b\n"
+		"plain: multi\n"
+		"  line\n"
+		"a b : spaced # comment\n"
+		"url: http://x.org/a#b\n"
+		"empty:\n"
+		"a: duplicate\n"
+		"last: end\r\n"
+	));
+
+	// sources that can not be split are parsed eagerly
+	TST_EXPECT(!tst_lazy(path, "{a: 1, b: 2}\n"));
+	TST_EXPECT(!tst_lazy(path, "- 1\n- 2\n"));
+	TST_EXPECT(!tst_lazy(path, "  a: 1\n  b: 2\n"));
+	TST_EXPECT(!tst_lazy(path, "a: &x 1\nb: *x\n"));
+	TST_EXPECT(!tst_lazy(path, "a: [1,\n  2]\nb: 3\n"));
+	TST_EXPECT(!tst_lazy(path, "a: \"multi\n  line\"\nb: 3\n"));
+	TST_EXPECT(!tst_lazy(path, "%YAML 1.1\n---\na: 1\n"));
+	TST_EXPECT(!tst_lazy(path, "\"a\": 1\n"));
+	TST_EXPECT(!tst_lazy(path, "? a\n: 1\n"));
+	TST_EXPECT(!tst_lazy(path, "scalar\n"));
+
+	// lookups enter values on demand and keep them
+	tst_write(path, "a: 1\nb:\n  c: [2, 3]\nbroken: x: y\nd: 5\n");
+	PC_tree_t conf = PC_parse_path_lazy(path);
+	TST_EXPECT(!PC_status(conf));
+	long value = 0;
+	TST_EXPECT(!PC_int(PC_get(conf, ".b.c[1]"), &value) && value == 3);
+	TST_EXPECT(!PC_int(PC_get(conf, "<3>"), &value) && value == 5);
+	TST_EXPECT(PC_has(conf, ".a") && !PC_has(conf, ".z"));
+	TST_EXPECT(!PC_int_or(conf, ".z", 6, &value) && value == 6);
+	TST_EXPECT(!strcmp(PC_path(PC_get(conf, ".b")), path));
+
+	// a syntax error is only reported when its value is accessed
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_status(PC_get(conf, ".broken")) == PC_INVALID_FORMAT);
+	TST_EXPECT(strstr(PC_errmsg(), path) != NULL);
+	TST_EXPECT(PC_status(PC_get(conf, ".broken[0]")) == PC_INVALID_FORMAT);
+	PC_errhandler(handler);
+
+	// the root can be resolved and frozen
+	TST_EXPECT(!PC_tree_resolve(conf));
+	TST_EXPECT(!PC_tree_freeze(&conf));
+	TST_EXPECT(!PC_int(PC_get(conf, ".b.c[0]"), &value) && value == 2);
+	TST_EXPECT(!PC_int(PC_get(conf, ".a"), &value) && value == 1);
+
+	// destroying a value releases the whole document
+	PC_tree_t sub = PC_get(conf, ".b");
+	PC_tree_destroy(&sub);
+
+	// values not accessed yet come from the file as it was parsed, even if it is then truncated or rewritten
+	tst_write(path, "a: 1\nb:\n  c: [2, 3]\nd: 4\n");
+	conf = PC_parse_path_lazy(path);
+	TST_EXPECT(!PC_status(conf));
+	TST_EXPECT(!truncate(path, 0));
+	TST_EXPECT(!PC_int(PC_get(conf, ".b.c[1]"), &value) && value == 3);
+	tst_write(path, "a: 7\nb: 8\nd: 9999\n");
+	TST_EXPECT(!PC_int(PC_get(conf, ".d"), &value) && value == 4);
+	PC_tree_destroy(&conf);
+
+	// values are materialized once when accessed concurrently
+	tst_write(path, "a: 1\nb:\n  c: [2, 3]\n");
+	shared = PC_parse_path_lazy(path);
+	pthread_t threads[NB_THREADS];
+	int ids[NB_THREADS];
+	for (int thread = 0; thread < NB_THREADS; ++thread) {
+		TST_EXPECT(!pthread_create(&threads[thread], NULL, tst_thread, &ids[thread]));
+	}
+	for (int thread = 0; thread < NB_THREADS; ++thread) {
+		void* result;
+		TST_EXPECT(!pthread_join(threads[thread], &result) && result == &ids[thread]);
+	}
+	PC_tree_destroy(&shared);
+
+	unlink(path);
+	rmdir(dir);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+#define NB_FILES 64
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Counts the errors reported
+ */
+void tst_count(PC_status_t status, const char* message, void* context)
+{
+	(void)status;
+	(void)message;
+	++*(int*)context;
+}
+
+/* Parses all the files with a given number of workers and checks the results,
+ * every 10th file is invalid and the last one does not exist
+ */
+void tst_parse(const char* const* paths, int nb_workers)
+{
+	PC_tree_t trees[NB_FILES];
+	int nb_reports = 0;
+	PC_errhandler_t count_handler = {tst_count, &nb_reports};
+	PC_errhandler_t handler = PC_errhandler(count_handler);
+	TST_EXPECT(PC_parse_paths(paths, NB_FILES, nb_workers, trees) == PC_INVALID_FORMAT);
+	PC_errhandler(handler);
+
+	// a single report details all the files in error
+	TST_EXPECT(nb_reports == 1);
+	TST_EXPECT(strstr(PC_errmsg(), "Unable to parse 8 files out of 64") != NULL);
+	TST_EXPECT(strstr(PC_errmsg(), paths[10]) != NULL);
+	TST_EXPECT(strstr(PC_errmsg(), paths[NB_FILES - 1]) != NULL);
+	TST_EXPECT(strstr(PC_errmsg(), paths[11]) == NULL);
+
+	for (int file = 0; file < NB_FILES; ++file) {
+		if (file == NB_FILES - 1) {
+			TST_EXPECT(PC_status(trees[file]) == PC_SYSTEM_ERROR);
+		} else if (file % 10 == 0) {
+			TST_EXPECT(PC_status(trees[file]) == PC_INVALID_FORMAT);
+		} else {
+			long value = -1;
+			TST_EXPECT(!PC_int(PC_get(trees[file], ".member"), &value) && value == file);
+			TST_EXPECT(!strcmp(PC_path(trees[file]), paths[file]));
+		}
+		// trees in error can be destroyed as well
+		PC_tree_destroy(&trees[file]);
+	}
+}
+
+/* Checks the concurrent parsing of many files
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test16_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path_buffers[NB_FILES][64];
+	const char* paths[NB_FILES];
+	for (int file = 0; file < NB_FILES; ++file) {
+		sprintf(path_buffers[file], "%s/member%d.yml", dir, file);
+		paths[file] = path_buffers[file];
+		if (file == NB_FILES - 1) continue;
+		FILE* output = fopen(paths[file], "w");
+		TST_EXPECT(output != NULL);
+		if (file % 10 == 0) {
+			fprintf(output, "member: [%d\n", file);
+		} else {
+			fprintf(output, "member: %d\nparams: {dt: 0.1, steps: [1, 2, 3]}\n", file);
+		}
+		TST_EXPECT(!fclose(output));
+	}
+
+	tst_parse(paths, 1);
+	tst_parse(paths, 4);
+	tst_parse(paths, 0); // one worker per core
+	tst_parse(paths, 1000); // capped to the number of files
+
+	// all files valid
+	PC_tree_t trees[2];
+	TST_EXPECT(!PC_parse_paths(paths + 1, 2, 2, trees));
+	PC_tree_destroy(&trees[0]);
+	PC_tree_destroy(&trees[1]);
+	TST_EXPECT(!PC_parse_paths(paths, 0, 4, trees));
+
+	for (int file = 0; file < NB_FILES - 1; ++file) {
+		unlink(paths[file]);
+	}
+	rmdir(dir);
+	return 0;
+}
@@ -0,0 +1,156 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Returns the integer at a given index
+ */
+long tst_int(PC_tree_t tree, const char* index)
+{
+	long value = -1;
+	TST_EXPECT(!PC_int(PC_get(tree, index), &value));
+	return value;
+}
+
+/* Checks the keys of a mapping, in order
+ */
+void tst_keys(PC_tree_t tree, const char* expected)
+{
+	char keys[256] = "";
+	PC_map_iter_t iter;
+	TST_EXPECT(!PC_map_begin(tree, &iter));
+	while (PC_map_next(&iter)) {
+		const char* key;
+		int len;
+		TST_EXPECT(!PC_string_view(PC_map_key(&iter), &key, &len));
+		strncat(keys, key, len);
+		strcat(keys, " ");
+	}
+	TST_EXPECT(!strcmp(keys, expected));
+}
+
+/* Checks layered overlays of documents
+ */
+int main()
+{
+	PC_tree_t layers[4] = {
+		PC_parse_string("{name: site, nproc: 1, mesh: {nx: 10, ny: 10, bc: {left: wall, right: wall}}, io: {dir: /scratch}, list: [1, 2]}"),
+		PC_parse_string("{nproc: 128, mesh: {bc: {right: periodic}}, io: none}"),
+		PC_parse_string("{name: case, mesh: {nx: 100}, io: {format: hdf5}, extra: {a: 1}}"),
+		PC_parse_string("{mesh: {ny: 20}, list: [3]}"),
+	};
+	PC_tree_t conf = PC_overlay(layers, 4);
+	TST_EXPECT(!PC_status(conf));
+
+	// the last layer having a key wins, mappings are merged recursively
+	const char* name;
+	int len;
+	TST_EXPECT(!PC_string_view(PC_get(conf, ".name"), &name, &len) && len == 4 && !strncmp(name, "case", 4));
+	TST_EXPECT(tst_int(conf, ".nproc") == 128);
+	TST_EXPECT(tst_int(conf, ".mesh.nx") == 100);
+	TST_EXPECT(tst_int(conf, ".mesh.ny") == 20);
+	TST_EXPECT(!PC_string_view(PC_get(conf, ".mesh.bc.left"), &name, &len) && !strncmp(name, "wall", len));
+	TST_EXPECT(!PC_string_view(PC_get(conf, ".mesh.bc.right"), &name, &len) && !strncmp(name, "periodic", len));
+	TST_EXPECT(tst_int(conf, ".extra.a") == 1);
+
+	// a scalar shadows the mappings below it, a mapping the scalars below it
+	PC_tree_t io = PC_get(conf, ".io");
+	TST_EXPECT(PC_type(io) == PC_NODE_MAPPING);
+	tst_keys(io, "format ");
+	TST_EXPECT(!PC_has(conf, ".io.dir"));
+
+	// sequences are not merged
+	int list_len;
+	TST_EXPECT(!PC_len(PC_get(conf, ".list"), &list_len) && list_len == 1);
+	TST_EXPECT(tst_int(conf, ".list[0]") == 3);
+
+	// keys come in order of first appearance
+	tst_keys(conf, "name nproc mesh io list extra ");
+	tst_keys(PC_get(conf, ".mesh"), "nx ny bc ");
+	int conf_len;
+	TST_EXPECT(!PC_len(conf, &conf_len) && conf_len == 6);
+	TST_EXPECT(tst_int(conf, "<1>") == 128);
+
+	// values are those of the layers, not copies
+	const char* layer_value;
+	TST_EXPECT(!PC_string_view(PC_get(layers[0], ".mesh.bc.left"), &layer_value, &len));
+	TST_EXPECT(!PC_string_view(PC_get(conf, ".mesh.bc.left"), &name, &len) && name == layer_value);
+
+	// missing keys & defaults
+	long value;
+	TST_EXPECT(!PC_int_or(conf, ".mesh.nz", 5, &value) && value == 5);
+	TST_EXPECT(!PC_int_or(conf, ".mesh.nx", 5, &value) && value == 100);
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_status(PC_get(conf, ".missing")) == PC_NODE_NOT_FOUND);
+
+	// only mappings can be layered
+	PC_tree_t invalid[2] = {layers[0], PC_get(layers[0], ".list")};
+	TST_EXPECT(PC_status(PC_overlay(invalid, 2)) == PC_INVALID_NODE_TYPE);
+	TST_EXPECT(PC_status(PC_overlay(layers, 0)) == PC_INVALID_PARAMETER);
+	void* buffer;
+	size_t size;
+	TST_EXPECT(PC_serialize(conf, &buffer, &size) == PC_INVALID_PARAMETER);
+	PC_errhandler(handler);
+
+	// overlays can be layered too and can be used frozen
+	PC_tree_t nested_layers[2] = {conf, PC_parse_string("{mesh: {bc: {left: open}}}")};
+	PC_tree_t nested = PC_overlay(nested_layers, 2);
+	TST_EXPECT(!PC_tree_freeze(&nested));
+	TST_EXPECT(!PC_string_view(PC_get(nested, ".mesh.bc.left"), &name, &len) && !strncmp(name, "open", len));
+	TST_EXPECT(!PC_string_view(PC_get(nested, ".mesh.bc.right"), &name, &len) && !strncmp(name, "periodic", len));
+	TST_EXPECT(tst_int(nested, ".mesh.nx") == 100);
+	PC_tree_destroy(&nested);
+	PC_tree_destroy(&nested_layers[1]);
+
+	// the values of lazily parsed layers are only parsed when needed to merge, errors surface on access
+	char dir[] = "/tmp/paraconf_test17_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64];
+	sprintf(path, "%s/lazy.yml", dir);
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	fputs("name: lazy\nbroken: a: b\nmesh:\n  nx: 5\n", output);
+	TST_EXPECT(!fclose(output));
+	PC_tree_t lazy_layers[2] = {layers[0], PC_parse_path_lazy(path)};
+	TST_EXPECT(!PC_status(lazy_layers[1]));
+	PC_tree_t lazy = PC_overlay(lazy_layers, 2);
+	TST_EXPECT(!PC_status(lazy));
+	TST_EXPECT(tst_int(lazy, ".mesh.nx") == 5);
+	TST_EXPECT(tst_int(lazy, ".mesh.ny") == 10);
+	TST_EXPECT(!PC_string_view(PC_get(lazy, ".name"), &name, &len) && !strncmp(name, "lazy", len));
+	handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_status(PC_get(lazy, ".broken")) == PC_INVALID_FORMAT);
+	PC_errhandler(handler);
+	PC_tree_destroy(&lazy);
+	PC_tree_destroy(&lazy_layers[1]);
+	unlink(path);
+	rmdir(dir);
+
+	// destroying the overlay leaves the layers untouched
+	PC_tree_destroy(&conf);
+	TST_EXPECT(tst_int(layers[0], ".mesh.nx") == 10);
+	for (int layer = 0; layer < 4; ++layer) {
+		PC_tree_destroy(&layers[layer]);
+	}
+	return 0;
+}
@@ -0,0 +1,190 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+#define NB_READERS 4
+
+#define NB_RELOADS 200
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* What the callback saw
+ */
+typedef struct tst_changes_s {
+	int recording;
+	int nb_calls;
+	int nb_errors;
+	char keys[256];
+} tst_changes_t;
+
+/* Records the changes reported
+ */
+void tst_on_change(PC_tree_t tree, const char* const* keys, int nb_keys, void* context)
+{
+	tst_changes_t* changes = context;
+	if (!__atomic_load_n(&changes->recording, __ATOMIC_SEQ_CST)) return;
+	if (PC_status(tree)) {
+		TST_EXPECT(nb_keys == 0);
+		__atomic_add_fetch(&changes->nb_errors, 1, __ATOMIC_SEQ_CST);
+	} else {
+		changes->keys[0] = '\0';
+		for (int key = 0; key < nb_keys; ++key) {
+			strcat(changes->keys, keys[key]);
+			strcat(changes->keys, " ");
+		}
+	}
+	__atomic_add_fetch(&changes->nb_calls, 1, __ATOMIC_SEQ_CST);
+}
+
+/* Waits for the callback to be called a given number of times
+ */
+void tst_wait(tst_changes_t* changes, int nb_calls)
+{
+	for (int retry = 0; retry < 1000 && __atomic_load_n(&changes->nb_calls, __ATOMIC_SEQ_CST) < nb_calls; ++retry) {
+		struct timespec delay = {0, 10000000};
+		nanosleep(&delay, NULL);
+	}
+	TST_EXPECT(__atomic_load_n(&changes->nb_calls, __ATOMIC_SEQ_CST) == nb_calls);
+}
+
+/* Replaces the content of a file the way editors do, by renaming a new one
+ */
+void tst_write(const char* path, const char* content)
+{
+	char tmp_path[128];
+	sprintf(tmp_path, "%s.tmp", path);
+	FILE* output = fopen(tmp_path, "w");
+	TST_EXPECT(output != NULL);
+	fputs(content, output);
+	TST_EXPECT(!fclose(output));
+	TST_EXPECT(!rename(tmp_path, path));
+}
+
+/* Returns the integer at a given index
+ */
+long tst_int(PC_tree_t tree, const char* index)
+{
+	long value = -1;
+	TST_EXPECT(!PC_int(PC_get(tree, index), &value));
+	return value;
+}
+
+/* Reads the values of the snapshots published while they are replaced, they
+ * must always be consistent
+ */
+void* tst_reader(void* context)
+{
+	PC_watch_t* watch = context;
+	for (int read = 0; read < 20 * NB_RELOADS; ++read) {
+		PC_tree_t tree = PC_watch_acquire(watch);
+		long version = tst_int(tree, ".version");
+		TST_EXPECT(tst_int(tree, ".params.twice") == 2 * version);
+		TST_EXPECT(!PC_watch_release(&tree));
+	}
+	return NULL;
+}
+
+/* Checks the reload of watched files
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test18_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64];
+	sprintf(path, "%s/conf.yml", dir);
+	tst_write(path, "a: 1\nb: {c: 2}\nd: 3\n");
+
+	tst_changes_t changes = {1, 0, 0, ""};
+	PC_watch_t* watch;
+	TST_EXPECT(!PC_watch_open(path, tst_on_change, &changes, &watch));
+	PC_tree_t first = PC_watch_acquire(watch);
+	TST_EXPECT(tst_int(first, ".b.c") == 2);
+
+	// changed & added keys first, then removed ones
+	tst_write(path, "a: 1\nb: {c: 5}\ne: 4\n");
+	tst_wait(&changes, 1);
+	TST_EXPECT(!strcmp(changes.keys, "b e d "));
+	PC_tree_t second = PC_watch_acquire(watch);
+	TST_EXPECT(tst_int(second, ".b.c") == 5);
+
+	// the replaced tree remains valid until released
+	TST_EXPECT(tst_int(first, ".b.c") == 2);
+	TST_EXPECT(tst_int(first, ".d") == 3);
+	PC_tree_t first_b = PC_get(first, ".b");
+	TST_EXPECT(!PC_watch_release(&first_b));
+	TST_EXPECT(!PC_watch_release(&second));
+
+	// invalid content is reported and not published
+	tst_write(path, "a: [1\n");
+	tst_wait(&changes, 2);
+	TST_EXPECT(changes.nb_errors == 1);
+	PC_tree_t third = PC_watch_acquire(watch);
+	TST_EXPECT(tst_int(third, ".b.c") == 5);
+	TST_EXPECT(!PC_watch_release(&third));
+
+	// files written in place are noticed too
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	fputs("a: 2\nb: {c: 5}\ne: 4\n", output);
+	TST_EXPECT(!fclose(output));
+	tst_wait(&changes, 3);
+	TST_EXPECT(!strcmp(changes.keys, "a "));
+
+	// forced reloads of an unchanged file report no key
+	TST_EXPECT(!PC_watch_reload(watch));
+	TST_EXPECT(changes.nb_calls == 4);
+	TST_EXPECT(!strcmp(changes.keys, ""));
+
+	// readers never see a partially replaced tree
+	char content[128];
+	pthread_t readers[NB_READERS];
+	__atomic_store_n(&changes.recording, 0, __ATOMIC_SEQ_CST);
+	tst_write(path, "version: 0\nparams: {twice: 0}\n");
+	TST_EXPECT(!PC_watch_reload(watch));
+	for (int reader = 0; reader < NB_READERS; ++reader) {
+		TST_EXPECT(!pthread_create(&readers[reader], NULL, tst_reader, watch));
+	}
+	for (int version = 1; version <= NB_RELOADS; ++version) {
+		sprintf(content, "version: %d\nparams: {twice: %d}\n", version, 2 * version);
+		tst_write(path, content);
+		TST_EXPECT(!PC_watch_reload(watch));
+	}
+	for (int reader = 0; reader < NB_READERS; ++reader) {
+		pthread_join(readers[reader], NULL);
+	}
+
+	// trees still acquired outlive the watch
+	PC_tree_t last = PC_watch_acquire(watch);
+	TST_EXPECT(!PC_watch_close(watch));
+	TST_EXPECT(tst_int(last, ".version") == NB_RELOADS);
+	TST_EXPECT(!PC_watch_release(&last));
+
+	// missing files can not be watched
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	unlink(path);
+	TST_EXPECT(PC_watch_open(path, NULL, NULL, &watch) == PC_SYSTEM_ERROR);
+	PC_errhandler(handler);
+	rmdir(dir);
+	return 0;
+}
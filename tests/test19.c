@@ -0,0 +1,136 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+#define NB_THREADS 8
+
+#define NB_KEYS 200
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Reads the whole document through a reference of its own, the caches built
+ * on demand are built concurrently by all threads
+ */
+void* tst_reader(void* context)
+{
+	PC_tree_t tree = *(PC_tree_t*)context;
+	TST_EXPECT(!PC_tree_resolve(tree));
+	for (int round = 0; round < 10; ++round) {
+		for (int key = 0; key < NB_KEYS; ++key) {
+			char index[32];
+			long value = -1;
+			sprintf(index, ".k%d.v", key);
+			TST_EXPECT(!PC_int(PC_get(tree, index), &value) && value == key);
+		}
+	}
+	PC_tree_t first = PC_get(tree, ".k0");
+	TST_EXPECT(!PC_tree_release(&first));
+	TST_EXPECT(first.node == NULL);
+	return NULL;
+}
+
+/* Shares a document between threads, each releasing it when done
+ */
+void tst_share(PC_tree_t tree)
+{
+	pthread_t threads[NB_THREADS];
+	for (int thread = 0; thread < NB_THREADS; ++thread) {
+		TST_EXPECT(!PC_tree_retain(tree));
+	}
+
+	for (int thread = 0; thread < NB_THREADS; ++thread) {
+		TST_EXPECT(!pthread_create(&threads[thread], NULL, tst_reader, &tree));
+	}
+	// the threads keep the document alive
+	PC_tree_t own = tree;
+	PC_tree_destroy(&own);
+	for (int thread = 0; thread < NB_THREADS; ++thread) {
+		pthread_join(threads[thread], NULL);
+	}
+}
+
+/* Checks the reference counting of documents and their concurrent reads
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test19_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64];
+	sprintf(path, "%s/conf.yml", dir);
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	for (int key = 0; key < NB_KEYS; ++key) {
+		fprintf(output, "k%d:\n  v: %d\n  name: value%d\n", key, key, key);
+	}
+	TST_EXPECT(!fclose(output));
+
+	// a single reference: releasing frees
+	PC_tree_t tree = PC_parse_path(path);
+	TST_EXPECT(!PC_tree_release(&tree));
+
+	// more references: the last one frees, whichever tree it goes through
+	tree = PC_parse_path(path);
+	TST_EXPECT(!PC_tree_retain(PC_get(tree, ".k3")));
+	PC_tree_t other = PC_get(tree, ".k3.v");
+
+	// a shared document can not be moved
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_tree_freeze(&tree) == PC_INVALID_PARAMETER);
+	PC_errhandler(handler);
+	PC_tree_destroy(&tree);
+	long value = -1;
+	TST_EXPECT(!PC_int(other, &value) && value == 3);
+	TST_EXPECT(!PC_tree_release(&other));
+
+	// nor can the values of a shared lazily parsed document
+	tree = PC_parse_path_lazy(path);
+	other = PC_get(tree, ".k3");
+	TST_EXPECT(!PC_tree_retain(other));
+	PC_tree_t value_tree = PC_get(tree, ".k3");
+	handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_tree_freeze(&value_tree) == PC_INVALID_PARAMETER);
+	PC_errhandler(handler);
+	PC_tree_destroy(&tree);
+	TST_EXPECT(!PC_int(PC_get(other, ".v"), &value) && value == 3);
+	TST_EXPECT(!PC_tree_freeze(&other));
+	TST_EXPECT(!PC_int(PC_get(other, ".v"), &value) && value == 3);
+	TST_EXPECT(!PC_tree_release(&other));
+
+	// concurrent reads, including of lazily parsed values & frozen documents
+	tst_share(PC_parse_path(path));
+	tst_share(PC_parse_path_lazy(path));
+	tree = PC_parse_path(path);
+	TST_EXPECT(!PC_tree_freeze(&tree));
+	tst_share(tree);
+
+	// errors
+	handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_tree_t missing = PC_parse_path("/nonexistent/paraconf.yml");
+	TST_EXPECT(PC_tree_retain(missing) == PC_SYSTEM_ERROR);
+	TST_EXPECT(PC_tree_release(&missing) == PC_SYSTEM_ERROR);
+	PC_errhandler(handler);
+
+	unlink(path);
+	rmdir(dir);
+	return 0;
+}
@@ -7,10 +7,14 @@ program example
   use paraconf
 
   type(pc_tree_t) :: tree1
+  type(pc_path_t) :: path1
   integer :: a_int
   character(20) :: a_string
   real(8) :: a_float
   logical :: a_log
+  integer :: int_array(2)
+  real(8) :: double_array(2)
+  logical :: log_array(2)
   integer :: ierr
   character(len=pc_errmsg_maxlength) :: errmsg
   character(len=4096) :: infile
@@ -84,6 +88,42 @@ program example
     error stop
   endif
 
+  call PC_path_compile(".another_list[$0]", path1)
+  call PC_int(PC_cget(tree1, path1, [1]), a_int)
+  if ( a_int /= 31 ) then
+    print *, "error with another_list[$0], ", a_int
+    error stop
+  endif
+  call PC_path_destroy(path1)
+
+  call PC_path_compile(".$0.second", path1)
+  call PC_int(PC_cget(tree1, path1, keys=["another_map"]), a_int)
+  if ( a_int /= 41 ) then
+    print *, "error with $0.second, ", a_int
+    error stop
+  endif
+  call PC_path_destroy(path1)
+
+  call PC_path_compile(".$0[$1]", path1)
+  call PC_int(PC_cget(tree1, path1, ["another_list"], [1]), a_int)
+  if ( a_int /= 31 ) then
+    print *, "error with $0[$1], ", a_int
+    error stop
+  endif
+  call PC_path_destroy(path1)
+
+  call PC_int_array(PC_get(tree1, ".another_list"), int_array, ierr)
+  if (ierr /= PC_OK .or. int_array(1) /= 30 .or. int_array(2) /= 31) then
+    print *, "error with int_array==[30, 31], got ", int_array
+    error stop
+  endif
+
+  call PC_double_array(PC_get(tree1, ".a_list"), double_array, ierr)
+  if (ierr /= PC_OK .or. double_array(1) /= 10 .or. double_array(2) /= 11) then
+    print *, "error with double_array==[10, 11], got ", double_array
+    error stop
+  endif
+
   call PC_log(PC_get(tree1, ".a_true"), a_log)
   if ( .not. a_log ) then
     print *, "error with a_true, ", a_log
@@ -204,6 +244,31 @@ program example
   endif
 
 
+  call PC_log_array(PC_get(tree1, ".a_list"), log_array, ierr)
+  if (ierr /= PC_INVALID_PARAMETER) then
+    print *, "error with ierr==PC_INVALID_PARAMETER, got ", ierr
+    error stop
+  endif
+
+  ! the values must match the argument slots in number & type
+  call PC_path_compile(".another_list[$0]", path1)
+  ierr = PC_status(PC_cget(tree1, path1))
+  if (ierr /= PC_INVALID_PARAMETER) then
+    print *, "error with missing index, got ", ierr
+    error stop
+  endif
+  ierr = PC_status(PC_cget(tree1, path1, [(1, a_int = 1, 17)]))
+  if (ierr /= PC_INVALID_PARAMETER) then
+    print *, "error with 17 indices, got ", ierr
+    error stop
+  endif
+  ierr = PC_status(PC_cget(tree1, path1, ["another_list"]))
+  if (ierr /= PC_INVALID_PARAMETER) then
+    print *, "error with a key for an index slot, got ", ierr
+    error stop
+  endif
+  call PC_path_destroy(path1)
+
 
   
   call PC_tree_destroy(tree1)
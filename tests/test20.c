@@ -0,0 +1,177 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks that two trees have the same structure, tags and values
+ */
+void tst_same(PC_tree_t tree1, PC_tree_t tree2)
+{
+	TST_EXPECT(PC_type(tree1) == PC_type(tree2));
+	TST_EXPECT(!strcmp((const char*)tree1.node->tag, (const char*)tree2.node->tag));
+	switch (PC_type(tree1)) {
+	case PC_NODE_SCALAR: {
+		const char *value1, *value2;
+		int len1, len2;
+		TST_EXPECT(!PC_string_view(tree1, &value1, &len1) && !PC_string_view(tree2, &value2, &len2));
+		TST_EXPECT(len1 == len2 && !memcmp(value1, value2, len1));
+	} break;
+	case PC_NODE_SEQUENCE: {
+		PC_seq_iter_t iter1, iter2;
+		TST_EXPECT(!PC_seq_begin(tree1, &iter1) && !PC_seq_begin(tree2, &iter2));
+		while (PC_seq_next(&iter1)) {
+			TST_EXPECT(PC_seq_next(&iter2));
+			tst_same(PC_seq_value(&iter1), PC_seq_value(&iter2));
+		}
+		TST_EXPECT(!PC_seq_next(&iter2));
+	} break;
+	case PC_NODE_MAPPING: {
+		PC_map_iter_t iter1, iter2;
+		TST_EXPECT(!PC_map_begin(tree1, &iter1) && !PC_map_begin(tree2, &iter2));
+		while (PC_map_next(&iter1)) {
+			TST_EXPECT(PC_map_next(&iter2));
+			tst_same(PC_map_key(&iter1), PC_map_key(&iter2));
+			tst_same(PC_map_value(&iter1), PC_map_value(&iter2));
+		}
+		TST_EXPECT(!PC_map_next(&iter2));
+	} break;
+	default:
+		TST_EXPECT(0);
+	}
+}
+
+/* Writes a tree in a given style and checks it parses back to the same tree,
+ * returns the output
+ */
+char* tst_round_trip(PC_tree_t tree, PC_emit_style_t style)
+{
+	char* output;
+	TST_EXPECT(!PC_emit_string(tree, style, &output));
+	PC_tree_t parsed = PC_parse_string(output);
+	TST_EXPECT(!PC_status(parsed));
+	tst_same(tree, parsed);
+	PC_tree_destroy(&parsed);
+	return output;
+}
+
+/* Checks the emission of trees as YAML
+ */
+int main()
+{
+	const char* document = "name: \"quoted: value\"\n"
+	                       "plain: value with spaces\n"
+	                       "numbers: [1, -2.5e3, 0x1F, .inf]\n"
+	                       "specials: ['', ' padded ', '#comment', '- dash', '[flow]', 'a: b', \"multi\\nline\", \"tab\\there\", 'null', '~']\n"
+	                       "unicode: \"h\\u00e9llo \\u4e16\\u754c\"\n"
+	                       "empty:\n"
+	                       "empty_seq: []\n"
+	                       "empty_map: {}\n"
+	                       "literal: |\n"
+	                       "  line 1\n"
+	                       "    line 2\n"
+	                       "tagged: {int: !!int 3, custom: !point {x: 1, y: 2}, list: !!seq [a]}\n"
+	                       "? [complex, key]\n"
+	                       ": value\n"
+	                       "nested:\n"
+	                       "  - {a: 1, b: [x, {c: 2}]}\n"
+	                       "  - - deep\n"
+	                       "    - list\n"
+	                       "shared: &anchor {x: 1}\n"
+	                       "alias: *anchor\n";
+	PC_tree_t tree = PC_parse_string(document);
+	TST_EXPECT(!PC_status(tree));
+
+	free(tst_round_trip(tree, PC_EMIT_BLOCK));
+	char* flow = tst_round_trip(tree, PC_EMIT_FLOW);
+	TST_EXPECT(flow[0] == '{');
+	TST_EXPECT(strchr(flow, '\n') == flow + strlen(flow) - 1); // a single line
+	free(flow);
+
+	// subtrees & scalars
+	char* output = tst_round_trip(PC_get(tree, ".nested[0]"), PC_EMIT_BLOCK);
+	TST_EXPECT(!strcmp(output, "a: 1\nb:\n- x\n- c: 2\n"));
+	free(output);
+	output = tst_round_trip(PC_get(tree, ".nested[0]"), PC_EMIT_FLOW);
+	TST_EXPECT(!strcmp(output, "{a: 1, b: [x, {c: 2}]}\n"));
+	free(output);
+	free(tst_round_trip(PC_get(tree, ".name"), PC_EMIT_BLOCK));
+
+	// files, written in the same way
+	FILE* file = tmpfile();
+	TST_EXPECT(file != NULL);
+	TST_EXPECT(!PC_emit(tree, file, PC_EMIT_BLOCK));
+	long size = ftell(file);
+	rewind(file);
+	char* content = calloc(size + 1, 1);
+	TST_EXPECT(fread(content, 1, size, file) == (size_t)size);
+	fclose(file);
+	TST_EXPECT(!PC_emit_string(tree, PC_EMIT_BLOCK, &output));
+	TST_EXPECT(!strcmp(content, output));
+	free(content);
+	free(output);
+
+	// frozen documents
+	TST_EXPECT(!PC_tree_freeze(&tree));
+	free(tst_round_trip(tree, PC_EMIT_BLOCK));
+
+	// the resolved values of overlays
+	PC_tree_t layers[2] = {PC_parse_string("{a: 1, m: {x: 1, y: 2}}"), PC_parse_string("{b: 2, m: {y: 3}}")};
+	PC_tree_t overlay = PC_overlay(layers, 2);
+	TST_EXPECT(!PC_emit_string(overlay, PC_EMIT_FLOW, &output));
+	TST_EXPECT(!strcmp(output, "{a: 1, m: {x: 1, y: 3}, b: 2}\n"));
+	free(output);
+	PC_tree_destroy(&overlay);
+	PC_tree_destroy(&layers[0]);
+	PC_tree_destroy(&layers[1]);
+
+	// large trees span many buffers
+	size_t large_size = 1 << 20;
+	char* large = malloc(large_size);
+	size_t len = 0;
+	for (int key = 0; key < 20000; ++key) {
+		len += snprintf(large + len, large_size - len, "key%d: {value: %d, text: 'some text %d'}\n", key, key, key);
+	}
+	PC_tree_t large_tree = PC_parse_string(large);
+	free(tst_round_trip(large_tree, PC_EMIT_BLOCK));
+	free(tst_round_trip(large_tree, PC_EMIT_FLOW));
+	PC_tree_destroy(&large_tree);
+	free(large);
+
+	// an empty document writes nothing
+	PC_tree_t empty = PC_parse_string("");
+	TST_EXPECT(!PC_emit_string(empty, PC_EMIT_BLOCK, &output));
+	TST_EXPECT(!strcmp(output, ""));
+	free(output);
+	PC_tree_destroy(&empty);
+
+	// errors
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_tree_t recursive = PC_parse_string("a: &x [1, *x]");
+	TST_EXPECT(PC_emit_string(recursive, PC_EMIT_BLOCK, &output) == PC_INVALID_FORMAT);
+	PC_tree_destroy(&recursive);
+	TST_EXPECT(PC_emit_string(PC_get(tree, ".missing"), PC_EMIT_BLOCK, &output) == PC_NODE_NOT_FOUND);
+	PC_errhandler(handler);
+
+	PC_tree_destroy(&tree);
+	return 0;
+}
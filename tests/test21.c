@@ -0,0 +1,461 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+#include <yaml.h>
+
+#include "native.h"
+#include "ypath.h"
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+#define NB_DOCUMENTS 3000
+
+#define MAX_DEPTH 5
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* A document being generated
+ */
+typedef struct tst_doc_s {
+	char data[1 << 16];
+	size_t len;
+} tst_doc_t;
+
+static unsigned long long tst_state = 0x9E3779B97F4A7C15ULL;
+
+/* Returns a pseudo-random number in [0, n)
+ */
+unsigned tst_rand(unsigned n)
+{
+	tst_state ^= tst_state << 13;
+	tst_state ^= tst_state >> 7;
+	tst_state ^= tst_state << 17;
+	return (unsigned)((tst_state >> 33) % n);
+}
+
+void tst_append(tst_doc_t* doc, const char* fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	int len = vsnprintf(doc->data + doc->len, sizeof(doc->data) - doc->len, fmt, ap);
+	va_end(ap);
+	TST_EXPECT(len >= 0 && doc->len + len < sizeof(doc->data));
+	doc->len += len;
+}
+
+void tst_indent(tst_doc_t* doc, int col)
+{
+	tst_append(doc, "%*s", col, "");
+}
+
+/* Single-line scalars of the subset, of all styles
+ */
+static const char* tst_scalars[] = {
+	"value",
+	"42",
+	"-3.5e2",
+	"0x1F",
+	"true",
+	"null",
+	"~",
+	"a b  c",
+	"http://host:80/path",
+	"x#y",
+	"-dash",
+	"a,b[0]{c}",
+	"\xc3\xa9t\xc3\xa9",
+	"\xe6\x97\xa5\xe6\x9c\xac",
+	"a:b",
+	"'it''s'",
+	"'#not a comment'",
+	"''",
+	"'a: b'",
+	"' padded '",
+	"\"tab\\there\"",
+	"\"\\u00e9\\x41\\U0001F600\"",
+	"\"quote \\\" inside\"",
+	"\"\"",
+	"\"\\\\\"",
+	"\"\\N\\_\\L\\P\\0\\/\\ \"",
+	"\"a: b # c\"",
+	"\"\\e\\a\\b\\v\\f\\r\\n\"",
+};
+
+/* Keys of the subset
+ */
+static const char* tst_keys[] = {
+	"key",
+	"key with spaces",
+	"k-1",
+	"_private",
+	"\xd0\xba\xd0\xbb\xd1\x8e\xd1\x87",
+	"a.b",
+	"-k",
+	"123",
+	"'quoted key'",
+	"\"dq \\t key\"",
+	"'it''s'",
+	"url://x",
+};
+
+#define TST_NB(ARRAY) (sizeof(ARRAY) / sizeof(ARRAY[0]))
+
+void tst_gen_mapping(tst_doc_t* doc, int col, int depth, int inline_first);
+
+void tst_gen_sequence(tst_doc_t* doc, int col, int depth, int inline_first);
+
+/* Generates the remaining of a line following a ':' or '-' indicator and the
+ * lines of the node it introduces
+ */
+void tst_gen_entry(tst_doc_t* doc, int col, int depth, int in_mapping)
+{
+	unsigned kind = tst_rand(depth < MAX_DEPTH ? 6 : 2);
+	if (kind == 0) { // inline scalar
+		tst_append(doc, "%*s%s", 1 + tst_rand(2), "", tst_scalars[tst_rand(TST_NB(tst_scalars))]);
+		if (!tst_rand(4)) tst_append(doc, "%*s# comment: - [x]", 1 + tst_rand(3), "");
+		if (!tst_rand(8)) tst_append(doc, "  ");
+		tst_append(doc, "\n");
+	} else if (kind == 1) { // empty
+		tst_append(doc, tst_rand(2) ? "\n" : " # empty\n");
+	} else if (kind == 2 || kind == 3) { // block on the following lines
+		tst_append(doc, tst_rand(4) ? "\n" : " # nested\n");
+		if (!tst_rand(4)) tst_append(doc, "\n%*s# comment\n", tst_rand(8), "");
+		int child_col = col + 1 + tst_rand(3);
+		if (kind == 2) {
+			tst_gen_mapping(doc, child_col, depth + 1, 0);
+		} else {
+			tst_gen_sequence(doc, child_col, depth + 1, 0);
+		}
+	} else if (in_mapping) { // sequence as indented as the key
+		tst_append(doc, "\n");
+		tst_gen_sequence(doc, col, depth + 1, 0);
+	} else { // compact collection
+		int spaces = 1 + tst_rand(3);
+		tst_indent(doc, spaces);
+		if (kind == 4) {
+			tst_gen_mapping(doc, col + 1 + spaces, depth + 1, 1);
+		} else {
+			tst_gen_sequence(doc, col + 1 + spaces, depth + 1, 1);
+		}
+	}
+}
+
+void tst_gen_mapping(tst_doc_t* doc, int col, int depth, int inline_first)
+{
+	int nb_pairs = 1 + tst_rand(4);
+	for (int pair = 0; pair < nb_pairs; ++pair) {
+		if (pair || !inline_first) {
+			if (!tst_rand(8)) tst_append(doc, "%*s\n", tst_rand(4), "");
+			tst_indent(doc, col);
+		}
+		tst_append(doc, "%s%s:", tst_keys[tst_rand(TST_NB(tst_keys))], tst_rand(8) ? "" : "  ");
+		tst_gen_entry(doc, col, depth, 1);
+	}
+}
+
+void tst_gen_sequence(tst_doc_t* doc, int col, int depth, int inline_first)
+{
+	int nb_items = 1 + tst_rand(4);
+	for (int item = 0; item < nb_items; ++item) {
+		if (item || !inline_first) {
+			if (!tst_rand(8)) tst_append(doc, "%*s# comment\n", col, "");
+			tst_indent(doc, col);
+		}
+		tst_append(doc, "-");
+		tst_gen_entry(doc, col, depth, 0);
+	}
+}
+
+/* Generates a document of the subset
+ */
+void tst_gen_document(tst_doc_t* doc)
+{
+	doc->len = 0;
+	switch (tst_rand(4)) {
+	case 0:
+		tst_append(doc, "---\n");
+		break;
+	case 1:
+		tst_append(doc, "# header\n\n");
+		break;
+	}
+	int col = tst_rand(8) ? 0 : 2;
+	if (tst_rand(4)) {
+		tst_gen_mapping(doc, col, 0, 0);
+	} else {
+		tst_gen_sequence(doc, col, 0, 0);
+	}
+	if (!tst_rand(4)) tst_append(doc, "# trailer\n");
+	if (!tst_rand(4)) --doc->len; // no final line break
+	doc->data[doc->len] = '\0';
+}
+
+/* Checks that two documents are identical, except for their marks
+ */
+void tst_same_document(yaml_document_t* doc1, yaml_document_t* doc2)
+{
+	TST_EXPECT(doc1->start_implicit == doc2->start_implicit);
+	TST_EXPECT(doc1->end_implicit == doc2->end_implicit);
+	TST_EXPECT(!doc1->version_directive && !doc2->version_directive);
+	TST_EXPECT(doc1->tag_directives.start == doc1->tag_directives.end && doc2->tag_directives.start == doc2->tag_directives.end);
+	TST_EXPECT(doc1->nodes.top - doc1->nodes.start == doc2->nodes.top - doc2->nodes.start);
+	for (yaml_node_t *node1 = doc1->nodes.start, *node2 = doc2->nodes.start; node1 < doc1->nodes.top; ++node1, ++node2) {
+		TST_EXPECT(node1->type == node2->type);
+		TST_EXPECT(!strcmp((const char*)node1->tag, (const char*)node2->tag));
+		switch (node1->type) {
+		case YAML_SCALAR_NODE:
+			TST_EXPECT(node1->data.scalar.style == node2->data.scalar.style);
+			TST_EXPECT(node1->data.scalar.length == node2->data.scalar.length);
+			TST_EXPECT(!memcmp(node1->data.scalar.value, node2->data.scalar.value, node1->data.scalar.length));
+			break;
+		case YAML_SEQUENCE_NODE: {
+			TST_EXPECT(node1->data.sequence.style == node2->data.sequence.style);
+			size_t size = node1->data.sequence.items.top - node1->data.sequence.items.start;
+			TST_EXPECT(size == (size_t)(node2->data.sequence.items.top - node2->data.sequence.items.start));
+			TST_EXPECT(!memcmp(node1->data.sequence.items.start, node2->data.sequence.items.start, size * sizeof(yaml_node_item_t)));
+		} break;
+		case YAML_MAPPING_NODE: {
+			TST_EXPECT(node1->data.mapping.style == node2->data.mapping.style);
+			size_t size = node1->data.mapping.pairs.top - node1->data.mapping.pairs.start;
+			TST_EXPECT(size == (size_t)(node2->data.mapping.pairs.top - node2->data.mapping.pairs.start));
+			TST_EXPECT(!memcmp(node1->data.mapping.pairs.start, node2->data.mapping.pairs.start, size * sizeof(yaml_node_pair_t)));
+		} break;
+		default:
+			TST_EXPECT(0);
+		}
+	}
+}
+
+/* Loads a document with both libyaml and the native scanner, whatever the
+ * native scanner accepts must be loaded as libyaml does
+ *
+ * \return whether the native scanner accepted the document
+ */
+int tst_compare(const char* data, size_t size)
+{
+	yaml_parser_t parser;
+	yaml_document_t expected, native;
+	TST_EXPECT(yaml_parser_initialize(&parser));
+	yaml_parser_set_input_string(&parser, (const unsigned char*)data, size);
+	int loaded = yaml_parser_load(&parser, &expected);
+	yaml_parser_delete(&parser);
+
+	int accepted = pc_native_load((const unsigned char*)data, size, &native);
+	if (accepted) {
+		if (!loaded) fprintf(stderr, "Accepted a document libyaml rejects:\n%.*s\n", (int)size, data);
+		TST_EXPECT(loaded);
+		tst_same_document(&expected, &native);
+		yaml_document_delete(&native);
+	}
+	if (loaded) yaml_document_delete(&expected);
+	return accepted;
+}
+
+int tst_compare_string(const char* data)
+{
+	return tst_compare(data, strlen(data));
+}
+
+/* Fragments inserted in generated documents to go outside the subset
+ */
+static const char* tst_spices[] = {
+	"\t", ":", ": ", "- ", "-", " #", "#", "'", "\"", "''", "\\", "\\x4", "\\u", "[", "]", "{", "}", ",", "&a ", "*a", "!",
+	"!!str ", "|", ">", "?", "? ", "%", "@", "`", "\r\n", "\r", "\n", "\n---\n", "\n...\n", "---", " ", "  ", "\n  ", "\n ",
+	"\xc3\xa9", "\xc3", "\xff", "\xc2\x85", "\xe2\x80\xa8", "\xef\xbb\xbf", "\x01", "\x7f", "\xed\xa0\x80", "\xf4\x90\x80\x80",
+};
+
+/* Randomly alters a document
+ */
+void tst_spice(tst_doc_t* doc)
+{
+	int nb_changes = 1 + tst_rand(3);
+	for (int change = 0; change < nb_changes && doc->len; ++change) {
+		size_t pos = tst_rand(doc->len + 1);
+		if (tst_rand(3)) {
+			const char* spice = tst_spices[tst_rand(TST_NB(tst_spices))];
+			size_t len = strlen(spice);
+			if (doc->len + len >= sizeof(doc->data)) continue;
+			memmove(doc->data + pos + len, doc->data + pos, doc->len - pos);
+			memcpy(doc->data + pos, spice, len);
+			doc->len += len;
+		} else if (pos < doc->len) {
+			memmove(doc->data + pos, doc->data + pos + 1, doc->len - pos - 1);
+			--doc->len;
+		}
+	}
+}
+
+/* Checks the native scanner against libyaml
+ */
+int main()
+{
+	// supported documents
+	const char* supported[] = {
+		"a: 1\n",
+		"a: 1",
+		"---\na: 1\n",
+		"--- # start\na: 1\n",
+		"a:\n- 1\n-   2\n",
+		"- - a\n  - b\n- c\n",
+		"- a: 1\n  b: 2\n-\n- \n",
+		"a: 'it''s'\n",
+		"a: \"\\u00e9\\t\\\"\"\n",
+		"a: b#c\n",
+		"a: b # c\n",
+		"a: http://x:80\n",
+		"'k': v\n",
+		"\"k\" : v\n",
+		"a:\n\n  # comment\n  b: 1\n",
+		"a:\n  b:\n    c:\n  d: 1\ne:\n",
+		"  a: 1\n  b: 2\n",
+		"a: b - c\n",
+		"a: \"\" # c\n",
+		"a: ''\n",
+		"a:    \n",
+		"# c\n  # c\na: 1\n  # c\n",
+		"a: \xc3\xa9\xe6\x97\xa5\xf0\x9f\x98\x80\n",
+	};
+	for (size_t idx = 0; idx < TST_NB(supported); ++idx) {
+		if (!tst_compare_string(supported[idx])) fprintf(stderr, "Declined:\n%s\n", supported[idx]);
+		TST_EXPECT(tst_compare_string(supported[idx]));
+	}
+
+	// documents left to libyaml, valid or not
+	const char* unsupported[] = {
+		"",
+		"# only a comment\n",
+		"---\n",
+		"scalar\n",
+		"a: [1, 2]\n",
+		"a: {b: 1}\n",
+		"a: &x 1\nb: *x\n",
+		"a: !!str 1\n",
+		"a: |\n  x\n",
+		"a: >\n  x\n",
+		"a: 'multi\n  line'\n",
+		"a: plain\n  continued\n",
+		"a:\tb\n",
+		"a: b\t\n",
+		"\ta: 1\n",
+		"a: 1\r\n",
+		"? a\n: b\n",
+		"a: 1\n---\nb: 2\n",
+		"a: 1\n...\n",
+		"%YAML 1.1\n---\na: 1\n",
+		"\xef\xbb\xbf" "a: 1\n",
+		"a: b: c\n",
+		"a: - b\n",
+		"a: 1\n b: 2\n",
+		"a:\n  - 1\n  b: 2\n",
+		"a: \"\\q\"\n",
+		"a: \"\\'\"\n",
+		"a: \"\\ud800\"\n",
+		"a: \xff\n",
+		"a: \xc2\x85\n",
+		"a: \x01\n",
+		"a: 'unterminated\n",
+		"- a\nb: 1\n",
+		"a: 1\n- b\n",
+		"a:\nb\n",
+		"-a: 1\n- b\n",
+		"@a: 1\n",
+		"a: 1 #c\n  b: 2\n",
+	};
+	for (size_t idx = 0; idx < TST_NB(unsupported); ++idx) {
+		if (tst_compare_string(unsupported[idx])) fprintf(stderr, "Accepted:\n%s\n", unsupported[idx]);
+		TST_EXPECT(!tst_compare_string(unsupported[idx]));
+	}
+
+	// documents with no terminating null character, buffers of all sizes end anywhere
+	const char* sized = "key: value with some length to cross vector boundaries # and a comment\nother: 'quoted value that is long enough'\n";
+	for (size_t size = 1; size <= strlen(sized); ++size) {
+		char* copy = malloc(size);
+		memcpy(copy, sized, size);
+		tst_compare(copy, size);
+		free(copy);
+	}
+
+	// long keys are left to libyaml
+	tst_doc_t* doc = malloc(sizeof(tst_doc_t));
+	doc->len = 0;
+	for (int idx = 0; idx < 900; ++idx)
+		tst_append(doc, "k");
+	tst_append(doc, ": v\n");
+	TST_EXPECT(tst_compare(doc->data, doc->len));
+	doc->len = 0;
+	for (int idx = 0; idx < 1100; ++idx)
+		tst_append(doc, "k");
+	tst_append(doc, ": v\n");
+	TST_EXPECT(!tst_compare(doc->data, doc->len));
+
+	// deeply nested documents
+	doc->len = 0;
+	for (int level = 0; level < 200; ++level) {
+		tst_indent(doc, level);
+		tst_append(doc, level % 2 ? "-\n" : "k:\n");
+	}
+	TST_EXPECT(tst_compare(doc->data, doc->len));
+
+	// compact items nested deeper than the native scanner recurses are left to libyaml
+	size_t nb_levels = 150000;
+	char* deep = malloc(2 * nb_levels + 3);
+	for (size_t level = 0; level < nb_levels; ++level)
+		memcpy(deep + 2 * level, "- ", 2);
+	strcpy(deep + 2 * nb_levels, "a\n");
+	TST_EXPECT(tst_compare(deep + 2 * (nb_levels - 1000), 2 * 1000 + 2));
+	TST_EXPECT(!tst_compare(deep + 2 * (nb_levels - 1001), 2 * 1001 + 2));
+	TST_EXPECT(!tst_compare_string(deep));
+	PC_tree_t deep_tree = PC_parse_string(deep);
+	TST_EXPECT(!PC_status(deep_tree));
+	PC_tree_destroy(&deep_tree);
+	free(deep);
+
+	// generated documents, as is then altered
+	for (int idx = 0; idx < NB_DOCUMENTS; ++idx) {
+		tst_gen_document(doc);
+		if (!tst_compare(doc->data, doc->len)) fprintf(stderr, "Declined:\n%s\n", doc->data);
+		TST_EXPECT(tst_compare(doc->data, doc->len));
+		tst_spice(doc);
+		tst_compare(doc->data, doc->len);
+	}
+	free(doc);
+
+	// the library loads the same trees with both backends and reports the same errors
+	const char* document = "a: 1\nb:\n  - x\n  - 'y'\n";
+	PC_tree_t native = PC_parse_string(document);
+	TST_EXPECT(setenv("PARACONF_PARSER", "libyaml", 1) == 0);
+	PC_tree_t libyaml = PC_parse_string(document);
+	TST_EXPECT(!PC_status(native) && !PC_status(libyaml));
+	tst_same_document(&native.pcdoc->document, &libyaml.pcdoc->document);
+	PC_tree_destroy(&native);
+	PC_tree_destroy(&libyaml);
+
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	const char* invalid = "a: 1\n b: 2\n";
+	TST_EXPECT(PC_status(PC_parse_string(invalid)) == PC_INVALID_FORMAT);
+	char* message = strdup(PC_errmsg());
+	TST_EXPECT(unsetenv("PARACONF_PARSER") == 0);
+	TST_EXPECT(PC_status(PC_parse_string(invalid)) == PC_INVALID_FORMAT);
+	TST_EXPECT(!strcmp(message, PC_errmsg()));
+	free(message);
+	PC_errhandler(handler);
+
+	return 0;
+}
@@ -0,0 +1,230 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+#include <yaml.h>
+
+#include "ypath.h"
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+/// number of top-level keys, enough for the documents to be split in many chunks
+#define NB_KEYS 10000
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+int tst_same_mark(yaml_mark_t mark1, yaml_mark_t mark2)
+{
+	return mark1.index == mark2.index && mark1.line == mark2.line && mark1.column == mark2.column;
+}
+
+/* Checks that two documents are identical, marks included
+ */
+void tst_same_document(yaml_document_t* doc1, yaml_document_t* doc2)
+{
+	TST_EXPECT(doc1->start_implicit == doc2->start_implicit);
+	TST_EXPECT(doc1->end_implicit == doc2->end_implicit);
+	TST_EXPECT(tst_same_mark(doc1->start_mark, doc2->start_mark));
+	TST_EXPECT(tst_same_mark(doc1->end_mark, doc2->end_mark));
+	TST_EXPECT(doc1->nodes.top - doc1->nodes.start == doc2->nodes.top - doc2->nodes.start);
+	for (yaml_node_t *node1 = doc1->nodes.start, *node2 = doc2->nodes.start; node1 < doc1->nodes.top; ++node1, ++node2) {
+		TST_EXPECT(node1->type == node2->type);
+		TST_EXPECT(!strcmp((const char*)node1->tag, (const char*)node2->tag));
+		TST_EXPECT(tst_same_mark(node1->start_mark, node2->start_mark));
+		TST_EXPECT(tst_same_mark(node1->end_mark, node2->end_mark));
+		switch (node1->type) {
+		case YAML_SCALAR_NODE:
+			TST_EXPECT(node1->data.scalar.style == node2->data.scalar.style);
+			TST_EXPECT(node1->data.scalar.length == node2->data.scalar.length);
+			TST_EXPECT(!memcmp(node1->data.scalar.value, node2->data.scalar.value, node1->data.scalar.length));
+			break;
+		case YAML_SEQUENCE_NODE: {
+			TST_EXPECT(node1->data.sequence.style == node2->data.sequence.style);
+			size_t size = node1->data.sequence.items.top - node1->data.sequence.items.start;
+			TST_EXPECT(size == (size_t)(node2->data.sequence.items.top - node2->data.sequence.items.start));
+			TST_EXPECT(!memcmp(node1->data.sequence.items.start, node2->data.sequence.items.start, size * sizeof(yaml_node_item_t)));
+		} break;
+		case YAML_MAPPING_NODE: {
+			TST_EXPECT(node1->data.mapping.style == node2->data.mapping.style);
+			size_t size = node1->data.mapping.pairs.top - node1->data.mapping.pairs.start;
+			TST_EXPECT(size == (size_t)(node2->data.mapping.pairs.top - node2->data.mapping.pairs.start));
+			TST_EXPECT(!memcmp(node1->data.mapping.pairs.start, node2->data.mapping.pairs.start, size * sizeof(yaml_node_pair_t)));
+		} break;
+		default:
+			TST_EXPECT(0);
+		}
+	}
+}
+
+/* Writes a large document whose top-level entries contain all kinds of
+ * constructs, the entry at a given index being replaced by a given one
+ */
+void tst_write(const char* path, const char* header, int special_idx, const char* special)
+{
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	fputs(header, output);
+	for (int key = 0; key < NB_KEYS; ++key) {
+		if (key == special_idx) {
+			fputs(special, output);
+			continue;
+		}
+		switch (key % 8) {
+		case 0:
+			fprintf(output, "key%d:\n  value: %d\n  name: 'it''s #%d'\n  list:\n  - a\n  - b: \"\\u00e9\"\n", key, key, key);
+			break;
+		case 1:
+			// block scalars may look like anything
+			fprintf(output, "literal%d: |\n  text: 'unbalanced [\n  {\n\n  key%d: \"\n  # not a comment\nfolded%d: >-\n  more\n", key, key, key);
+			break;
+		case 2:
+			// flow collections & quoted scalars spanning lines that start at column 0
+			fprintf(output, "flow%d: [1, 2,\n3, {a: b,\nc: d}]\nquoted%d: 'first\nsecond: line'\n", key, key);
+			break;
+		case 3:
+			fprintf(output, "seq%d:\n- 1\n- - nested\n  - list\n# comment: [\n\n", key);
+			break;
+		case 4:
+			fprintf(output, "\"quoted key %d\": {x: 1, y: [2, 3]}\n", key);
+			break;
+		case 5:
+			fprintf(output, "plain%d: multi\n  line plain\n  scalar\ntagged%d: !!str %d\n", key, key, key);
+			break;
+		case 6:
+			fprintf(output, "deep%d:\n  a:\n    b:\n      c: [x, 'y', \"z\"]\n      d: |+\n        kept\n\n", key);
+			break;
+		default:
+			fprintf(output, "unicode%d: \xc3\xa9t\xc3\xa9 \xe6\x97\xa5\xe6\x9c\xac\r\nempty%d:\n", key, key);
+			break;
+		}
+	}
+	TST_EXPECT(!fclose(output));
+}
+
+/* Writes a large document of the block subset, with a few entries of a given
+ * kind in its middle
+ */
+void tst_write_block(const char* path, const char* special)
+{
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	for (int key = 0; key < NB_KEYS; ++key) {
+		if (special && key == NB_KEYS / 2) fputs(special, output);
+		fprintf(output, "key%d:\n  value: %d\n  name: 'it''s #%d' # comment\n  list:\n  - a\n  - b: \"\\u00e9\"\n", key, key, key);
+		fprintf(output, "seq%d:\n- 1\n- - nested\n  - list with padding to make the file larger\n", key);
+	}
+	TST_EXPECT(!fclose(output));
+}
+
+/* Checks the parallel parse of a file gives the same result as the serial one
+ * whatever the number of workers
+ */
+void tst_compare(const char* path)
+{
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_tree_t serial = PC_parse_path(path);
+	char* message = PC_status(serial) ? strdup(PC_errmsg()) : NULL;
+	int nb_workers[] = {1, 2, 3, 8, 0};
+	for (size_t idx = 0; idx < sizeof(nb_workers) / sizeof(nb_workers[0]); ++idx) {
+		PC_tree_t parallel = PC_parse_path_parallel(path, nb_workers[idx]);
+		TST_EXPECT(PC_status(parallel) == PC_status(serial));
+		if (PC_status(serial)) {
+			TST_EXPECT(!strcmp(message, PC_errmsg()));
+			continue;
+		}
+		tst_same_document(&serial.pcdoc->document, &parallel.pcdoc->document);
+		TST_EXPECT(!strcmp(serial.pcdoc->path, parallel.pcdoc->path));
+		PC_tree_destroy(&parallel);
+	}
+	PC_errhandler(handler);
+	free(message);
+	if (!PC_status(serial)) PC_tree_destroy(&serial);
+}
+
+/* Checks the parallel parse of large documents
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test22_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64];
+	sprintf(path, "%s/conf.yml", dir);
+
+	// documents the native scanner reads, then with entries that libyaml reads
+	for (int backend = 0; backend < 2; ++backend) {
+		tst_write_block(path, NULL);
+		tst_compare(path);
+		tst_write_block(path, "flow: [1, 2]\n");
+		tst_compare(path);
+		TST_EXPECT(setenv("PARACONF_PARSER", "libyaml", 1) == 0);
+	}
+	TST_EXPECT(unsetenv("PARACONF_PARSER") == 0);
+
+	// all constructs, as is or with an explicit start
+	tst_write(path, "", -1, "");
+	tst_compare(path);
+	tst_write(path, "--- # start\n", -1, "");
+	tst_compare(path);
+	PC_tree_t tree = PC_parse_path_parallel(path, 4);
+	char* value = NULL;
+	TST_EXPECT(!PC_string(PC_get(tree, ".quoted%d", 2 + 8 * 100), &value));
+	TST_EXPECT(!strcmp(value, "first second: line"));
+	free(value);
+	long item = 0;
+	TST_EXPECT(!PC_int(PC_get(tree, ".flow%d[2]", 2 + 8 * 200), &item) && item == 3);
+	PC_tree_destroy(&tree);
+
+	// errors anywhere are reported as by the serial parse
+	tst_write(path, "", NB_KEYS / 2, "bad: [1, 2\n");
+	tst_compare(path);
+	tst_write(path, "", NB_KEYS - 1, "  indented: 1\n");
+	tst_compare(path);
+	tst_write(path, "", NB_KEYS / 3, "a: b: c\n");
+	tst_compare(path);
+
+	// documents that can not be split are parsed serially
+	tst_write(path, "", NB_KEYS / 2, "anchor: &a 1\nalias: *a\n");
+	tst_compare(path);
+	tst_write(path, "%YAML 1.1\n---\n", -1, "");
+	tst_compare(path);
+	tst_write(path, "  indented: root\n", -1, "");
+	tst_compare(path);
+	tst_write(path, "", NB_KEYS / 2, "...\n");
+	tst_compare(path);
+	tst_write(path, "", NB_KEYS / 2, "---\nsecond: document\n");
+	tst_compare(path);
+	tst_write(path, "", 0, "- sequence\n");
+	tst_compare(path);
+	tst_write(path, "{flow: root}\n", -1, "");
+	tst_compare(path);
+	tst_write(path, "!custom\n", -1, "");
+	tst_compare(path);
+
+	// small & missing files
+	FILE* output = fopen(path, "w");
+	TST_EXPECT(output != NULL);
+	fputs("a: 1\nb: 2\n", output);
+	TST_EXPECT(!fclose(output));
+	tst_compare(path);
+	unlink(path);
+	tst_compare(path);
+
+	rmdir(dir);
+	return 0;
+}
@@ -0,0 +1,90 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks key lookups in mappings large enough to be hashed
+ */
+int main()
+{
+	enum { WIDTH = 1000 };
+	char* yaml = malloc(WIDTH * 32 + 64);
+	size_t pos = 0;
+	for (int ii = 0; ii < WIDTH; ++ii) {
+		pos += sprintf(yaml + pos, "key_%d: %d\n", ii, ii);
+	}
+	pos += sprintf(yaml + pos, "key_7: 7000\n");  // duplicate, the first one wins
+	pos += sprintf(yaml + pos, "? [complex]\n: 0\n"); // non-scalar key, ignored
+	pos += sprintf(yaml + pos, "\"\": empty\n");
+	PC_tree_t conf = PC_parse_string(yaml);
+	free(yaml);
+
+	for (int ii = 0; ii < WIDTH; ++ii) {
+		long value;
+		TST_EXPECT(!PC_int(PC_get(conf, ".key_%d", ii), &value));
+		TST_EXPECT(value == ii);
+	}
+
+	long key_7;
+	PC_int(PC_get(conf, ".key_7"), &key_7);
+	TST_EXPECT(key_7 == 7);
+
+	char* empty;
+	PC_string(PC_get(conf, "."), &empty);
+	TST_EXPECT(!strcmp(empty, "empty"));
+	free(empty);
+
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_status(PC_get(conf, ".key_%d", WIDTH)) == PC_NODE_NOT_FOUND);
+	TST_EXPECT(PC_status(PC_get(conf, ".key_")) == PC_NODE_NOT_FOUND);
+	TST_EXPECT(PC_status(PC_get(conf, ".key_10000")) == PC_NODE_NOT_FOUND);
+	PC_errhandler(handler);
+
+	// the same once frozen
+	TST_EXPECT(!PC_tree_freeze(&conf));
+	TST_EXPECT(!PC_tree_freeze(&conf));
+	for (int ii = 0; ii < WIDTH; ++ii) {
+		long value;
+		TST_EXPECT(!PC_int(PC_get(conf, ".key_%d", ii), &value));
+		TST_EXPECT(value == ii);
+	}
+	PC_int(PC_get(conf, ".key_7"), &key_7);
+	TST_EXPECT(key_7 == 7);
+	int len;
+	PC_len(PC_get(conf, "{%d}", WIDTH + 1), &len);
+	TST_EXPECT(len == 1);
+	char* complex_key;
+	PC_string(PC_get(conf, "{%d}[0]", WIDTH + 1), &complex_key);
+	TST_EXPECT(!strcmp(complex_key, "complex"));
+	free(complex_key);
+
+	// aliases are preserved
+	PC_tree_t aliased = PC_parse_string("a: &anchor {x: 1, y: [2, 3]}\nb: *anchor\nc: *anchor\n");
+	TST_EXPECT(!PC_tree_freeze(&aliased));
+	long y_1;
+	PC_int(PC_get(aliased, ".c.y[1]"), &y_1);
+	TST_EXPECT(y_1 == 3);
+	TST_EXPECT(PC_get(aliased, ".a").node == PC_get(aliased, ".c").node);
+	PC_tree_destroy(&aliased);
+
+	PC_tree_destroy(&conf);
+
+	fprintf(stderr, "All tests passed!\n");
+	return 0;
+}
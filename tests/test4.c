@@ -0,0 +1,175 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks two trees have the same content
+ */
+void tst_same(PC_tree_t expected, PC_tree_t actual)
+{
+	TST_EXPECT(!PC_status(expected) && !PC_status(actual));
+	TST_EXPECT(expected.node->type == actual.node->type);
+	TST_EXPECT(!strcmp((char*)expected.node->tag, (char*)actual.node->tag));
+	if (expected.node->type == YAML_SCALAR_NODE) {
+		const char *expected_value, *actual_value;
+		int expected_len, actual_len;
+		TST_EXPECT(!PC_string_view(expected, &expected_value, &expected_len));
+		TST_EXPECT(!PC_string_view(actual, &actual_value, &actual_len));
+		TST_EXPECT(expected_len == actual_len && !memcmp(expected_value, actual_value, expected_len));
+		return;
+	}
+	int expected_len, actual_len;
+	TST_EXPECT(!PC_len(expected, &expected_len));
+	TST_EXPECT(!PC_len(actual, &actual_len));
+	TST_EXPECT(expected_len == actual_len);
+	for (int ii = 0; ii < expected_len; ++ii) {
+		if (expected.node->type == YAML_SEQUENCE_NODE) {
+			tst_same(PC_get(expected, "[%d]", ii), PC_get(actual, "[%d]", ii));
+		} else {
+			tst_same(PC_get(expected, "{%d}", ii), PC_get(actual, "{%d}", ii));
+			tst_same(PC_get(expected, "<%d>", ii), PC_get(actual, "<%d>", ii));
+		}
+	}
+}
+
+/** An in-process stand-in for a broadcast: the root records, the others replay
+ */
+typedef struct wire_s {
+	int nb_messages;
+	int next_message;
+	void* messages[2];
+} wire_t;
+
+PC_status_t wire_send(void* buffer, size_t size, void* context)
+{
+	wire_t* wire = context;
+	wire->messages[wire->nb_messages] = malloc(size);
+	memcpy(wire->messages[wire->nb_messages++], buffer, size);
+	return PC_OK;
+}
+
+PC_status_t wire_receive(void* buffer, size_t size, void* context)
+{
+	wire_t* wire = context;
+	memcpy(buffer, wire->messages[wire->next_message++], size);
+	return PC_OK;
+}
+
+PC_status_t wire_fail(void* buffer, size_t size, void* context)
+{
+	(void)buffer;
+	(void)size;
+	(void)context;
+	return PC_SYSTEM_ERROR;
+}
+
+/* Checks serialization, deserialization & broadcast of documents
+ */
+int main(int argc, char* argv[])
+{
+	TST_EXPECT(argc == 2);
+	PC_tree_t conf = PC_parse_path(argv[1]);
+	TST_EXPECT(!PC_status(conf));
+
+	// whole document
+	void* buffer;
+	size_t size;
+	TST_EXPECT(!PC_serialize(conf, &buffer, &size));
+	PC_tree_t copy = PC_deserialize(buffer, size);
+	tst_same(conf, copy);
+	TST_EXPECT(!strcmp(PC_path(conf), PC_path(copy)));
+	long value;
+	TST_EXPECT(!PC_int(PC_get(copy, ".another_map.second"), &value) && value == 41);
+	PC_tree_destroy(&copy);
+
+	// corrupted buffers are rejected
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(PC_status(PC_deserialize(buffer, size - 1)) == PC_INVALID_FORMAT);
+	((char*)buffer)[size - 1] = 'X';
+	TST_EXPECT(PC_status(PC_deserialize(buffer, size)) == PC_INVALID_FORMAT);
+	((char*)buffer)[size - 1] = 0;
+
+	// headers with counts inconsistent with the buffer size, the sizes must not overflow
+	char crafted[100];
+	memset(crafted, 0, sizeof(crafted));
+	memcpy(crafted, buffer, 48);
+	uint32_t nb_nodes = 100, nb_items = 0, nb_pairs = 0;
+	uint64_t strings_size = (uint64_t)100 - 48 - 1600;
+	memcpy(crafted + 12, &nb_nodes, sizeof(nb_nodes));
+	memcpy(crafted + 16, &nb_items, sizeof(nb_items));
+	memcpy(crafted + 20, &nb_pairs, sizeof(nb_pairs));
+	memcpy(crafted + 24, &strings_size, sizeof(strings_size));
+	TST_EXPECT(PC_status(PC_deserialize(crafted, sizeof(crafted))) == PC_INVALID_FORMAT);
+	nb_nodes = 0;
+	nb_items = 0xFFFFFFFFu;
+	memcpy(crafted + 12, &nb_nodes, sizeof(nb_nodes));
+	memcpy(crafted + 16, &nb_items, sizeof(nb_items));
+	strings_size = (uint64_t)100 - 48 - 4 * ((uint64_t)nb_items + 1);
+	memcpy(crafted + 24, &strings_size, sizeof(strings_size));
+	TST_EXPECT(PC_status(PC_deserialize(crafted, sizeof(crafted))) == PC_INVALID_FORMAT);
+	((char*)buffer)[0] = 'X';
+	TST_EXPECT(PC_status(PC_deserialize(buffer, size)) == PC_INVALID_FORMAT);
+	PC_errhandler(handler);
+	free(buffer);
+
+	// sub-tree, the whole document is kept
+	PC_tree_t sub = PC_get(conf, ".a_map");
+	TST_EXPECT(!PC_serialize(sub, &buffer, &size));
+	copy = PC_deserialize(buffer, size);
+	free(buffer);
+	tst_same(sub, copy);
+	TST_EXPECT(!PC_int(PC_get(copy, ".second"), &value) && value == 21);
+	PC_tree_destroy(&copy);
+
+	// broadcast
+	wire_t wire = {0, 0, {NULL, NULL}};
+	PC_tree_t sent = PC_broadcast(conf, 1, wire_send, &wire);
+	TST_EXPECT(sent.node == conf.node);
+	TST_EXPECT(wire.nb_messages == 2);
+	PC_tree_t received = PC_broadcast((PC_tree_t){PC_INVALID_PARAMETER, NULL, NULL}, 0, wire_receive, &wire);
+	tst_same(conf, received);
+	PC_tree_destroy(&received);
+	free(wire.messages[0]);
+	free(wire.messages[1]);
+
+	// a root in error or that can not serialize its tree still sends a size, the others fail without a second call
+	handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_tree_t lazy = PC_parse_path_lazy(argv[1]);
+	TST_EXPECT(PC_serialize(lazy, &buffer, &size) == PC_INVALID_PARAMETER);
+	PC_tree_t failed[] = {{PC_NODE_NOT_FOUND, NULL, NULL}, lazy};
+	PC_status_t failed_status[] = {PC_NODE_NOT_FOUND, PC_INVALID_PARAMETER};
+	for (int ii = 0; ii < 2; ++ii) {
+		wire = (wire_t){0, 0, {NULL, NULL}};
+		TST_EXPECT(PC_status(PC_broadcast(failed[ii], 1, wire_send, &wire)) == failed_status[ii]);
+		TST_EXPECT(wire.nb_messages == 1);
+		TST_EXPECT(PC_status(PC_broadcast((PC_tree_t){PC_INVALID_PARAMETER, NULL, NULL}, 0, wire_receive, &wire)) == PC_INVALID_PARAMETER);
+		TST_EXPECT(wire.next_message == 1);
+		free(wire.messages[0]);
+	}
+	PC_tree_destroy(&lazy);
+
+	TST_EXPECT(PC_status(PC_broadcast(conf, 1, wire_fail, NULL)) == PC_SYSTEM_ERROR);
+	TST_EXPECT(PC_status(PC_broadcast(conf, 0, wire_fail, NULL)) == PC_SYSTEM_ERROR);
+	PC_errhandler(handler);
+
+	PC_tree_destroy(&conf);
+	return 0;
+}
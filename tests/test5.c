@@ -0,0 +1,131 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+void tst_write(const char* path, const char* content, time_t mtime)
+{
+	FILE* file = fopen(path, "w");
+	TST_EXPECT(file != NULL);
+	fputs(content, file);
+	fclose(file);
+	struct timespec times[2] = {{mtime, 0}, {mtime, 0}};
+	TST_EXPECT(!utimensat(AT_FDCWD, path, times, 0));
+}
+
+long tst_value(const char* path, const char* cache_dir)
+{
+	PC_tree_t conf = PC_parse_path_cached(path, cache_dir);
+	TST_EXPECT(!PC_status(conf));
+	TST_EXPECT(!strcmp(PC_path(conf), path));
+	long value, item;
+	TST_EXPECT(!PC_int(PC_get(conf, ".value"), &value));
+	TST_EXPECT(!PC_int(PC_get(conf, ".list[1]"), &item) && item == 3);
+	PC_tree_destroy(&conf);
+	return value;
+}
+
+/* Returns the path of the single cache file in a directory
+ */
+void tst_cache_file(const char* dir, char* cache)
+{
+	DIR* dir_stream = opendir(dir);
+	TST_EXPECT(dir_stream != NULL);
+	int nb_files = 0;
+	for (struct dirent* entry = readdir(dir_stream); entry; entry = readdir(dir_stream)) {
+		if (entry->d_name[0] == '.') continue;
+		sprintf(cache, "%s/%s", dir, entry->d_name);
+		++nb_files;
+	}
+	closedir(dir_stream);
+	TST_EXPECT(nb_files == 1);
+}
+
+/* Checks the on-disk cache of parsed files
+ */
+int main()
+{
+	char dir[] = "/tmp/paraconf_test5_XXXXXX";
+	TST_EXPECT(mkdtemp(dir) != NULL);
+	char path[64], cache_dir[64], cache[128];
+	sprintf(path, "%s/conf.yml", dir);
+	sprintf(cache_dir, "%s/cache", dir);
+
+	// the cache is created on first parse
+	tst_write(path, "value: 1\nlist: [2, 3]\n", 1000);
+	TST_EXPECT(tst_value(path, cache_dir) == 1);
+	tst_cache_file(cache_dir, cache);
+	TST_EXPECT(tst_value(path, cache_dir) == 1);
+
+	// same size & time: the cache is trusted without looking at the content
+	tst_write(path, "value: 9\nlist: [2, 3]\n", 1000);
+	TST_EXPECT(tst_value(path, cache_dir) == 1);
+
+	// touched file with a different content: the cache is rebuilt
+	tst_write(path, "value: 9\nlist: [2, 3]\n", 2000);
+	TST_EXPECT(tst_value(path, cache_dir) == 9);
+
+	// different size
+	tst_write(path, "value: 10\nlist: [2, 3]\n", 2000);
+	TST_EXPECT(tst_value(path, cache_dir) == 10);
+
+	// touched file with the same content: the cache is kept
+	tst_write(path, "value: 10\nlist: [2, 3]\n", 3000);
+	TST_EXPECT(tst_value(path, cache_dir) == 10);
+	tst_cache_file(cache_dir, cache);
+
+	// corrupted cache
+	FILE* cache_file = fopen(cache, "r+");
+	TST_EXPECT(cache_file != NULL);
+	fseek(cache_file, -2, SEEK_END);
+	fputc('X', cache_file);
+	fclose(cache_file);
+	TST_EXPECT(tst_value(path, cache_dir) == 10);
+	truncate(cache, 10);
+	TST_EXPECT(tst_value(path, cache_dir) == 10);
+	TST_EXPECT(tst_value(path, cache_dir) == 10);
+	unlink(cache);
+	rmdir(cache_dir);
+
+	// cache next to the file
+	unsetenv("PARACONF_CACHE_DIR");
+	TST_EXPECT(tst_value(path, NULL) == 10);
+	sprintf(cache, "%s.pcache", path);
+	TST_EXPECT(!access(cache, R_OK));
+	TST_EXPECT(tst_value(path, NULL) == 10);
+	unlink(cache);
+
+	// errors are reported as with PC_parse_path
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	tst_write(path, "value: [\n", 4000);
+	TST_EXPECT(PC_status(PC_parse_path_cached(path, NULL)) == PC_INVALID_FORMAT);
+	TST_EXPECT(access(cache, F_OK));
+	PC_errhandler(handler);
+
+	unlink(path);
+	rmdir(dir);
+	return 0;
+}
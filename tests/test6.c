@@ -0,0 +1,149 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <float.h>
+#include <locale.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+long tst_int(const char* yaml)
+{
+	PC_tree_t conf = PC_parse_string(yaml);
+	long value = -1;
+	TST_EXPECT(!PC_int(conf, &value));
+	PC_tree_destroy(&conf);
+	return value;
+}
+
+double tst_double(const char* yaml)
+{
+	PC_tree_t conf = PC_parse_string(yaml);
+	double value = -1;
+	TST_EXPECT(!PC_double(conf, &value));
+	PC_tree_destroy(&conf);
+	return value;
+}
+
+PC_status_t tst_invalid(const char* yaml)
+{
+	PC_tree_t conf = PC_parse_string(yaml);
+	long int_value;
+	double double_value;
+	PC_status_t status = PC_int(conf, &int_value) ? PC_double(conf, &double_value) : PC_OK;
+	PC_tree_destroy(&conf);
+	return status;
+}
+
+/* Checks the conversion of all valid values of a table against strtod
+ */
+void tst_table(void)
+{
+	enum { SIZE = 20000 };
+	char* yaml = malloc(SIZE * 32 + 4);
+	double* expected = malloc(SIZE * sizeof(double));
+	double* values = malloc(SIZE * sizeof(double));
+	size_t pos = sprintf(yaml, "[");
+	srand(1);
+	for (int ii = 0; ii < SIZE; ++ii) {
+		uint64_t bits = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		if (!isfinite(value)) value = ii;
+		static const char* formats[] = {"%.17g, ", "%.6e, ", "%.3f, ", "%.15g, "};
+		int len = sprintf(yaml + pos, formats[ii % 4], ii % 4 == 2 ? fmod(value, 1e6) : value);
+		expected[ii] = strtod(yaml + pos, NULL);
+		pos += len;
+	}
+	sprintf(yaml + pos - 2, "]");
+	PC_tree_t conf = PC_parse_string(yaml);
+	TST_EXPECT(!PC_double_array(conf, values, SIZE));
+	TST_EXPECT(!memcmp(values, expected, SIZE * sizeof(double)));
+	PC_tree_destroy(&conf);
+	free(values);
+	free(expected);
+	free(yaml);
+}
+
+/* Checks the parsing of numeric scalars
+ */
+int main()
+{
+	TST_EXPECT(tst_int("42") == 42);
+	TST_EXPECT(tst_int("-17") == -17);
+	TST_EXPECT(tst_int("+17") == 17);
+	TST_EXPECT(tst_int("0x1F") == 31);
+	TST_EXPECT(tst_int("0o17") == 15);
+	TST_EXPECT(tst_int("017") == 15);
+	TST_EXPECT(tst_int("0b101") == 5);
+	TST_EXPECT(tst_int("1_000_000") == 1000000);
+	TST_EXPECT(tst_int("9223372036854775807") == 9223372036854775807L);
+	TST_EXPECT(tst_int("-9223372036854775808") == -9223372036854775807L - 1);
+
+	TST_EXPECT(tst_double("0.1") == 0.1);
+	TST_EXPECT(tst_double("-2.5e-3") == -2.5e-3);
+	TST_EXPECT(tst_double("1e23") == 1e23);
+	TST_EXPECT(tst_double("6.02214076E+23") == 6.02214076e23);
+	TST_EXPECT(tst_double("1_000.5") == 1000.5);
+	TST_EXPECT(tst_double(".5") == 0.5);
+	TST_EXPECT(tst_double("7") == 7.);
+	TST_EXPECT(tst_double("0x10") == 16.);
+	TST_EXPECT(tst_double("0x1p3") == 8.);
+	TST_EXPECT(tst_double("-0x1.8P-1") == -0.75);
+	TST_EXPECT(tst_double("0x1.fffffffffffffp1023") == DBL_MAX);
+	TST_EXPECT(tst_double("2.2250738585072011e-308") == 2.2250738585072011e-308);
+	TST_EXPECT(tst_double("4.9406564584124654e-324") == 4.9406564584124654e-324);
+	TST_EXPECT(tst_double("1e-400") == 0.);
+	TST_EXPECT(tst_double("0.1000000000000000055511151231257827021181583404541015625") == 0.1);
+	TST_EXPECT(tst_double("9007199254740993") == 9007199254740992.);
+	TST_EXPECT(tst_double("9007199254740993.000000000000000000001") == 9007199254740994.);
+	TST_EXPECT(tst_double(".inf") == INFINITY);
+	TST_EXPECT(tst_double("-.Inf") == -INFINITY);
+	TST_EXPECT(tst_double("1e400") == INFINITY);
+	TST_EXPECT(isnan(tst_double(".NaN")));
+	TST_EXPECT(signbit(tst_double("-0.0")));
+
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	TST_EXPECT(tst_invalid("9223372036854775808") == PC_OK); // too large for an integer, still a valid float
+	TST_EXPECT(tst_invalid("''") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("1.5.2") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("1e") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("0x") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("12abc") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("1,5") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("_1") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("-_1") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("0x_1") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("0x1p") == PC_INVALID_PARAMETER);
+	TST_EXPECT(tst_invalid("0xp3") == PC_INVALID_PARAMETER);
+	PC_errhandler(handler);
+
+	tst_table();
+
+	// the locale has no effect, when one with a comma decimal separator is available
+	if (setlocale(LC_ALL, "fr_FR.UTF-8") || setlocale(LC_ALL, "de_DE.UTF-8") || setlocale(LC_ALL, "fr_FR") || setlocale(LC_ALL, "de_DE")) {
+		TST_EXPECT(tst_double("1.5") == 1.5);
+		TST_EXPECT(tst_double("1.00000000000000000000000000001") == 1.);
+		TST_EXPECT(tst_double("0x1.8p1") == 3.);
+		tst_table();
+	}
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks both trees give the same results for all conversions of all items
+ */
+void tst_same(PC_tree_t expected, PC_tree_t actual, int len)
+{
+	for (int ii = 0; ii < len; ++ii) {
+		PC_tree_t expected_item = PC_get(expected, "[%d]", ii);
+		PC_tree_t actual_item = PC_get(actual, "[%d]", ii);
+		long expected_int = 0, actual_int = 0;
+		TST_EXPECT(PC_int(expected_item, &expected_int) == PC_int(actual_item, &actual_int));
+		TST_EXPECT(expected_int == actual_int);
+		double expected_double = 0, actual_double = 0;
+		TST_EXPECT(PC_double(expected_item, &expected_double) == PC_double(actual_item, &actual_double));
+		TST_EXPECT(!memcmp(&expected_double, &actual_double, sizeof(double)));
+		int expected_bool = -1, actual_bool = -1;
+		TST_EXPECT(PC_bool(expected_item, &expected_bool) == PC_bool(actual_item, &actual_bool));
+		TST_EXPECT(expected_bool == actual_bool);
+	}
+}
+
+/* Checks the scalar values stored by PC_tree_resolve
+ */
+int main()
+{
+	const char* yaml = "[0, 42, -7, 0x1F, 017, 1_000, 3.25, -1e-3, .inf, .nan, 9223372036854775808, true, No, YES, yes2, "
+	                   "'10', \"0.5\", abc, '', ~, null, [1, 2], {a: 1}, &anchor 12, *anchor]";
+	enum { LEN = 25 };
+
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	PC_tree_t plain = PC_parse_string(yaml);
+	PC_tree_t resolved = PC_parse_string(yaml);
+	TST_EXPECT(!PC_tree_resolve(resolved));
+	TST_EXPECT(!PC_tree_resolve(resolved)); // no-op
+	tst_same(plain, resolved, LEN);
+
+	long int_values[LEN];
+	TST_EXPECT(PC_int_array(plain, int_values, LEN) == PC_int_array(resolved, int_values, LEN));
+	TST_EXPECT(strstr(PC_errmsg(), "found 16 invalid items out of 25") != NULL);
+
+	// freezing keeps the document resolved
+	TST_EXPECT(!PC_tree_freeze(&resolved));
+	tst_same(plain, resolved, LEN);
+	PC_errhandler(handler);
+
+	long sub_values[3];
+	PC_tree_t sub = PC_parse_string("{a: [1, 2, 3], b: 4}");
+	TST_EXPECT(!PC_tree_resolve(PC_get(sub, ".a")));
+	TST_EXPECT(!PC_int_array(PC_get(sub, ".a"), sub_values, 3));
+	TST_EXPECT(sub_values[0] == 1 && sub_values[1] == 2 && sub_values[2] == 3);
+	TST_EXPECT(!PC_int(PC_get(sub, ".b"), &sub_values[0]) && sub_values[0] == 4);
+	PC_tree_destroy(&sub);
+
+	PC_tree_destroy(&resolved);
+	PC_tree_destroy(&plain);
+	return 0;
+}
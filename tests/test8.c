@@ -0,0 +1,111 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+typedef struct config_s {
+	int nx;
+	long ny;
+	double dt;
+	int verbose;
+	char* name;
+	double tolerance;
+	int restart;
+	char* output;
+	int first;
+} config_t;
+
+static const PC_field_t CONFIG_FIELDS[] = {
+	{".mesh.nx", PC_FIELD_INT, offsetof(config_t, nx), 0, NULL},
+	{".solver.name", PC_FIELD_STRING, offsetof(config_t, name), 0, NULL},
+	{".mesh.ny", PC_FIELD_LONG, offsetof(config_t, ny), 0, NULL},
+	{".solver.dt", PC_FIELD_DOUBLE, offsetof(config_t, dt), 0, NULL},
+	{".verbose", PC_FIELD_BOOL, offsetof(config_t, verbose), 0, NULL},
+	{".solver.tolerance", PC_FIELD_DOUBLE, offsetof(config_t, tolerance), PC_FIELD_OPTIONAL, "1e-6"},
+	{".restart.enabled", PC_FIELD_BOOL, offsetof(config_t, restart), PC_FIELD_OPTIONAL, "false"},
+	{".restart.file", PC_FIELD_STRING, offsetof(config_t, output), PC_FIELD_OPTIONAL, "restart.h5"},
+	{".list[0]", PC_FIELD_INT, offsetof(config_t, first), PC_FIELD_OPTIONAL, NULL},
+};
+
+enum { NB_FIELDS = sizeof(CONFIG_FIELDS) / sizeof(CONFIG_FIELDS[0]) };
+
+/* Checks the extraction of fields into a struct
+ */
+int main()
+{
+	PC_tree_t conf = PC_parse_string("{mesh: {nx: 64, ny: 0x100}, solver: {dt: 2.5e-3, name: cg}, verbose: yes, list: [7]}");
+	config_t config;
+	memset(&config, 0, sizeof(config));
+	TST_EXPECT(!PC_extract(conf, CONFIG_FIELDS, NB_FIELDS, &config));
+	TST_EXPECT(config.nx == 64);
+	TST_EXPECT(config.ny == 256);
+	TST_EXPECT(config.dt == 2.5e-3);
+	TST_EXPECT(config.verbose == 1);
+	TST_EXPECT(!strcmp(config.name, "cg"));
+	TST_EXPECT(config.tolerance == 1e-6);
+	TST_EXPECT(config.restart == 0);
+	TST_EXPECT(!strcmp(config.output, "restart.h5"));
+	TST_EXPECT(config.first == 7);
+	free(config.output);
+	free(config.name);
+
+	// the same results on a resolved document
+	TST_EXPECT(!PC_tree_resolve(conf));
+	memset(&config, 0, sizeof(config));
+	TST_EXPECT(!PC_extract(conf, CONFIG_FIELDS, NB_FIELDS, &config));
+	TST_EXPECT(config.nx == 64 && config.ny == 256 && config.dt == 2.5e-3 && config.first == 7);
+	free(config.output);
+	free(config.name);
+	PC_tree_destroy(&conf);
+
+	// all errors are reported at once, the valid fields are filled
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	conf = PC_parse_string("{mesh: {nx: 1e20, ny: abc}, solver: 3, verbose: true, list: {}}");
+	memset(&config, 0, sizeof(config));
+	config.first = -1;
+	TST_EXPECT(PC_extract(conf, CONFIG_FIELDS, NB_FIELDS, &config) == PC_INVALID_NODE_TYPE); // the status of `.mesh.nx'
+	const char* message = PC_errmsg();
+	TST_EXPECT(strstr(message, "Unable to extract 6 fields out of 9:") != NULL);
+	TST_EXPECT(strstr(message, "`.mesh.nx'") != NULL);
+	TST_EXPECT(strstr(message, "`.mesh.ny'") != NULL);
+	TST_EXPECT(strstr(message, "`.solver.dt'") != NULL);
+	TST_EXPECT(strstr(message, "`.solver.tolerance'") != NULL);
+	TST_EXPECT(strstr(message, "`.list[0]'") != NULL);
+	TST_EXPECT(strstr(message, "`.restart") == NULL);
+	TST_EXPECT(config.verbose == 1);
+	TST_EXPECT(config.first == -1);
+	TST_EXPECT(config.restart == 0);
+	free(config.output);
+
+	// invalid paths and defaults
+	static const PC_field_t INVALID_FIELDS[] = {
+		{".mesh[", PC_FIELD_INT, offsetof(config_t, nx), 0, NULL},
+		{".mesh.$0", PC_FIELD_INT, offsetof(config_t, nx), 0, NULL},
+		{".missing", PC_FIELD_INT, offsetof(config_t, nx), PC_FIELD_OPTIONAL, "many"},
+		{".missing", PC_FIELD_INT, offsetof(config_t, nx), PC_FIELD_OPTIONAL, "0x7fffffffff"},
+	};
+	TST_EXPECT(PC_extract(conf, INVALID_FIELDS, 4, &config));
+	TST_EXPECT(strstr(PC_errmsg(), "Unable to extract 4 fields out of 4:") != NULL);
+	PC_errhandler(handler);
+	PC_tree_destroy(&conf);
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+#include "test9_config.h"
+
+#define TST_EXPECT(VALID) tst_expect_msg(VALID, #VALID)
+
+void tst_expect_msg(int valid, const char* message)
+{
+	if (!valid) {
+		fprintf(stderr, "Error, expected: %s!\n", message);
+		exit(1);
+	}
+}
+
+/* Checks the reader generated from test9_schema.yml
+ */
+int main()
+{
+	test9_config_t config;
+
+	// all values provided
+	PC_tree_t conf = PC_parse_string(
+		"{mesh: {nx: 64, ny: 32, origin: [0.5, -1]}, "
+		"solver: {name: gmres, dt: 0.25, tolerance: 1e-9, preconditioned: no, max-iter: 100}, "
+		"output: out.h5, double: 2.5, flags: [yes, no, true]}"
+	);
+	TST_EXPECT(!test9_config_read(conf, &config));
+	TST_EXPECT(config.mesh.nx == 64 && config.mesh.ny == 32);
+	TST_EXPECT(config.mesh.origin_len == 2 && config.mesh.origin[0] == 0.5 && config.mesh.origin[1] == -1);
+	TST_EXPECT(!strcmp(config.solver.name, "gmres"));
+	TST_EXPECT(config.solver.dt == 0.25 && config.solver.tolerance == 1e-9);
+	TST_EXPECT(config.solver.preconditioned == 0 && config.solver.max_iter == 100);
+	TST_EXPECT(!strcmp(config.output, "out.h5") && config.double_ == 2.5);
+	TST_EXPECT(config.flags_len == 3 && config.flags[0] == 1 && config.flags[1] == 0 && config.flags[2] == 1);
+	test9_config_free(&config);
+	TST_EXPECT(!config.output && !config.flags && !config.mesh.nx);
+	PC_tree_destroy(&conf);
+
+	// defaults, including those of a missing optional mapping
+	conf = PC_parse_string("{mesh: {nx: 8}}");
+	TST_EXPECT(!test9_config_read(conf, &config));
+	TST_EXPECT(config.mesh.nx == 8 && config.mesh.ny == 16);
+	TST_EXPECT(!config.mesh.origin && !config.mesh.origin_len);
+	TST_EXPECT(!strcmp(config.solver.name, "cg \"default\""));
+	TST_EXPECT(config.solver.dt == 1e-3 && config.solver.tolerance == -INFINITY);
+	TST_EXPECT(config.solver.preconditioned == 1 && config.solver.max_iter == LONG_MIN);
+	TST_EXPECT(!config.output && !config.flags && config.double_ == 0);
+	test9_config_free(&config);
+	PC_tree_destroy(&conf);
+
+	// errors
+	PC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);
+	conf = PC_parse_string("{mesh: {ny: 8}}");
+	TST_EXPECT(test9_config_read(conf, &config) == PC_NODE_NOT_FOUND);
+	TST_EXPECT(strstr(PC_errmsg(), "`nx'") != NULL);
+	PC_tree_destroy(&conf);
+
+	conf = PC_parse_string("{mesh: {nx: 8, origin: [1, a]}, output: out.h5}");
+	TST_EXPECT(test9_config_read(conf, &config) == PC_INVALID_PARAMETER);
+	TST_EXPECT(!config.output && !config.mesh.origin);
+	PC_tree_destroy(&conf);
+
+	conf = PC_parse_string("[1, 2]");
+	TST_EXPECT(test9_config_read(conf, &config) == PC_INVALID_NODE_TYPE);
+	PC_tree_destroy(&conf);
+	PC_errhandler(handler);
+
+	return 0;
+}
@@ -0,0 +1,937 @@
+/* Copyright (C) The Paraconf development team, see COPYRIGHT.md file at the
+ *               root of the project or at https://github.com/pdidev/paraconf
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Generates typed configuration readers from kwalify schemas
+ *
+ * usage: paraconf_codegen [-f] -p <prefix> -o <output_dir> <schema.yml>
+ *
+ * Writes <output_dir>/<prefix>.h and <output_dir>/<prefix>.c that define the
+ * <prefix>_t struct matching the schema along with <prefix>_read and
+ * <prefix>_free. The reader walks the document with PC_key & PC_at, the path
+ * of each value is unrolled in the generated code. With -f, also writes
+ * <output_dir>/<prefix>.f90, a Fortran module named <prefix> that wraps the C
+ * reader.
+ *
+ * The supported subset of kwalify is: the types map (with mapping), seq (of
+ * a single scalar type, with sequence), str, text, int, float, number and
+ * bool; the required, default and desc keys. The root rule must be a map.
+ * Other keys are ignored. Schemas where distinct keys generate the same
+ * identifier, ignoring the case as Fortran does, are rejected.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <paraconf.h>
+
+/** The kind of value described by a rule
+ */
+typedef enum kind_e {
+	KIND_INT,
+	KIND_FLOAT,
+	KIND_BOOL,
+	KIND_STR,
+	KIND_MAP,
+	KIND_SEQ
+} kind_t;
+
+/** A rule of the schema, i.e. a field of a generated struct
+ */
+typedef struct rule_s {
+	/// the key in the parent mapping, NULL for the root
+	char* key;
+
+	/// the C & Fortran identifier of the field
+	char* name;
+
+	/// for maps, the name of the generated struct type, without its _t suffix
+	char* type_name;
+
+	/// the kind of value
+	kind_t kind;
+
+	/// for sequences, the kind of the items
+	kind_t item_kind;
+
+	/// whether the value must be present
+	int required;
+
+	/// whether a default value is provided
+	int has_default;
+
+	/// the default value for KIND_INT & KIND_BOOL
+	long int_default;
+
+	/// the default value for KIND_FLOAT
+	double float_default;
+
+	/// the default value for KIND_STR
+	char* str_default;
+
+	/// the description of the value, NULL if none
+	char* desc;
+
+	/// for maps, the rules of the mapping values
+	struct rule_s* fields;
+
+	/// for maps, the number of mapping values
+	int nb_fields;
+
+} rule_t;
+
+/// the schema file being processed, for error messages
+static const char* schema_path;
+
+/// the global names already used in the generated code, and what uses each of them
+static char** global_names;
+static char** global_owners;
+static int nb_global_names;
+
+static void fail(const char* message, ...)
+{
+	va_list ap;
+	va_start(ap, message);
+	fprintf(stderr, "paraconf_codegen: %s: ", schema_path);
+	vfprintf(stderr, message, ap);
+	va_end(ap);
+	exit(1);
+}
+
+static void pc_fail(PC_status_t status, const char* message, void* context)
+{
+	(void)status;
+	(void)context;
+	fail("%s", message);
+}
+
+static char* dup_string(const char* value)
+{
+	char* result = malloc(strlen(value) + 1);
+	if (!result) fail("unable to allocate memory\n");
+	strcpy(result, value);
+	return result;
+}
+
+/** Returns the string value associated to a key, NULL if missing
+ */
+static char* string_opt(PC_tree_t tree, const char* key)
+{
+	PC_tree_t value = PC_key_opt(tree, key, strlen(key));
+	if (!value.node) return NULL;
+	char* result;
+	PC_string(value, &result);
+	return result;
+}
+
+/** Turns a mapping key into a valid C & Fortran identifier
+ */
+static char* identifier(const char* key)
+{
+	static const char* keywords[] = {"auto",   "break",  "case",    "char",   "const",    "continue", "default",  "do",     "double",
+	                                 "else",   "enum",   "extern",  "float",  "for",      "goto",     "if",       "inline", "int",
+	                                 "long",   "register", "restrict", "return", "short", "signed",   "sizeof",   "static", "struct",
+	                                 "switch", "typedef", "union",  "unsigned", "void",   "volatile", "while"};
+	size_t len = strlen(key);
+	// identifiers start with a letter in Fortran and have a trailing _ for C keywords
+	char* result = malloc(len + 3);
+	if (!result) fail("unable to allocate memory\n");
+	char* out = result;
+	if (!((key[0] >= 'a' && key[0] <= 'z') || (key[0] >= 'A' && key[0] <= 'Z'))) *out++ = 'f';
+	for (size_t ii = 0; ii < len; ++ii) {
+		char c = key[ii];
+		int valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+		*out++ = valid ? c : '_';
+	}
+	*out = 0;
+	for (size_t ii = 0; ii < sizeof(keywords) / sizeof(keywords[0]); ++ii) {
+		if (!strcmp(result, keywords[ii])) strcat(result, "_");
+	}
+	return result;
+}
+
+/** Compares two identifiers, ignoring the case as Fortran does
+ */
+static int same_identifier(const char* first, const char* second)
+{
+	for (; *first && *second; ++first, ++second) {
+		if (tolower((unsigned char)*first) != tolower((unsigned char)*second)) return 0;
+	}
+	return *first == *second;
+}
+
+/** Returns the concatenation of an identifier and a suffix
+ */
+static char* suffixed(const char* name, const char* suffix)
+{
+	char* result = malloc(strlen(name) + strlen(suffix) + 1);
+	if (!result) fail("unable to allocate memory\n");
+	sprintf(result, "%s%s", name, suffix);
+	return result;
+}
+
+/** Reserves a global name of the generated code, fails if it is already used
+ *
+ * \param name the name to reserve
+ * \param owner what the name is generated for, for error messages
+ */
+static void claim_global_name(char* name, const char* owner)
+{
+	for (int name_idx = 0; name_idx < nb_global_names; ++name_idx) {
+		if (same_identifier(global_names[name_idx], name)) {
+			fail("`%s' and `%s' both generate the name `%s'\n", global_owners[name_idx], owner, name);
+		}
+	}
+	global_names = realloc(global_names, (nb_global_names + 1) * sizeof(char*));
+	global_owners = realloc(global_owners, (nb_global_names + 1) * sizeof(char*));
+	if (!global_names || !global_owners) fail("unable to allocate memory\n");
+	global_names[nb_global_names] = name;
+	global_owners[nb_global_names++] = dup_string(owner);
+}
+
+static void release_global_names(void)
+{
+	for (int name_idx = 0; name_idx < nb_global_names; ++name_idx) {
+		free(global_names[name_idx]);
+		free(global_owners[name_idx]);
+	}
+	free(global_names);
+	free(global_owners);
+}
+
+/** Checks the members generated for the fields of a map have distinct names
+ *
+ * Each field generates a member of the same name, sequences also generate a
+ * <name>_len member.
+ */
+static void check_members(const rule_t* rule, const char* where)
+{
+	char** members = malloc(2 * rule->nb_fields * sizeof(char*));
+	const char** keys = malloc(2 * rule->nb_fields * sizeof(char*));
+	if (!members || !keys) fail("unable to allocate memory\n");
+	int nb_members = 0;
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		keys[nb_members] = field->key;
+		members[nb_members++] = dup_string(field->name);
+		if (field->kind == KIND_SEQ) {
+			keys[nb_members] = field->key;
+			members[nb_members++] = suffixed(field->name, "_len");
+		}
+	}
+	for (int member_idx = 0; member_idx < nb_members; ++member_idx) {
+		for (int other_idx = 0; other_idx < member_idx; ++other_idx) {
+			if (same_identifier(members[other_idx], members[member_idx])) {
+				fail("the keys `%s' and `%s' of `%s' both generate the member `%s'\n", keys[other_idx], keys[member_idx], where, members[member_idx]);
+			}
+		}
+	}
+	for (int member_idx = 0; member_idx < nb_members; ++member_idx) {
+		free(members[member_idx]);
+	}
+	free(members);
+	free(keys);
+}
+
+static kind_t parse_kind(const char* type, const char* where)
+{
+	if (!strcmp(type, "str") || !strcmp(type, "text")) return KIND_STR;
+	if (!strcmp(type, "int")) return KIND_INT;
+	if (!strcmp(type, "float") || !strcmp(type, "number")) return KIND_FLOAT;
+	if (!strcmp(type, "bool")) return KIND_BOOL;
+	if (!strcmp(type, "map")) return KIND_MAP;
+	if (!strcmp(type, "seq")) return KIND_SEQ;
+	fail("unsupported type `%s' for `%s'\n", type, where);
+	return KIND_STR;
+}
+
+/** Reads a rule of the schema
+ *
+ * \param tree the rule
+ * \param key the key of the rule in its parent mapping, NULL for the root
+ * \param type_name the name of the type to generate if the rule is a map
+ * \param[out] rule the rule read
+ */
+static void parse_rule(PC_tree_t tree, const char* key, const char* type_name, rule_t* rule)
+{
+	memset(rule, 0, sizeof(rule_t));
+	const char* where = key ? key : "the root";
+	rule->key = key ? dup_string(key) : NULL;
+	rule->name = key ? identifier(key) : dup_string(type_name);
+	rule->desc = string_opt(tree, "desc");
+
+	// the default kwalify type is str
+	char* type = string_opt(tree, "type");
+	rule->kind = parse_kind(type ? type : "str", where);
+	free(type);
+
+	PC_tree_t required = PC_key_opt(tree, "required", 8);
+	if (required.node) PC_bool(required, &rule->required);
+
+	PC_tree_t default_value = PC_key_opt(tree, "default", 7);
+	if (default_value.node) {
+		rule->has_default = 1;
+		switch (rule->kind) {
+		case KIND_INT:
+			PC_int(default_value, &rule->int_default);
+			break;
+		case KIND_FLOAT:
+			PC_double(default_value, &rule->float_default);
+			break;
+		case KIND_BOOL: {
+			int bool_default;
+			PC_bool(default_value, &bool_default);
+			rule->int_default = bool_default;
+		} break;
+		case KIND_STR:
+			PC_string(default_value, &rule->str_default);
+			break;
+		default:
+			fail("default values are only supported for scalars, not for `%s'\n", where);
+		}
+	}
+
+	if (rule->kind == KIND_MAP) {
+		rule->type_name = dup_string(type_name);
+		// the C struct & typedef, the Fortran types and their converter
+		claim_global_name(suffixed(type_name, "_t"), where);
+		claim_global_name(suffixed(type_name, "_c"), where);
+		claim_global_name(suffixed(type_name, "_from_c"), where);
+		PC_tree_t mapping = PC_key(tree, "mapping", 7);
+		PC_len(mapping, &rule->nb_fields);
+		if (!rule->nb_fields) fail("the mapping of `%s' has no key\n", where);
+		rule->fields = malloc(rule->nb_fields * sizeof(rule_t));
+		if (!rule->fields) fail("unable to allocate memory\n");
+		for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+			char* field_key;
+			PC_string(PC_get(mapping, "{%d}", field_idx), &field_key);
+			char* field_name = identifier(field_key);
+			char* field_type_name = malloc(strlen(type_name) + strlen(field_name) + 2);
+			if (!field_type_name) fail("unable to allocate memory\n");
+			sprintf(field_type_name, "%s_%s", type_name, field_name);
+			parse_rule(PC_get(mapping, "<%d>", field_idx), field_key, field_type_name, &rule->fields[field_idx]);
+			free(field_type_name);
+			free(field_name);
+			free(field_key);
+		}
+		check_members(rule, where);
+	} else if (rule->kind == KIND_SEQ) {
+		PC_tree_t sequence = PC_key(tree, "sequence", 8);
+		int len;
+		PC_len(sequence, &len);
+		if (len != 1) fail("the sequence of `%s' must have exactly one rule\n", where);
+		char* item_type = string_opt(PC_at(sequence, 0), "type");
+		rule->item_kind = parse_kind(item_type ? item_type : "str", where);
+		free(item_type);
+		if (rule->item_kind != KIND_INT && rule->item_kind != KIND_FLOAT && rule->item_kind != KIND_BOOL) {
+			fail("only sequences of int, float or bool are supported, not for `%s'\n", where);
+		}
+	}
+}
+
+static void destroy_rule(rule_t* rule)
+{
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		destroy_rule(&rule->fields[field_idx]);
+	}
+	free(rule->fields);
+	free(rule->desc);
+	free(rule->str_default);
+	free(rule->type_name);
+	free(rule->name);
+	free(rule->key);
+}
+
+/** Whether a rule or one of its descendants has a default value
+ */
+static int has_defaults(const rule_t* rule, kind_t kind)
+{
+	if (rule->has_default && rule->kind == kind) return 1;
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (has_defaults(&rule->fields[field_idx], kind)) return 1;
+	}
+	return 0;
+}
+
+static int has_kind(const rule_t* rule, kind_t kind)
+{
+	if (rule->kind == kind) return 1;
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (has_kind(&rule->fields[field_idx], kind)) return 1;
+	}
+	return 0;
+}
+
+/** Writes a string as a C string literal
+ */
+static void emit_c_string(FILE* out, const char* value, size_t len)
+{
+	fputc('"', out);
+	for (size_t ii = 0; ii < len; ++ii) {
+		unsigned char c = value[ii];
+		if (c == '"' || c == '\\') {
+			fprintf(out, "\\%c", c);
+		} else if (c == '\n') {
+			fputs("\\n", out);
+		} else if (c < 0x20 || c >= 0x7F) {
+			fprintf(out, "\\%03o", c);
+		} else {
+			fputc(c, out);
+		}
+	}
+	fputc('"', out);
+}
+
+/** Writes a description as a single line comment
+ */
+static void emit_comment(FILE* out, const char* indent, const char* marker, const char* desc)
+{
+	fprintf(out, "%s%s ", indent, marker);
+	for (const char* c = desc; *c; ++c) {
+		if (*c == '\n') {
+			if (c[1]) fputc(' ', out);
+		} else {
+			fputc(*c, out);
+		}
+	}
+	fputc('\n', out);
+}
+
+static const char* c_item_type(kind_t kind)
+{
+	switch (kind) {
+	case KIND_INT:
+		return "long";
+	case KIND_FLOAT:
+		return "double";
+	default:
+		return "int";
+	}
+}
+
+static void emit_c_struct(FILE* out, const rule_t* rule)
+{
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (rule->fields[field_idx].kind == KIND_MAP) emit_c_struct(out, &rule->fields[field_idx]);
+	}
+
+	if (rule->desc) {
+		emit_comment(out, "", "/**", rule->desc);
+		fprintf(out, " */\n");
+	} else if (rule->key) {
+		fprintf(out, "/** The content of `%s'\n */\n", rule->key);
+	} else {
+		fprintf(out, "/** The whole configuration\n */\n");
+	}
+	fprintf(out, "typedef struct %s_s {\n", rule->type_name);
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		if (field_idx) fprintf(out, "\n");
+		if (field->desc) emit_comment(out, "\t", "///", field->desc);
+		switch (field->kind) {
+		case KIND_INT:
+			fprintf(out, "\tlong %s;\n", field->name);
+			break;
+		case KIND_FLOAT:
+			fprintf(out, "\tdouble %s;\n", field->name);
+			break;
+		case KIND_BOOL:
+			fprintf(out, "\tint %s;\n", field->name);
+			break;
+		case KIND_STR:
+			fprintf(out, "\tchar* %s;\n", field->name);
+			break;
+		case KIND_MAP:
+			fprintf(out, "\t%s_t %s;\n", field->type_name, field->name);
+			break;
+		case KIND_SEQ:
+			fprintf(out, "\t%s* %s;\n\n\t/// the number of items in %s\n\tint %s_len;\n", c_item_type(field->item_kind), field->name, field->name, field->name);
+			break;
+		}
+	}
+	fprintf(out, "\n} %s_t;\n\n", rule->type_name);
+}
+
+static void emit_header(FILE* out, const rule_t* root, const char* prefix)
+{
+	fprintf(out, "/* Generated by paraconf_codegen from %s, do not edit */\n\n", schema_path);
+	char* guard = dup_string(prefix);
+	for (char* c = guard; *c; ++c) {
+		if (*c >= 'a' && *c <= 'z') *c += 'A' - 'a';
+	}
+	fprintf(out, "#ifndef %s_H__\n#define %s_H__\n\n", guard, guard);
+	fprintf(out, "#include <paraconf.h>\n\n");
+	fprintf(out, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n");
+	emit_c_struct(out, root);
+	fprintf(out, "/** Reads a %s_t from a tree\n", prefix);
+	fprintf(out, " *\n");
+	fprintf(out, " * Missing optional values take their default value, or 0/NULL if they have none.\n");
+	fprintf(out, " * In case of error, the value is left as after %s_free.\n", prefix);
+	fprintf(out, " *\n");
+	fprintf(out, " * \\param[in] tree the tree to read\n");
+	fprintf(out, " * \\param[out] value the value read, to release with %s_free\n", prefix);
+	fprintf(out, " * \\return the status of the execution\n");
+	fprintf(out, " */\n");
+	fprintf(out, "PC_status_t %s_read(PC_tree_t tree, %s_t* value);\n\n", prefix, prefix);
+	fprintf(out, "/** Releases the memory held by a %s_t\n", prefix);
+	fprintf(out, " *\n");
+	fprintf(out, " * \\param value the value to release, all its fields are reset to 0/NULL\n");
+	fprintf(out, " */\n");
+	fprintf(out, "void %s_free(%s_t* value);\n\n", prefix, prefix);
+	fprintf(out, "#ifdef __cplusplus\n}\n#endif\n\n");
+	fprintf(out, "#endif // %s_H__\n", guard);
+	free(guard);
+}
+
+static void emit_indent(FILE* out, int depth)
+{
+	for (int ii = 0; ii < depth; ++ii)
+		fputc('\t', out);
+}
+
+/** Builds the expression of a field from the one of its parent struct,
+ * the root struct is accessed through the `value' pointer
+ */
+static void field_lvalue(char* buffer, size_t size, const char* lvalue, const char* name)
+{
+	snprintf(buffer, size, "%s%s%s", lvalue, strcmp(lvalue, "value") ? "." : "->", name);
+}
+
+/** Writes the code setting the default values of a rule and its descendants
+ */
+static void emit_c_defaults(FILE* out, const rule_t* rule, const char* lvalue, int indent)
+{
+	char lvalue_buffer[1024];
+	switch (rule->kind) {
+	case KIND_BOOL:
+		if (!rule->has_default) return;
+		emit_indent(out, indent);
+		fprintf(out, "%s = %ld;\n", lvalue, rule->int_default);
+		return;
+	case KIND_INT:
+		if (!rule->has_default) return;
+		emit_indent(out, indent);
+		if (rule->int_default == LONG_MIN) {
+			// the most negative value has no literal
+			fprintf(out, "%s = -%ldL - 1;\n", lvalue, LONG_MAX);
+		} else {
+			fprintf(out, "%s = %ldL;\n", lvalue, rule->int_default);
+		}
+		return;
+	case KIND_FLOAT:
+		if (!rule->has_default) return;
+		emit_indent(out, indent);
+		if (isnan(rule->float_default)) {
+			fprintf(out, "%s = NAN;\n", lvalue);
+		} else if (isinf(rule->float_default)) {
+			fprintf(out, "%s = %sHUGE_VAL;\n", lvalue, rule->float_default < 0 ? "-" : "");
+		} else {
+			fprintf(out, "%s = %.17g;\n", lvalue, rule->float_default);
+		}
+		return;
+	case KIND_STR:
+		if (!rule->has_default) return;
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = set_string(&%s, ", lvalue);
+		emit_c_string(out, rule->str_default, strlen(rule->str_default));
+		fprintf(out, "))) goto err0;\n");
+		return;
+	case KIND_MAP:
+		for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+			field_lvalue(lvalue_buffer, sizeof(lvalue_buffer), lvalue, rule->fields[field_idx].name);
+			emit_c_defaults(out, &rule->fields[field_idx], lvalue_buffer, indent);
+		}
+		return;
+	case KIND_SEQ:
+		return;
+	}
+}
+
+static int has_c_defaults(const rule_t* rule)
+{
+	return has_defaults(rule, KIND_INT) || has_defaults(rule, KIND_BOOL) || has_defaults(rule, KIND_FLOAT) || has_defaults(rule, KIND_STR);
+}
+
+/** Writes the code reading a rule from node<depth> into lvalue
+ */
+static void emit_c_read(FILE* out, const rule_t* rule, const char* lvalue, int depth, int indent)
+{
+	static const char* array_functions[] = {"PC_int_array", "PC_double_array", "PC_bool_array"};
+	char lvalue_buffer[1024];
+	switch (rule->kind) {
+	case KIND_INT:
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = PC_int(node%d, &%s))) goto err0;\n", depth, lvalue);
+		return;
+	case KIND_FLOAT:
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = PC_double(node%d, &%s))) goto err0;\n", depth, lvalue);
+		return;
+	case KIND_BOOL:
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = PC_bool(node%d, &%s))) goto err0;\n", depth, lvalue);
+		return;
+	case KIND_STR:
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = PC_string(node%d, &%s))) goto err0;\n", depth, lvalue);
+		return;
+	case KIND_SEQ:
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = PC_len(node%d, &%s_len))) goto err0;\n", depth, lvalue);
+		emit_indent(out, indent);
+		fprintf(out, "if (!(%s = calloc(%s_len + 1, sizeof(%s)))) {\n", lvalue, lvalue, c_item_type(rule->item_kind));
+		emit_indent(out, indent + 1);
+		fprintf(out, "status = alloc_error();\n");
+		emit_indent(out, indent + 1);
+		fprintf(out, "goto err0;\n");
+		emit_indent(out, indent);
+		fprintf(out, "}\n");
+		emit_indent(out, indent);
+		fprintf(out, "if ((status = %s(node%d, %s, %s_len))) goto err0;\n", array_functions[rule->item_kind], depth, lvalue, lvalue);
+		return;
+	case KIND_MAP:
+		for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+			const rule_t* field = &rule->fields[field_idx];
+			field_lvalue(lvalue_buffer, sizeof(lvalue_buffer), lvalue, field->name);
+			emit_indent(out, indent);
+			fprintf(out, "{\n");
+			emit_indent(out, indent + 1);
+			fprintf(out, "PC_tree_t node%d = %s(node%d, ", depth + 1, field->required ? "PC_key" : "PC_key_opt", depth);
+			emit_c_string(out, field->key, strlen(field->key));
+			fprintf(out, ", %lu);\n", (unsigned long)strlen(field->key));
+			emit_indent(out, indent + 1);
+			fprintf(out, "if ((status = PC_status(node%d))) goto err0;\n", depth + 1);
+			if (field->required) {
+				emit_c_read(out, field, lvalue_buffer, depth + 1, indent + 1);
+			} else {
+				emit_indent(out, indent + 1);
+				fprintf(out, "if (node%d.node) {\n", depth + 1);
+				emit_c_read(out, field, lvalue_buffer, depth + 1, indent + 2);
+				emit_indent(out, indent + 1);
+				if (has_c_defaults(field)) {
+					fprintf(out, "} else {\n");
+					emit_c_defaults(out, field, lvalue_buffer, indent + 2);
+					emit_indent(out, indent + 1);
+				}
+				fprintf(out, "}\n");
+			}
+			emit_indent(out, indent);
+			fprintf(out, "}\n");
+		}
+		return;
+	}
+}
+
+/** Writes the code releasing the memory held by lvalue
+ */
+static void emit_c_free(FILE* out, const rule_t* rule, const char* lvalue)
+{
+	char lvalue_buffer[1024];
+	if (rule->kind == KIND_STR || rule->kind == KIND_SEQ) fprintf(out, "\tfree(%s);\n", lvalue);
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		field_lvalue(lvalue_buffer, sizeof(lvalue_buffer), lvalue, rule->fields[field_idx].name);
+		emit_c_free(out, &rule->fields[field_idx], lvalue_buffer);
+	}
+}
+
+static void emit_source(FILE* out, const rule_t* root, const char* prefix)
+{
+	fprintf(out, "/* Generated by paraconf_codegen from %s, do not edit */\n\n", schema_path);
+	fprintf(out, "#include <math.h>\n#include <stdlib.h>\n#include <string.h>\n\n");
+	fprintf(out, "#include \"%s.h\"\n\n", prefix);
+
+	if (has_kind(root, KIND_SEQ) || has_defaults(root, KIND_STR)) {
+		fprintf(out, "/** Reports an allocation failure through the current error handler\n */\n");
+		fprintf(out, "static PC_status_t alloc_error(void)\n{\n");
+		fprintf(out, "\tPC_errhandler_t handler = PC_errhandler(PC_NULL_HANDLER);\n");
+		fprintf(out, "\tPC_errhandler(handler);\n");
+		fprintf(out, "\tif (handler.func) handler.func(PC_SYSTEM_ERROR, \"unable to allocate memory\\n\", handler.context);\n");
+		fprintf(out, "\treturn PC_SYSTEM_ERROR;\n}\n\n");
+	}
+	if (has_defaults(root, KIND_STR)) {
+		fprintf(out, "/** Sets a string field to a copy of its default value\n */\n");
+		fprintf(out, "static PC_status_t set_string(char** value, const char* default_value)\n{\n");
+		fprintf(out, "\tif (!(*value = malloc(strlen(default_value) + 1))) return alloc_error();\n");
+		fprintf(out, "\tstrcpy(*value, default_value);\n");
+		fprintf(out, "\treturn PC_OK;\n}\n\n");
+	}
+
+	fprintf(out, "PC_status_t %s_read(PC_tree_t tree, %s_t* value)\n{\n", prefix, prefix);
+	fprintf(out, "\tPC_status_t status = PC_OK;\n");
+	fprintf(out, "\tmemset(value, 0, sizeof(%s_t));\n\n", prefix);
+	fprintf(out, "\tPC_tree_t node0 = tree;\n");
+	fprintf(out, "\tif ((status = PC_status(node0))) goto err0;\n");
+	emit_c_read(out, root, "value", 0, 1);
+	fprintf(out, "\n\treturn status;\n\nerr0:\n\t%s_free(value);\n\treturn status;\n}\n\n", prefix);
+
+	fprintf(out, "void %s_free(%s_t* value)\n{\n", prefix, prefix);
+	emit_c_free(out, root, "value");
+	fprintf(out, "\tmemset(value, 0, sizeof(%s_t));\n}\n", prefix);
+}
+
+static const char* f_item_type(kind_t kind, int c_type)
+{
+	switch (kind) {
+	case KIND_INT:
+		return c_type ? "integer(C_long)" : "integer";
+	case KIND_FLOAT:
+		return c_type ? "real(C_double)" : "real(8)";
+	default:
+		return c_type ? "integer(C_int)" : "logical";
+	}
+}
+
+static void emit_f_types(FILE* out, const rule_t* rule)
+{
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (rule->fields[field_idx].kind == KIND_MAP) emit_f_types(out, &rule->fields[field_idx]);
+	}
+
+	// the interoperable mirror of the C struct
+	fprintf(out, "  type, bind(C) :: %s_c\n", rule->type_name);
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		switch (field->kind) {
+		case KIND_INT:
+		case KIND_FLOAT:
+		case KIND_BOOL:
+			fprintf(out, "    %s :: %s\n", f_item_type(field->kind, 1), field->name);
+			break;
+		case KIND_STR:
+			fprintf(out, "    type(C_ptr) :: %s\n", field->name);
+			break;
+		case KIND_MAP:
+			fprintf(out, "    type(%s_c) :: %s\n", field->type_name, field->name);
+			break;
+		case KIND_SEQ:
+			fprintf(out, "    type(C_ptr) :: %s\n    integer(C_int) :: %s_len\n", field->name, field->name);
+			break;
+		}
+	}
+	fprintf(out, "  end type %s_c\n\n", rule->type_name);
+
+	if (rule->desc) emit_comment(out, "  ", "!", rule->desc);
+	fprintf(out, "  type :: %s_t\n", rule->type_name);
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		if (field->desc) emit_comment(out, "    ", "!", field->desc);
+		switch (field->kind) {
+		case KIND_INT:
+		case KIND_FLOAT:
+		case KIND_BOOL:
+			fprintf(out, "    %s :: %s\n", f_item_type(field->kind, 0), field->name);
+			break;
+		case KIND_STR:
+			fprintf(out, "    character(len=:), allocatable :: %s\n", field->name);
+			break;
+		case KIND_MAP:
+			fprintf(out, "    type(%s_t) :: %s\n", field->type_name, field->name);
+			break;
+		case KIND_SEQ:
+			fprintf(out, "    %s, allocatable :: %s(:)\n", f_item_type(field->item_kind, 0), field->name);
+			break;
+		}
+	}
+	fprintf(out, "  end type %s_t\n\n", rule->type_name);
+}
+
+static void emit_f_public(FILE* out, const rule_t* rule)
+{
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (rule->fields[field_idx].kind == KIND_MAP) emit_f_public(out, &rule->fields[field_idx]);
+	}
+	fprintf(out, "  public :: %s_t\n", rule->type_name);
+}
+
+static void emit_f_converters(FILE* out, const rule_t* rule)
+{
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		if (rule->fields[field_idx].kind == KIND_MAP) emit_f_converters(out, &rule->fields[field_idx]);
+	}
+
+	fprintf(out, "  subroutine %s_from_c(c_value, value)\n", rule->type_name);
+	fprintf(out, "    type(%s_c), intent(in) :: c_value\n", rule->type_name);
+	fprintf(out, "    type(%s_t), intent(out) :: value\n", rule->type_name);
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		if (field->kind != KIND_SEQ) continue;
+		fprintf(out, "    %s, pointer :: %s_items(:)\n", f_item_type(field->item_kind, 1), field->name);
+	}
+	for (int field_idx = 0; field_idx < rule->nb_fields; ++field_idx) {
+		const rule_t* field = &rule->fields[field_idx];
+		const char* name = field->name;
+		switch (field->kind) {
+		case KIND_INT:
+			fprintf(out, "    value%%%s = int(c_value%%%s)\n", name, name);
+			break;
+		case KIND_FLOAT:
+			fprintf(out, "    value%%%s = real(c_value%%%s, 8)\n", name, name);
+			break;
+		case KIND_BOOL:
+			fprintf(out, "    value%%%s = c_value%%%s /= 0\n", name, name);
+			break;
+		case KIND_STR:
+			fprintf(out, "    if (c_associated(c_value%%%s)) value%%%s = c_string(c_value%%%s)\n", name, name, name);
+			break;
+		case KIND_MAP:
+			fprintf(out, "    call %s_from_c(c_value%%%s, value%%%s)\n", field->type_name, name, name);
+			break;
+		case KIND_SEQ:
+			fprintf(out, "    if (c_associated(c_value%%%s)) then\n", name);
+			fprintf(out, "      call C_F_pointer(c_value%%%s, %s_items, [c_value%%%s_len])\n", name, name, name);
+			switch (field->item_kind) {
+			case KIND_INT:
+				fprintf(out, "      value%%%s = int(%s_items)\n", name, name);
+				break;
+			case KIND_FLOAT:
+				fprintf(out, "      value%%%s = real(%s_items, 8)\n", name, name);
+				break;
+			default:
+				fprintf(out, "      value%%%s = %s_items /= 0\n", name, name);
+				break;
+			}
+			fprintf(out, "    end if\n");
+			break;
+		}
+	}
+	fprintf(out, "  end subroutine %s_from_c\n\n", rule->type_name);
+}
+
+static void emit_fortran(FILE* out, const rule_t* root, const char* prefix)
+{
+	fprintf(out, "! Generated by paraconf_codegen from %s, do not edit\n\n", schema_path);
+	fprintf(out, "module %s\n\n", prefix);
+	fprintf(out, "  use ISO_C_binding\n  use paraconf\n\n  implicit none\n\n  private\n\n");
+	emit_f_public(out, root);
+	fprintf(out, "  public :: %s_read\n\n", prefix);
+	emit_f_types(out, root);
+
+	fprintf(out, "  interface\n\n");
+	fprintf(out, "    function %s_read_c(tree, value) bind(C, name=\"%s_read\")\n", prefix, prefix);
+	fprintf(out, "      import :: PC_tree_t, %s_c, C_int\n", prefix);
+	fprintf(out, "      type(PC_tree_t), value :: tree\n");
+	fprintf(out, "      type(%s_c) :: value\n", prefix);
+	fprintf(out, "      integer(C_int) :: %s_read_c\n", prefix);
+	fprintf(out, "    end function %s_read_c\n\n", prefix);
+	fprintf(out, "    subroutine %s_free_c(value) bind(C, name=\"%s_free\")\n", prefix, prefix);
+	fprintf(out, "      import :: %s_c\n", prefix);
+	fprintf(out, "      type(%s_c) :: value\n", prefix);
+	fprintf(out, "    end subroutine %s_free_c\n\n", prefix);
+	fprintf(out, "    function c_strlen(str) bind(C, name=\"strlen\")\n");
+	fprintf(out, "      import :: C_ptr, C_size_t\n");
+	fprintf(out, "      type(C_ptr), value :: str\n");
+	fprintf(out, "      integer(C_size_t) :: c_strlen\n");
+	fprintf(out, "    end function c_strlen\n\n");
+	fprintf(out, "  end interface\n\n");
+
+	fprintf(out, "contains\n\n");
+	fprintf(out, "  !> Reads a %s_t from a tree\n", prefix);
+	fprintf(out, "  !! \\param[in] tree the tree to read\n");
+	fprintf(out, "  !! \\param[out] value the value read\n");
+	fprintf(out, "  !! \\param[out] status the status of the execution\n");
+	fprintf(out, "  subroutine %s_read(tree, value, status)\n", prefix);
+	fprintf(out, "    type(PC_tree_t), intent(in) :: tree\n");
+	fprintf(out, "    type(%s_t), intent(out) :: value\n", prefix);
+	fprintf(out, "    integer, intent(out), optional :: status\n");
+	fprintf(out, "    type(%s_c) :: c_value\n", prefix);
+	fprintf(out, "    integer :: c_status\n");
+	fprintf(out, "    c_status = int(%s_read_c(tree, c_value))\n", prefix);
+	fprintf(out, "    if (c_status == 0) call %s_from_c(c_value, value)\n", prefix);
+	fprintf(out, "    call %s_free_c(c_value)\n", prefix);
+	fprintf(out, "    if (present(status)) status = c_status\n");
+	fprintf(out, "  end subroutine %s_read\n\n", prefix);
+
+	emit_f_converters(out, root);
+
+	fprintf(out, "  function c_string(ptr) result(str)\n");
+	fprintf(out, "    type(C_ptr), intent(in) :: ptr\n");
+	fprintf(out, "    character(len=:), allocatable :: str\n");
+	fprintf(out, "    character(kind=C_char), pointer :: chars(:)\n");
+	fprintf(out, "    integer :: length, ii\n");
+	fprintf(out, "    length = int(c_strlen(ptr))\n");
+	fprintf(out, "    call C_F_pointer(ptr, chars, [length])\n");
+	fprintf(out, "    allocate(character(len=length) :: str)\n");
+	fprintf(out, "    do ii = 1, length\n");
+	fprintf(out, "      str(ii:ii) = chars(ii)\n");
+	fprintf(out, "    end do\n");
+	fprintf(out, "  end function c_string\n\n");
+
+	fprintf(out, "end module %s\n", prefix);
+}
+
+/** Writes a generated file
+ */
+static void write_file(const char* output_dir, const char* prefix, const char* extension, const rule_t* root, void (*emit)(FILE*, const rule_t*, const char*))
+{
+	char* path = malloc(strlen(output_dir) + strlen(prefix) + strlen(extension) + 2);
+	if (!path) fail("unable to allocate memory\n");
+	sprintf(path, "%s/%s%s", output_dir, prefix, extension);
+	FILE* out = fopen(path, "w");
+	if (!out) fail("unable to open `%s' for writing\n", path);
+	emit(out, root, prefix);
+	if (fclose(out)) fail("unable to write `%s'\n", path);
+	free(path);
+}
+
+static void usage(const char* program)
+{
+	fprintf(stderr, "usage: %s [-f] -p <prefix> -o <output_dir> <schema.yml>\n", program);
+	exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+	int fortran = 0;
+	const char* prefix = NULL;
+	const char* output_dir = NULL;
+	for (int arg = 1; arg < argc; ++arg) {
+		if (!strcmp(argv[arg], "-f")) {
+			fortran = 1;
+		} else if (!strcmp(argv[arg], "-p") && arg + 1 < argc) {
+			prefix = argv[++arg];
+		} else if (!strcmp(argv[arg], "-o") && arg + 1 < argc) {
+			output_dir = argv[++arg];
+		} else if (argv[arg][0] != '-' && !schema_path) {
+			schema_path = argv[arg];
+		} else {
+			usage(argv[0]);
+		}
+	}
+	if (!prefix || !output_dir || !schema_path) usage(argv[0]);
+
+	char* prefix_id = identifier(prefix);
+	if (strcmp(prefix, prefix_id)) fail("the prefix `%s' is not a valid identifier\n", prefix);
+	free(prefix_id);
+
+	PC_errhandler_t errhandler = {pc_fail, NULL};
+	PC_errhandler(errhandler);
+
+	// the functions of the generated code, the types are reserved while parsing the schema
+	claim_global_name(suffixed(prefix, "_read"), "the reader");
+	claim_global_name(suffixed(prefix, "_read_c"), "the reader");
+	claim_global_name(suffixed(prefix, "_free"), "the reader");
+	claim_global_name(suffixed(prefix, "_free_c"), "the reader");
+	claim_global_name(dup_string("c_strlen"), "the reader");
+	claim_global_name(dup_string("c_string"), "the reader");
+
+	PC_tree_t schema = PC_parse_path(schema_path);
+	rule_t root;
+	parse_rule(schema, NULL, prefix, &root);
+	if (root.kind != KIND_MAP) fail("the root rule must be a map\n");
+
+	write_file(output_dir, prefix, ".h", &root, emit_header);
+	write_file(output_dir, prefix, ".c", &root, emit_source);
+	if (fortran) write_file(output_dir, prefix, ".f90", &root, emit_fortran);
+
+	destroy_rule(&root);
+	release_global_names();
+	PC_tree_destroy(&schema);
+	return 0;
+}